@@ -116,6 +116,20 @@ static const wxChar MaxFileSystemWatchers[] = wxT( "MaxFileSystemWatchers" );
 static const wxChar MinorSchematicGraphSize[] = wxT( "MinorSchematicGraphSize" );
 static const wxChar ResolveTextRecursionDepth[] = wxT( "ResolveTextRecursionDepth" );
 static const wxChar ZoneConnectionFiller[] = wxT( "ZoneConnectionFiller" );
+static const wxChar DRCConcurrentProviders[] = wxT( "DRCConcurrentProviders" );
+static const wxChar DRCConstraintCache[] = wxT( "DRCConstraintCache" );
+static const wxChar ZoneFillIncremental[] = wxT( "ZoneFillIncremental" );
+static const wxChar ZoneFillTrackChunk[] = wxT( "ZoneFillTrackChunk" );
+static const wxChar ZoneFillKnockoutCache[] = wxT( "ZoneFillKnockoutCache" );
+static const wxChar IncrementalRatsnest[] = wxT( "IncrementalRatsnest" );
+static const wxChar IncrementalNetPropagation[] = wxT( "IncrementalNetPropagation" );
+static const wxChar RouterBranchPool[] = wxT( "RouterBranchPool" );
+static const wxChar RouterClearanceMatrix[] = wxT( "RouterClearanceMatrix" );
+static const wxChar FootprintCacheConcurrentLoad[] = wxT( "FootprintCacheConcurrentLoad" );
+static const wxChar MappedFileLoad[] = wxT( "MappedFileLoad" );
+static const wxChar ConcurrentBoardLoad[] = wxT( "ConcurrentBoardLoad" );
+static const wxChar ConcurrentSchematicLoad[] = wxT( "ConcurrentSchematicLoad" );
+static const wxChar IncrementalDRC[] = wxT( "IncrementalDRC" );
 
 } // namespace KEYS
 
@@ -280,6 +294,21 @@ ADVANCED_CFG::ADVANCED_CFG()
 
     m_ZoneConnectionFiller = false;
 
+    m_DRCConcurrentProviders = false;
+    m_DRCConstraintCache = true;
+    m_ZoneFillIncremental = true;
+    m_ZoneFillTrackChunk = 512;
+    m_ZoneFillKnockoutCache = true;
+    m_IncrementalRatsnest = true;
+    m_IncrementalNetPropagation = true;
+    m_RouterBranchPool = true;
+    m_RouterClearanceMatrix = true;
+    m_FootprintCacheConcurrentLoad = true;
+    m_MappedFileLoad = true;
+    m_ConcurrentBoardLoad = true;
+    m_ConcurrentSchematicLoad = true;
+    m_IncrementalDRC = false;
+
     loadFromConfigFile();
 }
 
@@ -520,6 +549,55 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ZoneConnectionFiller,
                                                 &m_ZoneConnectionFiller, m_ZoneConnectionFiller ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::DRCConcurrentProviders,
+                                                &m_DRCConcurrentProviders,
+                                                m_DRCConcurrentProviders ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::DRCConstraintCache,
+                                                &m_DRCConstraintCache, m_DRCConstraintCache ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ZoneFillIncremental,
+                                                &m_ZoneFillIncremental, m_ZoneFillIncremental ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::ZoneFillTrackChunk,
+                                               &m_ZoneFillTrackChunk, m_ZoneFillTrackChunk,
+                                               0, 100000 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ZoneFillKnockoutCache,
+                                                &m_ZoneFillKnockoutCache,
+                                                m_ZoneFillKnockoutCache ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalRatsnest,
+                                                &m_IncrementalRatsnest, m_IncrementalRatsnest ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalNetPropagation,
+                                                &m_IncrementalNetPropagation,
+                                                m_IncrementalNetPropagation ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RouterBranchPool,
+                                                &m_RouterBranchPool, m_RouterBranchPool ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RouterClearanceMatrix,
+                                                &m_RouterClearanceMatrix,
+                                                m_RouterClearanceMatrix ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::FootprintCacheConcurrentLoad,
+                                                &m_FootprintCacheConcurrentLoad,
+                                                m_FootprintCacheConcurrentLoad ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::MappedFileLoad,
+                                                &m_MappedFileLoad, m_MappedFileLoad ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ConcurrentBoardLoad,
+                                                &m_ConcurrentBoardLoad, m_ConcurrentBoardLoad ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ConcurrentSchematicLoad,
+                                                &m_ConcurrentSchematicLoad,
+                                                m_ConcurrentSchematicLoad ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalDRC,
+                                                &m_IncrementalDRC, m_IncrementalDRC ) );
+
     // Special case for trace mask setting...we just grab them and set them immediately
     // Because we even use wxLogTrace inside of advanced config
     wxString traceMasks;
@@ -185,6 +185,24 @@ bool DSNLEXER::SyncLineReaderWith( DSNLEXER& aLexer )
 }
 
 
+bool DSNLEXER::SeekSpan( const char* aPos )
+{
+    SPAN_LINE_READER* spanReader = dynamic_cast<SPAN_LINE_READER*>( reader );
+
+    if( !spanReader )
+        return false;
+
+    unsigned len;
+    unsigned offset;
+
+    start = spanReader->SeekLine( aPos, len, offset );
+    limit = start + len;
+    next  = start + offset;
+
+    return true;
+}
+
+
 void DSNLEXER::PushReader( LINE_READER* aLineReader )
 {
     readerStack.push_back( aLineReader );
@@ -543,6 +543,18 @@ EDA_TEXT::GetRenderCache( const KIFONT::FONT* aFont, const wxString& forResolved
 }
 
 
+void EDA_TEXT::BuildShapeCaches() const
+{
+    KIFONT::FONT* font = getDrawFont();
+
+    GetTextBox();
+
+    // Same arguments as GetEffectiveTextShape() uses
+    if( font->IsOutline() )
+        GetRenderCache( font, GetShownText( true ), VECTOR2I() );
+}
+
+
 void EDA_TEXT::SetupRenderCache( const wxString& aResolvedText, const KIFONT::FONT* aFont,
                                  const EDA_ANGLE& aAngle, const VECTOR2I& aOffset )
 {
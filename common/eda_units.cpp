@@ -25,7 +25,10 @@
 #include <fmt/core.h>
 #include <math/util.h>      // for KiROUND
 #include <macros.h>
+#include <algorithm>
 #include <charconv>
+#include <cmath>
+#include <limits>
 #include <wx/translation.h>
 
 
@@ -166,7 +169,48 @@ std::string EDA_UNIT_UTILS::FormatAngle( const EDA_ANGLE& aAngle )
 }
 
 
-std::string EDA_UNIT_UTILS::FormatInternalUnits( const EDA_IU_SCALE& aIuScale, int aValue )
+/**
+ * @return the power of ten \a aIuScale has per millimetre, or -1 if it is not a power of ten.
+ */
+static int decimalScale( const EDA_IU_SCALE& aIuScale )
+{
+    double iuPerMM = 1;
+
+    for( int exponent = 0; exponent < 10; ++exponent, iuPerMM *= 10 )
+    {
+        if( aIuScale.IU_PER_MM == iuPerMM )
+            return exponent;
+    }
+
+    return -1;
+}
+
+
+static const uint64_t c_powersOf10[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+
+static std::string formatInternalUnitsAsDouble( const EDA_IU_SCALE& aIuScale, int aValue )
 {
     std::string buf;
     double engUnits = aValue;
@@ -199,26 +243,213 @@ std::string EDA_UNIT_UTILS::FormatInternalUnits( const EDA_IU_SCALE& aIuScale, i
 }
 
 
+std::to_chars_result EDA_UNIT_UTILS::FormatInternalUnits( char* aBegin, char* aEnd,
+                                                          const EDA_IU_SCALE& aIuScale,
+                                                          int aValue )
+{
+    int exponent = decimalScale( aIuScale );
+
+    if( exponent < 0 )
+    {
+        std::string buf = formatInternalUnitsAsDouble( aIuScale, aValue );
+
+        if( buf.size() > size_t( aEnd - aBegin ) )
+            return { aEnd, std::errc::value_too_large };
+
+        return { std::copy( buf.begin(), buf.end(), aBegin ), std::errc() };
+    }
+
+    // An int has at most 10 significant digits, so the exact decimal value is what the
+    // "%.10g" conversion of the millimetres used to give
+    uint64_t magnitude = aValue < 0 ? uint64_t( -int64_t( aValue ) ) : uint64_t( aValue );
+    char*    pos = aBegin;
+
+    if( aValue < 0 )
+    {
+        if( pos == aEnd )
+            return { aEnd, std::errc::value_too_large };
+
+        *pos++ = '-';
+    }
+
+    std::to_chars_result result = std::to_chars( pos, aEnd, magnitude / c_powersOf10[exponent] );
+
+    if( result.ec != std::errc() )
+        return result;
+
+    uint64_t fraction = magnitude % c_powersOf10[exponent];
+
+    if( fraction == 0 )
+        return result;
+
+    char digits[10];
+    int  count = exponent;
+
+    for( int ii = exponent - 1; ii >= 0; --ii, fraction /= 10 )
+        digits[ii] = '0' + fraction % 10;
+
+    while( digits[count - 1] == '0' )
+        --count;
+
+    pos = result.ptr;
+
+    if( aEnd - pos < count + 1 )
+        return { aEnd, std::errc::value_too_large };
+
+    *pos++ = '.';
+
+    return { std::copy( digits, digits + count, pos ), std::errc() };
+}
+
+
+std::string EDA_UNIT_UTILS::FormatInternalUnits( const EDA_IU_SCALE& aIuScale, int aValue )
+{
+    char buf[32];
+
+    return std::string( buf, FormatInternalUnits( buf, buf + sizeof( buf ), aIuScale,
+                                                  aValue ).ptr );
+}
+
+
 std::string EDA_UNIT_UTILS::FormatInternalUnits( const EDA_IU_SCALE& aIuScale,
                                                  const VECTOR2I&     aPoint )
 {
-    return FormatInternalUnits( aIuScale, aPoint.x ) + " "
-           + FormatInternalUnits( aIuScale, aPoint.y );
+    char  buf[64];
+    char* end = buf + sizeof( buf );
+    char* pos = FormatInternalUnits( buf, end, aIuScale, aPoint.x ).ptr;
+
+    *pos++ = ' ';
+
+    return std::string( buf, FormatInternalUnits( pos, end, aIuScale, aPoint.y ).ptr );
 }
 
 
-#if 0   // No support for std::from_chars on MacOS yet
+std::from_chars_result EDA_UNIT_UTILS::ParseInternalUnits( const char* aBegin, const char* aEnd,
+                                                           const EDA_IU_SCALE& aIuScale,
+                                                           int& aOut )
+{
+    const char* pos = aBegin;
+    bool        negative = pos < aEnd && *pos == '-';
+
+    if( negative )
+        ++pos;
+
+    // The value is mantissa * 10^exponent millimetres
+    uint64_t mantissa = 0;
+    int      exponent = 0;
+    int      significant = 0;   // digits held by the mantissa, without leading zeros
+    bool     anyDigits = false;
+    bool     fraction = false;
+
+    for( ; pos < aEnd; ++pos )
+    {
+        if( *pos == '.' && !fraction )
+        {
+            fraction = true;
+            continue;
+        }
+
+        if( *pos < '0' || *pos > '9' )
+            break;
+
+        anyDigits = true;
+
+        if( significant < 19 )
+        {
+            mantissa = mantissa * 10 + ( *pos - '0' );
+
+            if( mantissa )
+                ++significant;
+
+            if( fraction )
+                --exponent;
+        }
+        else if( !fraction )
+        {
+            // Digits beyond what the mantissa holds only matter to rounding
+            ++exponent;
+        }
+    }
+
+    if( !anyDigits )
+        return { aBegin, std::errc::invalid_argument };
+
+    // An exponent is only part of the number if it has digits, as with strtod()
+    if( pos < aEnd && ( *pos == 'e' || *pos == 'E' ) )
+    {
+        const char* expPos = pos + 1;
+        bool        expNegative = false;
+
+        if( expPos < aEnd && ( *expPos == '-' || *expPos == '+' ) )
+            expNegative = *expPos++ == '-';
+
+        if( expPos < aEnd && *expPos >= '0' && *expPos <= '9' )
+        {
+            int value = 0;
+
+            for( ; expPos < aEnd && *expPos >= '0' && *expPos <= '9'; ++expPos )
+                value = std::min( value * 10 + ( *expPos - '0' ), 10000 );
+
+            exponent += expNegative ? -value : value;
+            pos = expPos;
+        }
+    }
+
+    int     scale = decimalScale( aIuScale );
+    int64_t limit = negative ? -int64_t( std::numeric_limits<int>::min() )
+                             : std::numeric_limits<int>::max();
+    int64_t magnitude;
+
+    if( scale < 0 )
+    {
+        double value = mantissa * std::pow( 10.0, exponent ) * aIuScale.IU_PER_MM;
+
+        magnitude = value >= limit ? limit : KiROUND<double, int64_t>( value );
+    }
+    else if( mantissa == 0 )
+    {
+        magnitude = 0;
+    }
+    else if( exponent + scale >= 0 )
+    {
+        int shift = exponent + scale;
+
+        if( shift > 10 || mantissa > uint64_t( limit ) / c_powersOf10[shift] )
+            magnitude = limit;
+        else
+            magnitude = int64_t( mantissa * c_powersOf10[shift] );
+    }
+    else if( -( exponent + scale ) > 19 )
+    {
+        magnitude = 0;
+    }
+    else
+    {
+        // Round half away from zero, like KiROUND()
+        uint64_t divisor = c_powersOf10[-( exponent + scale )];
+        uint64_t quotient = mantissa / divisor;
+        uint64_t remainder = mantissa % divisor;
+
+        if( remainder >= divisor - remainder )
+            ++quotient;
+
+        magnitude = int64_t( std::min<uint64_t>( quotient, limit ) );
+    }
+
+    aOut = int( negative ? -magnitude : magnitude );
+
+    return { pos, std::errc() };
+}
+
 
 bool EDA_UNIT_UTILS::ParseInternalUnits( const std::string& aInput, const EDA_IU_SCALE& aIuScale,
                                          int& aOut )
 {
-    double value;
-
-    if( std::from_chars( aInput.data(), aInput.data() + aInput.size(), value ).ec != std::errc() )
-        return false;
+    const char*            end = aInput.data() + aInput.size();
+    std::from_chars_result result = ParseInternalUnits( aInput.data(), end, aIuScale, aOut );
 
-    aOut = value * aIuScale.IU_PER_MM;
-    return true;
+    // The whole string must be the number
+    return result.ec == std::errc() && result.ptr == end;
 }
 
 
@@ -246,8 +477,6 @@ bool EDA_UNIT_UTILS::ParseInternalUnits( const std::string& aInput, const EDA_IU
     return true;
 }
 
-#endif
-
 
 #define IU_TO_MM( x, scale ) ( x / scale.IU_PER_MM )
 #define IU_TO_IN( x, scale ) ( x / scale.IU_PER_MILS / 1000 )
@@ -161,6 +161,24 @@ wxString UOP::Format() const
     }
         break;
 
+    case TR_UOP_JUMP_IF_FALSE:
+        str = wxString::Format( "JUMP_IF_FALSE [%d]", (int) m_jumpTarget );
+        break;
+
+    case TR_UOP_JUMP_IF_TRUE:
+        str = wxString::Format( "JUMP_IF_TRUE [%d]", (int) m_jumpTarget );
+        break;
+
+    case TR_UOP_COMPARE_VAR:
+        str = wxString::Format( "%s VAR [%p] %s [%ls]",
+                                m_compareOp == TR_OP_EQUAL ? "EQUAL" : "NEQUAL",
+                                m_ref.get(),
+                                m_value->GetType() == VT_NUMERIC ? "NUM" : "STR",
+                                m_value->GetType() == VT_NUMERIC
+                                        ? wxString::Format( "%.10f", m_value->AsDouble() )
+                                        : m_value->AsString() );
+        break;
+
     case TR_OP_METHOD_CALL:
         str = wxString::Format( "MCALL" );
         break;
@@ -180,10 +198,13 @@ wxString UOP::Format() const
 
 UCODE::~UCODE()
 {
-    for ( auto op : m_ucode )
-    {
-        delete op;
-    }
+}
+
+
+void UCODE::AddOp( UOP* uop )
+{
+    m_ucode.push_back( std::move( *uop ) );
+    delete uop;
 }
 
 
@@ -191,9 +212,9 @@ wxString UCODE::Dump() const
 {
     wxString rv;
 
-    for( auto op : m_ucode )
+    for( const UOP& op : m_ucode )
     {
-        rv += op->Format();
+        rv += op.Format();
         rv += "\n";
     }
 
@@ -975,6 +996,7 @@ bool COMPILER::generateUCode( UCODE* aCode, CONTEXT* aPreflightContext )
                         stack.push_back( pnode );
 
                     node->leaf[1]->SetUop( TR_OP_METHOD_CALL, func, std::move( vref ) );
+                    node->leaf[1]->uop->SetParamCount( (int) params.size() );
                     node->isTerminal = false;
                     break;
                 }
@@ -1106,14 +1128,129 @@ bool COMPILER::generateUCode( UCODE* aCode, CONTEXT* aPreflightContext )
         stack.pop_back();
     }
 
+    aCode->Optimize();
+
     libeval_dbg(2,"dump: \n%s\n", aCode->Dump().c_str() );
 
     return true;
 }
 
 
-void UOP::Exec( CONTEXT* ctx )
+static bool isTypeMismatch( const VALUE* arg1, const VALUE* arg2 )
+{
+    return arg1 && arg2
+            && ( ( arg1->GetType() == VT_STRING && arg2->GetType() == VT_NUMERIC )
+                 || ( arg1->GetType() == VT_NUMERIC && arg2->GetType() == VT_STRING ) );
+}
+
+
+#define AS_DOUBLE( arg ) ( arg ? arg->AsDouble() : 0.0 )
+
+static double binaryOp( int aOp, CONTEXT* ctx, const VALUE* arg1, const VALUE* arg2 )
+{
+    if( ctx && ctx->HasErrorCallback() && isTypeMismatch( arg1, arg2 ) )
+    {
+        if( arg1->GetType() == VT_STRING )
+        {
+            ctx->ReportError( wxString::Format( _( "Type mismatch between '%s' and %lf" ),
+                                                arg1->AsString(),
+                                                arg2->AsDouble() ) );
+        }
+        else
+        {
+            ctx->ReportError( wxString::Format( _( "Type mismatch between %lf and '%s'" ),
+                                                arg1->AsDouble(),
+                                                arg2->AsString() ) );
+        }
+    }
+
+    switch( aOp )
+    {
+    case TR_OP_ADD:
+        return AS_DOUBLE( arg1 ) + AS_DOUBLE( arg2 );
+    case TR_OP_SUB:
+        return AS_DOUBLE( arg1 ) - AS_DOUBLE( arg2 );
+    case TR_OP_MUL:
+        return AS_DOUBLE( arg1 ) * AS_DOUBLE( arg2 );
+    case TR_OP_DIV:
+        return AS_DOUBLE( arg1 ) / AS_DOUBLE( arg2 );
+    case TR_OP_LESS_EQUAL:
+        return AS_DOUBLE( arg1 ) <= AS_DOUBLE( arg2 ) ? 1 : 0;
+    case TR_OP_GREATER_EQUAL:
+        return AS_DOUBLE( arg1 ) >= AS_DOUBLE( arg2 ) ? 1 : 0;
+    case TR_OP_LESS:
+        return AS_DOUBLE( arg1 ) < AS_DOUBLE( arg2 ) ? 1 : 0;
+    case TR_OP_GREATER:
+        return AS_DOUBLE( arg1 ) > AS_DOUBLE( arg2 ) ? 1 : 0;
+    case TR_OP_EQUAL:
+        if( !arg1 || !arg2 )
+            return arg1 == arg2 ? 1 : 0;
+        else if( arg2->GetType() == VT_UNDEFINED )
+            return arg2->EqualTo( ctx, arg1 ) ? 1 : 0;
+        else
+            return arg1->EqualTo( ctx, arg2 ) ? 1 : 0;
+    case TR_OP_NOT_EQUAL:
+        if( !arg1 || !arg2 )
+            return arg1 != arg2 ? 1 : 0;
+        else if( arg2->GetType() == VT_UNDEFINED )
+            return arg2->NotEqualTo( ctx, arg1 ) ? 1 : 0;
+        else
+            return arg1->NotEqualTo( ctx, arg2 ) ? 1 : 0;
+    case TR_OP_BOOL_AND:
+        return AS_DOUBLE( arg1 ) != 0.0 && AS_DOUBLE( arg2 ) != 0.0 ? 1 : 0;
+    case TR_OP_BOOL_OR:
+        return AS_DOUBLE( arg1 ) != 0.0 || AS_DOUBLE( arg2 ) != 0.0 ? 1 : 0;
+    default:
+        return 0.0;
+    }
+}
+
+
+static double unaryOp( int aOp, const VALUE* arg1 )
 {
+    double ARG1VALUE = AS_DOUBLE( arg1 );
+
+    switch( aOp )
+    {
+    case TR_OP_BOOL_NOT:
+        return ARG1VALUE != 0.0 ? 0 : 1;
+    default:
+        return ARG1VALUE != 0.0 ? 1 : 0;
+    }
+}
+
+
+int UOP::stackEffect() const
+{
+    switch( m_op )
+    {
+    case TR_UOP_PUSH_VAR:
+    case TR_UOP_PUSH_VALUE:
+    case TR_UOP_COMPARE_VAR:
+        return 1;
+
+    case TR_OP_METHOD_CALL:
+        return 1 - m_paramCount;
+
+    default:
+        if( m_op & TR_OP_BINARY_MASK )
+            return -1;
+
+        return 0;
+    }
+}
+
+
+bool UOP::Exec( CONTEXT* ctx )
+{
+    auto result =
+            [&]( double aValue )
+            {
+                VALUE* rp = m_register >= 0 ? ctx->Register( m_register ) : ctx->AllocValue();
+                rp->Set( aValue );
+                ctx->Push( rp );
+            };
+
     switch( m_op )
     {
     case TR_UOP_PUSH_VAR:
@@ -1126,123 +1263,190 @@ void UOP::Exec( CONTEXT* ctx )
             value = ctx->AllocValue();
 
         ctx->Push( value );
+        return false;
     }
-        break;
 
     case TR_UOP_PUSH_VALUE:
         ctx->Push( m_value.get() );
-        return;
+        return false;
 
     case TR_OP_METHOD_CALL:
         m_func( ctx, m_ref.get() );
-        return;
+        return false;
+
+    case TR_UOP_COMPARE_VAR:
+    {
+        VALUE* value = nullptr;
+
+        if( m_ref )
+            value = ctx->StoreValue( m_ref->GetValue( ctx ) );
+        else
+            value = ctx->AllocValue();
+
+        result( binaryOp( m_compareOp, ctx, value, m_value.get() ) );
+        return false;
+    }
+
+    case TR_UOP_JUMP_IF_FALSE:
+    case TR_UOP_JUMP_IF_TRUE:
+    {
+        // Skipping the other operand would also skip any errors it reports
+        if( ctx->HasErrorCallback() )
+            return false;
+
+        VALUE* arg1 = ctx->Pop();
+        bool   isTrue = AS_DOUBLE( arg1 ) != 0.0;
+
+        if( isTrue == ( m_op == TR_UOP_JUMP_IF_TRUE ) )
+        {
+            result( isTrue ? 1 : 0 );
+            return true;
+        }
+
+        ctx->Push( arg1 );
+        return false;
+    }
 
     default:
         break;
     }
 
-#define AS_DOUBLE( arg ) ( arg ? arg->AsDouble() : 0.0 )
-
     if( m_op & TR_OP_BINARY_MASK )
     {
         LIBEVAL::VALUE* arg2 = ctx->Pop();
         LIBEVAL::VALUE* arg1 = ctx->Pop();
-        double          result;
 
-        if( ctx->HasErrorCallback() )
+        result( binaryOp( m_op, ctx, arg1, arg2 ) );
+    }
+    else if( m_op & TR_OP_UNARY_MASK )
+    {
+        LIBEVAL::VALUE* arg1 = ctx->Pop();
+
+        result( unaryOp( m_op, arg1 ) );
+    }
+
+    return false;
+}
+
+
+void UCODE::Optimize()
+{
+    std::vector<UOP> code;
+
+    code.reserve( m_ucode.size() );
+
+    auto isConstant =
+            []( const UOP& aOp )
+            {
+                return aOp.m_op == TR_UOP_PUSH_VALUE && aOp.m_value;
+            };
+
+    // Fold operators whose operands are all constants, and fuse comparisons of a variable
+    // against a constant (the bulk of most rule conditions).  Type mismatches are left for
+    // run time so that they still get reported.
+    for( UOP& op : m_ucode )
+    {
+        if( ( op.m_op & TR_OP_BINARY_MASK ) && code.size() >= 2 )
         {
-            if( arg1 && arg1->GetType() == VT_STRING && arg2 && arg2->GetType() == VT_NUMERIC )
+            UOP& lhs = code[ code.size() - 2 ];
+            UOP& rhs = code.back();
+
+            if( isConstant( lhs ) && isConstant( rhs )
+                    && !isTypeMismatch( lhs.m_value.get(), rhs.m_value.get() ) )
             {
-                ctx->ReportError( wxString::Format( _( "Type mismatch between '%s' and %lf" ),
-                                                    arg1->AsString(),
-                                                    arg2->AsDouble() ) );
+                double value = binaryOp( op.m_op, nullptr, lhs.m_value.get(), rhs.m_value.get() );
+
+                code.pop_back();
+                code.back() = UOP( TR_UOP_PUSH_VALUE, std::make_unique<VALUE>( value ) );
+                continue;
             }
-            else if( arg1 && arg1->GetType() == VT_NUMERIC && arg2 && arg2->GetType() == VT_STRING )
+
+            if( ( op.m_op == TR_OP_EQUAL || op.m_op == TR_OP_NOT_EQUAL )
+                    && lhs.m_op == TR_UOP_PUSH_VAR && isConstant( rhs ) )
             {
-                ctx->ReportError( wxString::Format( _( "Type mismatch between %lf and '%s'" ),
-                                                    arg1->AsDouble(),
-                                                    arg2->AsString() ) );
+                std::unique_ptr<VALUE> value = std::move( rhs.m_value );
+
+                code.pop_back();
+                code.back().m_op = TR_UOP_COMPARE_VAR;
+                code.back().m_value = std::move( value );
+                code.back().m_compareOp = op.m_op;
+                continue;
             }
         }
-
-        switch( m_op )
+        else if( ( op.m_op & TR_OP_UNARY_MASK ) && !code.empty() && isConstant( code.back() ) )
         {
-        case TR_OP_ADD:
-            result = AS_DOUBLE( arg1 ) + AS_DOUBLE( arg2 );
-            break;
-        case TR_OP_SUB:
-            result = AS_DOUBLE( arg1 ) - AS_DOUBLE( arg2 );
-            break;
-        case TR_OP_MUL:
-            result = AS_DOUBLE( arg1 ) * AS_DOUBLE( arg2 );
-            break;
-        case TR_OP_DIV:
-            result = AS_DOUBLE( arg1 ) / AS_DOUBLE( arg2 );
-            break;
-        case TR_OP_LESS_EQUAL:
-            result = AS_DOUBLE( arg1 ) <= AS_DOUBLE( arg2 ) ? 1 : 0;
-            break;
-        case TR_OP_GREATER_EQUAL:
-            result = AS_DOUBLE( arg1 ) >= AS_DOUBLE( arg2 ) ? 1 : 0;
-            break;
-        case TR_OP_LESS:
-            result = AS_DOUBLE( arg1 ) < AS_DOUBLE( arg2 ) ? 1 : 0;
-            break;
-        case TR_OP_GREATER:
-            result = AS_DOUBLE( arg1 ) > AS_DOUBLE( arg2 ) ? 1 : 0;
-            break;
-        case TR_OP_EQUAL:
-            if( !arg1 || !arg2 )
-                result = arg1 == arg2 ? 1 : 0;
-            else if( arg2->GetType() == VT_UNDEFINED )
-                result = arg2->EqualTo( ctx, arg1 ) ? 1 : 0;
-            else
-                result = arg1->EqualTo( ctx, arg2 ) ? 1 : 0;
-            break;
-        case TR_OP_NOT_EQUAL:
-            if( !arg1 || !arg2 )
-                result = arg1 != arg2 ? 1 : 0;
-            else if( arg2->GetType() == VT_UNDEFINED )
-                result = arg2->NotEqualTo( ctx, arg1 ) ? 1 : 0;
-            else
-                result = arg1->NotEqualTo( ctx, arg2 ) ? 1 : 0;
-            break;
-        case TR_OP_BOOL_AND:
-            result = AS_DOUBLE( arg1 ) != 0.0 && AS_DOUBLE( arg2 ) != 0.0 ? 1 : 0;
-            break;
-        case TR_OP_BOOL_OR:
-            result = AS_DOUBLE( arg1 ) != 0.0 || AS_DOUBLE( arg2 ) != 0.0 ? 1 : 0;
-            break;
-        default:
-            result = 0.0;
-            break;
+            double value = unaryOp( op.m_op, code.back().m_value.get() );
+
+            code.back() = UOP( TR_UOP_PUSH_VALUE, std::make_unique<VALUE>( value ) );
+            continue;
         }
 
-        auto rp = ctx->AllocValue();
-        rp->Set( result );
-        ctx->Push( rp );
-        return;
+        code.push_back( std::move( op ) );
     }
-    else if( m_op & TR_OP_UNARY_MASK )
+
+    // Find the first op of the right-hand operand of each logical operator.  A short-circuit
+    // jump goes there, taken when the left-hand operand alone decides the result.
+    std::vector<int> jumpOwner( code.size(), -1 );
+
+    for( size_t ii = 0; ii < code.size(); ++ii )
     {
-        LIBEVAL::VALUE* arg1 = ctx->Pop();
-        double          ARG1VALUE = arg1 ? arg1->AsDouble() : 0.0;
-        double          result;
+        if( code[ii].m_op != TR_OP_BOOL_AND && code[ii].m_op != TR_OP_BOOL_OR )
+            continue;
 
-        switch( m_op )
+        int depth = 0;
+
+        for( size_t jj = ii; jj > 0; --jj )
         {
-        case TR_OP_BOOL_NOT:
-            result = ARG1VALUE != 0.0 ? 0 : 1;
-            break;
-        default:
-            result = ARG1VALUE != 0.0 ? 1 : 0;
-            break;
+            depth += code[ jj - 1 ].stackEffect();
+
+            if( depth == 1 )
+            {
+                jumpOwner[ jj - 1 ] = (int) ii;
+                break;
+            }
         }
+    }
 
-        auto rp = ctx->AllocValue();
-        rp->Set( result );
-        ctx->Push( rp );
-        return;
+    std::vector<size_t> newIndex( code.size() );
+    size_t              count = 0;
+
+    for( size_t ii = 0; ii < code.size(); ++ii )
+    {
+        if( jumpOwner[ii] >= 0 )
+            count++;
+
+        newIndex[ii] = count++;
+    }
+
+    m_ucode.clear();
+    m_ucode.reserve( count );
+
+    for( size_t ii = 0; ii < code.size(); ++ii )
+    {
+        if( jumpOwner[ii] >= 0 )
+        {
+            int op = code[ jumpOwner[ii] ].m_op == TR_OP_BOOL_AND ? TR_UOP_JUMP_IF_FALSE
+                                                                  : TR_UOP_JUMP_IF_TRUE;
+
+            m_ucode.emplace_back( op, std::unique_ptr<VALUE>() );
+            m_ucode.back().m_jumpTarget = newIndex[ jumpOwner[ii] ] + 1;
+        }
+
+        m_ucode.push_back( std::move( code[ii] ) );
+    }
+
+    // Every op runs at most once per run, so each one producing a result gets its own register
+    m_registerCount = 0;
+
+    for( UOP& op : m_ucode )
+    {
+        if( ( op.m_op & ( TR_OP_BINARY_MASK | TR_OP_UNARY_MASK ) )
+                || op.m_op == TR_UOP_COMPARE_VAR
+                || op.m_op == TR_UOP_JUMP_IF_FALSE
+                || op.m_op == TR_UOP_JUMP_IF_TRUE )
+        {
+            op.m_register = m_registerCount++;
+        }
     }
 }
 
@@ -1251,10 +1455,18 @@ VALUE* UCODE::Run( CONTEXT* ctx )
 {
     static VALUE g_false( 0 );
 
+    ctx->ReserveRegisters( m_registerCount );
+
     try
     {
-        for( UOP* op : m_ucode )
-            op->Exec( ctx );
+        size_t pc = 0;
+
+        while( pc < m_ucode.size() )
+        {
+            UOP& op = m_ucode[pc];
+
+            pc = op.Exec( ctx ) ? op.m_jumpTarget : pc + 1;
+        }
     }
     catch(...)
     {
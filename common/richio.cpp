@@ -23,6 +23,7 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
@@ -275,6 +276,200 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
+SPAN_LINE_READER::SPAN_LINE_READER( const char* aBegin, const char* aEnd,
+                                    const wxString& aSource, unsigned aStartingLineNumber,
+                                    unsigned aMaxLineLength ) :
+    SPAN_LINE_READER( aStartingLineNumber, aMaxLineLength )
+{
+    m_source = aSource;
+    setSpan( aBegin, aEnd );
+}
+
+
+SPAN_LINE_READER::SPAN_LINE_READER( unsigned aStartingLineNumber, unsigned aMaxLineLength ) :
+    LINE_READER( aMaxLineLength ),
+    m_begin( nullptr ),
+    m_end( nullptr ),
+    m_next( nullptr ),
+    m_current( nullptr ),
+    m_startingLineNum( aStartingLineNumber ),
+    m_countedTo( nullptr ),
+    m_countedLines( 0 )
+{
+    m_lineNum = aStartingLineNumber;
+}
+
+
+void SPAN_LINE_READER::setSpan( const char* aBegin, const char* aEnd )
+{
+    m_begin = aBegin;
+    m_end = aEnd;
+
+    Rewind();
+}
+
+
+void SPAN_LINE_READER::Rewind()
+{
+    m_next = m_begin;
+    m_current = nullptr;
+    m_countedTo = m_begin;
+    m_countedLines = 0;
+}
+
+
+const char* SPAN_LINE_READER::nextLine( unsigned& aLength )
+{
+    const char* line = m_next;
+
+    if( line < m_end )
+    {
+        const char* nl = static_cast<const char*>( memchr( line, '\n', m_end - line ) );
+
+        if( nl && unsigned( nl - line ) < m_maxLineLength )
+            m_next = nl + 1;
+        else if( !nl && size_t( m_end - line ) <= m_maxLineLength )
+            m_next = m_end;
+        else
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+    }
+
+    m_current = line;
+    aLength = unsigned( m_next - line );
+
+    return line;
+}
+
+
+char* SPAN_LINE_READER::copyLine( const char* aLine, unsigned aLength )
+{
+    if( aLength + 1 > m_capacity )   // +1 for terminating nul
+        expandCapacity( aLength + 1 );
+
+    if( aLength )
+        memcpy( m_line, aLine, aLength );
+
+    m_line[aLength] = 0;
+    m_length = aLength;
+
+    return m_line;
+}
+
+
+char* SPAN_LINE_READER::ReadLine()
+{
+    unsigned    length;
+    const char* line = nextLine( length );
+
+    copyLine( line, length );
+
+    return m_length ? m_line : nullptr;
+}
+
+
+const char* SPAN_LINE_READER::ReadLineInPlace( unsigned& aLength )
+{
+    const char* line = nextLine( aLength );
+
+    // Nothing may follow the last line in memory.  If it has no newline to stop a lookahead,
+    // hand out a nul terminated copy instead.
+    if( aLength && line[aLength - 1] != '\n' )
+        return copyLine( line, aLength );
+
+    m_length = aLength;
+
+    return line;
+}
+
+
+unsigned SPAN_LINE_READER::LineNumber() const
+{
+    if( !m_current )
+        return m_startingLineNum;
+
+    // Lines are usually asked for going forwards, so only count from the last time
+    if( m_current < m_countedTo )
+    {
+        m_countedTo = m_begin;
+        m_countedLines = 0;
+    }
+
+    m_countedLines += (unsigned) std::count( m_countedTo, m_current, '\n' );
+    m_countedTo = m_current;
+
+    unsigned lineNum = m_startingLineNum + m_countedLines + 1;
+
+    // Like FILE_LINE_READER, count the EOF as a line of its own
+    if( m_current == m_end && m_end > m_begin && m_end[-1] != '\n' )
+        ++lineNum;
+
+    return lineNum;
+}
+
+
+const char* SPAN_LINE_READER::SeekLine( const char* aPos, unsigned& aLength, unsigned& aOffset )
+{
+    wxASSERT( aPos >= m_begin && aPos <= m_end );
+
+    const char* lineStart = aPos;
+
+    while( lineStart > m_begin && lineStart[-1] != '\n' )
+        --lineStart;
+
+    m_next = lineStart;
+    aOffset = unsigned( aPos - lineStart );
+
+    return ReadLineInPlace( aLength );
+}
+
+
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+                                                  unsigned aStartingLineNumber,
+                                                  unsigned aMaxLineLength ) :
+    SPAN_LINE_READER( aStartingLineNumber, aMaxLineLength ),
+    m_mapping( nullptr ),
+    m_mappedSize( 0 )
+{
+    m_mapping = KIPLATFORM::IO::MapFile( aFileName, m_mappedSize );
+
+    if( m_mapping )
+    {
+        setSpan( m_mapping, m_mapping + m_mappedSize );
+    }
+    else
+    {
+        // Empty files and file systems which don't support mapping end up here
+        FILE* fp = KIPLATFORM::IO::SeqFOpen( aFileName, wxT( "rb" ) );
+
+        if( !fp )
+        {
+            wxString msg = wxString::Format( _( "Unable to open %s for reading." ),
+                                             aFileName.GetData() );
+            THROW_IO_ERROR( msg );
+        }
+
+        char   chunk[65536];
+        size_t count;
+
+        while( ( count = fread( chunk, 1, sizeof( chunk ), fp ) ) > 0 )
+            m_buffer.insert( m_buffer.end(), chunk, chunk + count );
+
+        fclose( fp );
+
+        setSpan( m_buffer.data(), m_buffer.data() + m_buffer.size() );
+    }
+
+    m_source = aFileName;
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+    if( m_mapping )
+        KIPLATFORM::IO::UnmapFile( m_mapping, m_mappedSize );
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
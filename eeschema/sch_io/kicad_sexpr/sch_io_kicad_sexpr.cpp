@@ -21,6 +21,11 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
 
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
@@ -33,6 +38,7 @@
 #include <advanced_config.h>
 #include <base_units.h>
 #include <build_version.h>
+#include <core/thread_pool.h>
 #include <ee_selection.h>
 #include <font/fontconfig.h>
 #include <io/kicad/kicad_io_utils.h>
@@ -94,6 +100,7 @@ void SCH_IO_KICAD_SEXPR::init( SCHEMATIC* aSchematic, const STRING_UTF8_MAP* aPr
     m_schematic       = aSchematic;
     m_cache           = nullptr;
     m_out             = nullptr;
+    m_sheetPreloads   = nullptr;
     m_nextFreeFieldId = 100; // number arbitrarily > MANDATORY_FIELDS or SHEET_MANDATORY_FIELDS
 }
 
@@ -157,7 +164,7 @@ SCH_SHEET* SCH_IO_KICAD_SEXPR::LoadSchematicFile( const wxString& aFileName, SCH
 
         newSheet->SetFileName( relPath.GetFullPath() );
         m_rootSheet = newSheet.get();
-        loadHierarchy( SCH_SHEET_PATH(), newSheet.get() );
+        loadSheetHierarchy( newSheet.get() );
 
         // If we got here, the schematic loaded successfully.
         sheet = newSheet.release();
@@ -168,7 +175,7 @@ SCH_SHEET* SCH_IO_KICAD_SEXPR::LoadSchematicFile( const wxString& aFileName, SCH
         wxCHECK_MSG( aSchematic->IsValid(), nullptr, "Can't append to a schematic with no root!" );
         m_rootSheet = &aSchematic->Root();
         sheet = aAppendToMe;
-        loadHierarchy( SCH_SHEET_PATH(), sheet );
+        loadSheetHierarchy( sheet );
     }
 
     wxASSERT( m_currentPath.size() == 1 );  // only the project path should remain
@@ -179,6 +186,182 @@ SCH_SHEET* SCH_IO_KICAD_SEXPR::LoadSchematicFile( const wxString& aFileName, SCH
 }
 
 
+/**
+ * A sub-sheet file parsed on the thread pool before the hierarchy loading reaches it.
+ */
+struct SCH_IO_KICAD_SEXPR::SHEET_PRELOAD
+{
+    void Parse()
+    {
+        try
+        {
+            m_reader = std::make_unique<FILE_LINE_READER>( m_fileName );
+            m_parser = std::make_unique<SCH_IO_KICAD_SEXPR_PARSER>( m_reader.get(), nullptr, 0,
+                                                                    m_rootSheet, m_appending );
+            m_parser->ParseSchematicUnfinished( m_sheet.get() );
+        }
+        catch( ... )
+        {
+            m_error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_done = true;
+        }
+
+        m_condition.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_condition.wait( lock, [&]() { return m_done; } );
+    }
+
+    wxString                                   m_fileName;
+    std::unique_ptr<SCH_SHEET>                 m_sheet;     ///< Holds the screen parsed into.
+    SCH_SHEET*                                 m_rootSheet = nullptr;
+    bool                                       m_appending = false;
+
+    std::atomic<bool>                          m_claimed = false;   ///< Set by whoever parses.
+    std::mutex                                 m_mutex;
+    std::condition_variable                    m_condition;
+    bool                                       m_done = false;
+
+    std::unique_ptr<FILE_LINE_READER>          m_reader;
+    std::unique_ptr<SCH_IO_KICAD_SEXPR_PARSER> m_parser;
+    std::exception_ptr                         m_error;
+};
+
+
+struct SCH_IO_KICAD_SEXPR::SHEET_PRELOADS
+{
+    ~SHEET_PRELOADS()
+    {
+        // Files which were not needed after all may still be parsed by the thread pool
+        for( auto& [fileName, preload] : m_preloads )
+        {
+            if( !preload )
+                continue;
+
+            if( preload->m_claimed.exchange( true ) )
+                preload->Wait();
+
+            preload->m_parser.reset();
+            preload->m_reader.reset();
+            preload->m_sheet.reset();
+        }
+    }
+
+    /// Every file seen so far, by full path.  Null once loaded or when loaded without preload.
+    std::map<wxString, std::shared_ptr<SHEET_PRELOAD>> m_preloads;
+};
+
+
+void SCH_IO_KICAD_SEXPR::loadSheetHierarchy( SCH_SHEET* aSheet )
+{
+    std::unique_ptr<SHEET_PRELOADS> preloads;
+
+    if( ADVANCED_CFG::GetCfg().m_ConcurrentSchematicLoad )
+        preloads = std::make_unique<SHEET_PRELOADS>();
+
+    m_sheetPreloads = preloads.get();
+
+    try
+    {
+        loadHierarchy( SCH_SHEET_PATH(), aSheet );
+    }
+    catch( ... )
+    {
+        m_sheetPreloads = nullptr;
+        throw;
+    }
+
+    m_sheetPreloads = nullptr;
+}
+
+
+void SCH_IO_KICAD_SEXPR::preloadSubSheets( SCH_SCREEN* aScreen, const wxString& aPath )
+{
+    for( SCH_ITEM* aItem : aScreen->Items().OfType( SCH_SHEET_T ) )
+    {
+        SCH_SHEET* sheet = static_cast<SCH_SHEET*>( aItem );
+
+        if( sheet->GetScreen() )
+            continue;
+
+        wxFileName fileName = sheet->GetFileName();
+
+        if( !fileName.IsAbsolute() )
+            fileName.MakeAbsolute( aPath );
+
+        auto [it, inserted] = m_sheetPreloads->m_preloads.emplace( fileName.GetFullPath(),
+                                                                   nullptr );
+
+        if( !inserted )
+            continue;
+
+        std::shared_ptr<SHEET_PRELOAD> preload = std::make_shared<SHEET_PRELOAD>();
+        preload->m_fileName = fileName.GetFullPath();
+        preload->m_sheet = std::make_unique<SCH_SHEET>( m_schematic );
+        preload->m_sheet->SetScreen( new SCH_SCREEN( m_schematic ) );
+        preload->m_sheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+        preload->m_rootSheet = m_rootSheet;
+        preload->m_appending = m_appending;
+
+        it->second = preload;
+
+        GetKiCadThreadPool().push_task(
+                [preload]()
+                {
+                    if( !preload->m_claimed.exchange( true ) )
+                        preload->Parse();
+                } );
+    }
+}
+
+
+bool SCH_IO_KICAD_SEXPR::loadPreloadedFile( const wxString& aFileName, SCH_SHEET* aSheet )
+{
+    if( !m_sheetPreloads )
+        return false;
+
+    // Also marks files loaded without preloading, so that they are not preloaded later
+    std::shared_ptr<SHEET_PRELOAD> preload = std::move( m_sheetPreloads->m_preloads[aFileName] );
+
+    if( !preload )
+        return false;
+
+    if( m_progressReporter )
+    {
+        m_progressReporter->Report( wxString::Format( _( "Loading %s..." ), aFileName ) );
+
+        if( !m_progressReporter->KeepRefreshing() )
+            THROW_IO_ERROR( _( "Open cancelled by user." ) );
+    }
+
+    // Parse the file here rather than wait for the thread pool to get to it
+    if( !preload->m_claimed.exchange( true ) )
+        preload->Parse();
+    else
+        preload->Wait();
+
+    // Whatever was parsed before an error is kept, as when loading the file directly
+    aSheet->SetScreen( preload->m_sheet->GetScreen() );
+    preload->m_sheet.reset();
+
+    if( preload->m_error )
+        std::rethrow_exception( preload->m_error );
+
+    preload->m_parser->FinishSchematic( aSheet );
+    preload->m_parser.reset();
+    preload->m_reader.reset();
+
+    return true;
+}
+
+
 // Everything below this comment is recursive.  Modify with care.
 
 void SCH_IO_KICAD_SEXPR::loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath, SCH_SHEET* aSheet )
@@ -248,7 +431,8 @@ void SCH_IO_KICAD_SEXPR::loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath,
 
             try
             {
-                loadFile( fileName.GetFullPath(), aSheet );
+                if( !loadPreloadedFile( fileName.GetFullPath(), aSheet ) )
+                    loadFile( fileName.GetFullPath(), aSheet );
             }
             catch( const IO_ERROR& ioe )
             {
@@ -277,6 +461,10 @@ void SCH_IO_KICAD_SEXPR::loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath,
             SCH_SHEET_PATH currentSheetPath = aParentSheetPath;
             currentSheetPath.push_back( aSheet );
 
+            // Have the thread pool parse the sub-sheet files while the hierarchy is descended
+            if( m_sheetPreloads )
+                preloadSubSheets( aSheet->GetScreen(), fileName.GetPath() );
+
             // This was moved out of the try{} block so that any sheet definitions that
             // the plugin fully parsed before the exception was raised will be loaded.
             for( SCH_ITEM* aItem : aSheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
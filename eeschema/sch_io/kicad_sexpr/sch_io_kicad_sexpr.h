@@ -139,9 +139,34 @@ public:
     static void FormatLibSymbol( LIB_SYMBOL* aPart, OUTPUTFORMATTER& aFormatter );
 
 private:
+    struct SHEET_PRELOAD;
+    struct SHEET_PRELOADS;
+
+    /**
+     * Load the sheet hierarchy below \a aSheet, parsing the sub-sheet files on the thread pool
+     * when enabled.
+     */
+    void loadSheetHierarchy( SCH_SHEET* aSheet );
+
     void loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath, SCH_SHEET* aSheet );
     void loadFile( const wxString& aFileName, SCH_SHEET* aSheet );
 
+    /**
+     * Start parsing the files of the sub-sheets of \a aScreen which are not yet loaded or
+     * being parsed.
+     *
+     * @param aPath is the path relative sub-sheet file names are resolved against.
+     */
+    void preloadSubSheets( SCH_SCREEN* aScreen, const wxString& aPath );
+
+    /**
+     * Move the parsed contents of \a aFileName into \a aSheet if the file was preloaded.
+     *
+     * @return false if the file has to be loaded by #loadFile().
+     * @throw IO_ERROR if the preloaded file could not be parsed.
+     */
+    bool loadPreloadedFile( const wxString& aFileName, SCH_SHEET* aSheet );
+
     void saveSymbol( SCH_SYMBOL* aSymbol, const SCHEMATIC& aSchematic,
                      const SCH_SHEET_LIST& aSheetList, int aNestLevel,
                      bool aForClipboard, const SCH_SHEET_PATH* aRelativePath = nullptr );
@@ -174,6 +199,7 @@ protected:
     std::stack<wxString>    m_currentPath;      ///< Stack to maintain nested sheet paths
     SCH_SHEET*              m_rootSheet;        ///< The root sheet of the schematic being loaded.
     SCH_SHEET_PATH          m_currentSheetPath;
+    SHEET_PRELOADS*         m_sheetPreloads;    ///< Sub-sheet files parsed ahead of loading.
     SCHEMATIC*              m_schematic;
     OUTPUTFORMATTER*        m_out;              ///< The formatter for saving SCH_SCREEN objects.
     SCH_IO_KICAD_SEXPR_LIB_CACHE* m_cache;
@@ -2492,6 +2492,20 @@ void SCH_IO_KICAD_SEXPR_PARSER::parseSchSymbolInstances( SCH_SCREEN* aScreen )
 
 void SCH_IO_KICAD_SEXPR_PARSER::ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly,
                                                 int aFileVersion )
+{
+    parseSchematic( aSheet, aIsCopyableOnly, aFileVersion );
+    FinishSchematic( aSheet );
+}
+
+
+void SCH_IO_KICAD_SEXPR_PARSER::ParseSchematicUnfinished( SCH_SHEET* aSheet )
+{
+    parseSchematic( aSheet, false, SEXPR_SCHEMATIC_FILE_VERSION );
+}
+
+
+void SCH_IO_KICAD_SEXPR_PARSER::parseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly,
+                                                int aFileVersion )
 {
     wxCHECK( aSheet != nullptr, /* void */ );
 
@@ -2842,6 +2856,16 @@ void SCH_IO_KICAD_SEXPR_PARSER::ParseSchematic( SCH_SHEET* aSheet, bool aIsCopya
         const_cast<KIID&>( aSheet->m_Uuid ) = screen->GetUuid();
         m_rootUuid = screen->GetUuid();
     }
+}
+
+
+void SCH_IO_KICAD_SEXPR_PARSER::FinishSchematic( SCH_SHEET* aSheet )
+{
+    wxCHECK( aSheet != nullptr, /* void */ );
+
+    SCH_SCREEN* screen = aSheet->GetScreen();
+
+    wxCHECK( screen != nullptr, /* void */ );
 
     screen->UpdateLocalLibSymbolLinks();
     screen->FixupEmbeddedData();
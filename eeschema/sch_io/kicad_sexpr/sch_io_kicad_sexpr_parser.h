@@ -110,9 +110,27 @@ public:
     void ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyablyOnly = false,
                          int aFileVersion = SEXPR_SCHEMATIC_FILE_VERSION );
 
+    /**
+     * Parse the internal #LINE_READER object into \a aSheet like #ParseSchematic() does for
+     * a full schematic file, but leave out the steps which use the fonts and embedded files
+     * shared by the whole schematic.
+     *
+     * This allows several sheet files to be parsed at once.  #FinishSchematic() must be called
+     * afterwards, one sheet at a time.
+     */
+    void ParseSchematicUnfinished( SCH_SHEET* aSheet );
+
+    /**
+     * Link the symbols, embedded data and fonts of a schematic read by
+     * #ParseSchematicUnfinished().
+     */
+    void FinishSchematic( SCH_SHEET* aSheet );
+
     int GetParsedRequiredVersion() const { return m_requiredVersion; }
 
 private:
+    void parseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly, int aFileVersion );
+
     void checkpoint();
 
     KIID parseKIID();
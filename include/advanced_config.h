@@ -635,6 +635,147 @@ public:
      */
     bool m_ZoneConnectionFiller;
 
+    /**
+     * Run DRC test providers which declare their cache dependencies as concurrent tasks on the
+     * thread pool rather than one after another.
+     *
+     * Setting name: "DRCConcurrentProviders"
+     * Valid values: true or false
+     * Default value: false
+     */
+    bool m_DRCConcurrentProviders;
+
+    /**
+     * Cache the rule-based part of DRC constraint resolution for rules whose conditions depend
+     * only on the items' types, nets and netclasses.
+     *
+     * Setting name: "DRCConstraintCache"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_DRCConstraintCache;
+
+    /**
+     * Skip refilling zones whose fill inputs (outline, settings, nearby items and clearances)
+     * are unchanged since they were last filled.
+     *
+     * Setting name: "ZoneFillIncremental"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_ZoneFillIncremental;
+
+    /**
+     * Number of tracks per task when building the clearance knockouts of a large zone.  Zones
+     * with at least twice this many tracks nearby have their knockouts built in parallel
+     * chunks rather than by a single fill task.  0 disables chunking.
+     *
+     * Setting name: "ZoneFillTrackChunk"
+     * Valid values: 0 to 100000
+     * Default value: 512
+     */
+    int m_ZoneFillTrackChunk;
+
+    /**
+     * Keep the knockout polygons of pads, tracks and vias in a board-level cache so that they
+     * are built once rather than once per zone and per fill.
+     *
+     * Setting name: "ZoneFillKnockoutCache"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_ZoneFillKnockoutCache;
+
+    /**
+     * Update the ratsnest of a net from the triangulation computed for its previous state when
+     * only a few of its anchors have changed, rather than triangulating the whole net again.
+     *
+     * Setting name: "IncrementalRatsnest"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_IncrementalRatsnest;
+
+    /**
+     * Only propagate nets over the connectivity clusters touched since the last propagation,
+     * rather than over every cluster of the board.
+     *
+     * Setting name: "IncrementalNetPropagation"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_IncrementalNetPropagation;
+
+    /**
+     * Keep the index and hash tables of deleted router branches for reuse by the next branches
+     * instead of freeing them.
+     *
+     * Setting name: "RouterBranchPool"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_RouterBranchPool;
+
+    /**
+     * Look up the router's clearances between tracks, arcs and vias in a per-session table
+     * indexed by netclass and layer when the rules only depend on those.
+     *
+     * Setting name: "RouterClearanceMatrix"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_RouterClearanceMatrix;
+
+    /**
+     * Parse the files of large footprint libraries concurrently on the thread pool when
+     * loading the footprint cache.
+     *
+     * Setting name: "FootprintCacheConcurrentLoad"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_FootprintCacheConcurrentLoad;
+
+    /**
+     * Map board files into memory when loading them, so that they are tokenized in place
+     * instead of being read and copied a line at a time.
+     *
+     * Setting name: "MappedFileLoad"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_MappedFileLoad;
+
+    /**
+     * When loading a mapped board file, parse the runs of top-level footprints, tracks, vias
+     * and zones concurrently on the thread pool.
+     *
+     * Setting name: "ConcurrentBoardLoad"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_ConcurrentBoardLoad;
+
+    /**
+     * Parse the sub-sheet files of a schematic concurrently on the thread pool while the
+     * sheet hierarchy is loaded.
+     *
+     * Setting name: "ConcurrentSchematicLoad"
+     * Valid values: true or false
+     * Default value: true
+     */
+    bool m_ConcurrentSchematicLoad;
+
+    /**
+     * Re-run only the DRC providers affected by the changes committed since the last DRC run,
+     * keeping the markers of the others.
+     *
+     * Setting name: "IncrementalDRC"
+     * Valid values: true or false
+     * Default value: false
+     */
+    bool m_IncrementalDRC;
+
 ///@}
 
 private:
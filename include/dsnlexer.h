@@ -151,6 +151,14 @@ public:
      */
     bool SyncLineReaderWith( DSNLEXER& aLexer );
 
+    /**
+     * Usable only for DSN lexers reading from a #SPAN_LINE_READER.
+     *
+     * Continue lexing from @a aPos in the text of the reader, skipping everything before it.
+     * @return false if the reader is not a #SPAN_LINE_READER.
+     */
+    bool SeekSpan( const char* aPos );
+
     /**
      * Change the behavior of this lexer into or out of "specctra mode".
      *
@@ -439,7 +447,14 @@ public:
      */
     const char* CurLine() const
     {
-        return (const char*)(*reader);
+        // Lines read in place are not nul terminated, so return a copy of those
+        if( start != reader->Line() )
+        {
+            curLine.assign( start, limit );
+            return curLine.c_str();
+        }
+
+        return start;
     }
 
     /**
@@ -462,6 +477,16 @@ public:
         return curOffset + 1;
     }
 
+    /**
+     * Return where the current token starts.
+     *
+     * For lines read in place this points into the text of the #SPAN_LINE_READER.
+     */
+    const char* CurPos() const
+    {
+        return start + curOffset;
+    }
+
 #ifndef SWIG
 
 protected:
@@ -471,13 +496,11 @@ protected:
     {
         if( reader )
         {
-            reader->ReadLine();
-
-            unsigned len = reader->Length();
+            unsigned len;
 
-            // start may have changed in ReadLine(), which can resize and
-            // relocate reader's line buffer.
-            start = reader->Line();
+            // start may have changed in ReadLineInPlace(), which can resize and
+            // relocate reader's line buffer or return a line in place.
+            start = reader->ReadLineInPlace( len );
 
             next  = start;
             limit = next + len;
@@ -557,6 +580,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    mutable std::string curLine;                ///< nul terminated copy of a line read in place
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -348,6 +348,12 @@ public:
                            const EDA_ANGLE& aAngle, const VECTOR2I& aOffset );
     void AddRenderCacheGlyph( const SHAPE_POLY_SET& aPoly );
 
+    /**
+     * Build the bounding box cache, and the render cache of outline font text, so that the
+     * text shape can then be read from several threads at once.
+     */
+    void BuildShapeCaches() const;
+
     int Compare( const EDA_TEXT* aOther ) const;
 
     bool operator==( const EDA_TEXT& aRhs ) const { return Compare( &aRhs ) == 0; }
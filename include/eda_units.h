@@ -25,6 +25,7 @@
 #ifndef EDA_UNITS_H
 #define EDA_UNITS_H
 
+#include <charconv>
 #include <kicommon.h>
 #include <wx/string.h>
 #include <geometry/eda_angle.h>
@@ -126,7 +127,35 @@ namespace EDA_UNIT_UTILS
     KICOMMON_API std::string FormatInternalUnits( const EDA_IU_SCALE& aIuScale,
                                                   const VECTOR2I&     aPoint );
 
-#if 0   // No support for std::from_chars on MacOS yet
+    /**
+     * Write \a aValue from internal units to \a aBegin ... \a aEnd in millimetres, the same
+     * way as the std::string version, but without allocating.
+     *
+     * Scales which are a power of ten of a millimetre are converted with integer arithmetic
+     * only, so the result is exact and independent of the locale.
+     *
+     * @return the position past the last character written, as std::to_chars() does.  The
+     *         error is std::errc::value_too_large if the text does not fit.
+     */
+    KICOMMON_API std::to_chars_result FormatInternalUnits( char* aBegin, char* aEnd,
+                                                           const EDA_IU_SCALE& aIuScale,
+                                                           int aValue );
+
+    /**
+     * Convert the millimetre value at the start of \a aBegin ... \a aEnd to internal units.
+     *
+     * This accepts what std::from_chars() accepts for a decimal floating point number, except
+     * infinities and NaNs.  Scales which are a power of ten of a millimetre are converted with
+     * integer arithmetic only, rounding half away from zero like KiROUND().  Values beyond the
+     * range of an int are clamped to it.
+     *
+     * @return the position past the last character used, as std::from_chars() does.  The
+     *         error is std::errc::invalid_argument if the text does not start with a number.
+     */
+    KICOMMON_API std::from_chars_result ParseInternalUnits( const char* aBegin, const char* aEnd,
+                                                            const EDA_IU_SCALE& aIuScale,
+                                                            int& aOut );
+
     /**
      * Converts \a aInput string to internal units when reading from a file.
      * 
@@ -135,7 +164,7 @@ namespace EDA_UNIT_UTILS
      * @param aInput is std::string to parse.
      * @param aIuScale is the scale to use.
      * @param aOut is the output reference.
-     * @return true if the parsing was successful.
+     * @return true if the parsing was successful and used the whole string.
      */
     KICOMMON_API bool ParseInternalUnits( const std::string& aInput, const EDA_IU_SCALE& aIuScale,
                                           int& aOut );
@@ -148,11 +177,10 @@ namespace EDA_UNIT_UTILS
      * @param aInput is std::string to parse.
      * @param aIuScale is the scale to use.
      * @param aOut is the output reference vector.
-     * @return true if the parsing was successful.
+     * @return true if \a aInput is exactly two numbers separated by a space.
      */
     KICOMMON_API bool ParseInternalUnits( const std::string& aInput, const EDA_IU_SCALE& aIuScale,
                                           VECTOR2I& aOut );
-#endif
 
     constexpr inline int Mils2IU( const EDA_IU_SCALE& aIuScale, int mils )
     {
@@ -22,10 +22,13 @@
 #define __LIBEVAL_COMPILER_H
 
 #include <cstddef>
+#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <stack>
+#include <vector>
 
 #include <kicommon.h>
 #include <base_units.h>
@@ -56,6 +59,9 @@
 #define TR_OP_METHOD_CALL 25
 #define TR_UOP_PUSH_VAR 1
 #define TR_UOP_PUSH_VALUE 2
+#define TR_UOP_JUMP_IF_FALSE 3
+#define TR_UOP_JUMP_IF_TRUE 4
+#define TR_UOP_COMPARE_VAR 5
 
 // This namespace is used for the lemon parser
 namespace LIBEVAL
@@ -352,6 +358,21 @@ public:
         return m_stackPtr;
     };
 
+    /**
+     * Make sure there are at least \a aCount result registers.  Registers are owned by the
+     * context and reused by each UCODE::Run() on it.
+     */
+    void ReserveRegisters( size_t aCount )
+    {
+        if( m_registers.size() < aCount )
+            m_registers.resize( aCount );
+    }
+
+    VALUE* Register( int aIndex )
+    {
+        return &m_registers[ aIndex ];
+    }
+
     void SetErrorCallback( std::function<void( const wxString& aMessage, int aOffset )> aCallback )
     {
         m_errorCallback = std::move( aCallback );
@@ -363,6 +384,7 @@ public:
 
 private:
     std::vector<VALUE*> m_ownedValues;
+    std::deque<VALUE>   m_registers;        // deque so that growing keeps existing results valid
     VALUE*              m_stack[100];       // std::stack not performant enough
     int                 m_stackPtr;
 
@@ -373,13 +395,29 @@ private:
 class KICOMMON_API UCODE
 {
 public:
+    UCODE() = default;
+    UCODE( const UCODE& ) = delete;
+    UCODE& operator=( const UCODE& ) = delete;
+
     virtual ~UCODE();
 
-    void AddOp( UOP* uop )
-    {
-        m_ucode.push_back(uop);
-    }
+    /**
+     * Append an op to the code.  The op's contents are moved into the code, and the op itself
+     * is deleted.
+     */
+    void AddOp( UOP* uop );
 
+    /**
+     * Rewrite the code for faster execution: fold constant sub-expressions, fuse comparisons
+     * of a property against a constant into a single op, add short-circuit jumps to the
+     * logical operators, and allocate the registers which ops store their results in.
+     */
+    void Optimize();
+
+    /**
+     * Execute the code.  The result remains valid until the context is destroyed or is used
+     * for another run.
+     */
     VALUE* Run( CONTEXT* ctx );
     wxString Dump() const;
 
@@ -395,7 +433,8 @@ public:
 
 protected:
 
-    std::vector<UOP*> m_ucode;
+    std::vector<UOP> m_ucode;
+    int              m_registerCount = 0;
 };
 
 
@@ -421,20 +460,41 @@ public:
         m_value(nullptr)
     {};
 
+    UOP( UOP&& ) = default;
+    UOP& operator=( UOP&& ) = default;
+
     ~UOP()
     {
     }
 
-    void Exec( CONTEXT* ctx );
+    /**
+     * Set the number of parameters a TR_OP_METHOD_CALL takes off the stack.
+     */
+    void SetParamCount( int aCount ) { m_paramCount = aCount; }
+
+    /**
+     * @return true if execution should continue at the op's jump target rather than at the
+     *         next op.
+     */
+    bool Exec( CONTEXT* ctx );
 
     wxString Format() const;
 
 private:
+    friend class UCODE;
+
+    int stackEffect() const;
+
     int                      m_op;
 
     FUNC_CALL_REF            m_func;
     std::unique_ptr<VAR_REF> m_ref;
     std::unique_ptr<VALUE>   m_value;
+
+    int                      m_compareOp = 0;   // TR_OP_EQUAL or TR_OP_NOT_EQUAL
+    int                      m_register = -1;   // context register holding the op's result
+    size_t                   m_jumpTarget = 0;
+    int                      m_paramCount = 0;
 };
 
 class KICOMMON_API TOKENIZER
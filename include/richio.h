@@ -112,6 +112,23 @@ public:
      */
     virtual char* ReadLine() = 0;
 
+    /**
+     * Read a line of text like ReadLine(), but return it in place when the reader holds the
+     * whole text in memory instead of copying it into the line buffer.
+     *
+     * A line returned in place is not nul terminated.  It stays valid until the next read.
+     *
+     * @param aLength is set to the number of bytes in the line, or 0 on EOF.
+     * @return The beginning of the read line.
+     * @throw IO_ERROR when a line is too long.
+     */
+    virtual const char* ReadLineInPlace( unsigned& aLength )
+    {
+        ReadLine();
+        aLength = m_length;
+        return m_line;
+    }
+
     /**
      * Returns the name of the source of the lines in an abstract sense.
      *
@@ -246,6 +263,116 @@ protected:
 };
 
 
+/**
+ * A #LINE_READER that reads from text which is held in memory as one contiguous span.
+ *
+ * ReadLineInPlace() hands out lines without copying them.  Line numbers are only worked out
+ * when LineNumber() is called, by counting the newlines from where it was last called.
+ */
+class KICOMMON_API SPAN_LINE_READER : public LINE_READER
+{
+public:
+    /**
+     * Read the text from @a aBegin to @a aEnd, which has to outlive the reader.
+     *
+     * @param aSource describes the source of the text for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the longest line ReadLine() will copy.
+     */
+    SPAN_LINE_READER( const char* aBegin, const char* aEnd, const wxString& aSource,
+                      unsigned aStartingLineNumber = 0,
+                      unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    char* ReadLine() override;
+
+    const char* ReadLineInPlace( unsigned& aLength ) override;
+
+    unsigned LineNumber() const override;
+
+    /**
+     * Continue reading from the line holding @a aPos.
+     *
+     * @param aLength is set to the length of that line.
+     * @param aOffset is set to the offset of @a aPos in that line.
+     * @return the line, as ReadLineInPlace() would have returned it.
+     */
+    const char* SeekLine( const char* aPos, unsigned& aLength, unsigned& aOffset );
+
+    /**
+     * Rewind to the start of the text and reset the line number.
+     */
+    void Rewind();
+
+    /**
+     * @return the start of the text.
+     */
+    const char* Begin() const { return m_begin; }
+
+    /**
+     * @return one past the end of the text.
+     */
+    const char* End() const { return m_end; }
+
+protected:
+    SPAN_LINE_READER( unsigned aStartingLineNumber, unsigned aMaxLineLength );
+
+    /**
+     * Set the text to read and rewind to its start.
+     */
+    void setSpan( const char* aBegin, const char* aEnd );
+
+    /**
+     * Advance over the next line.
+     *
+     * @return the start of the line, whose length is put in @a aLength.
+     */
+    const char* nextLine( unsigned& aLength );
+
+    /**
+     * Copy @a aLength bytes from @a aLine into the nul terminated line buffer.
+     */
+    char* copyLine( const char* aLine, unsigned aLength );
+
+    const char*         m_begin;
+    const char*         m_end;
+    const char*         m_next;          ///< start of the next line to read.
+    const char*         m_current;       ///< start of the last line read, nullptr before any.
+    unsigned            m_startingLineNum;
+
+    mutable const char* m_countedTo;     ///< newlines before this have been counted ...
+    mutable unsigned    m_countedLines;  ///< ... and this is how many there were.
+};
+
+
+/**
+ * A #SPAN_LINE_READER over a whole file mapped into memory.
+ *
+ * Files which cannot be mapped are read into a buffer instead.
+ */
+class KICOMMON_API MAPPED_FILE_LINE_READER : public SPAN_LINE_READER
+{
+public:
+    /**
+     * Open and map @a aFileName.
+     *
+     * @param aFileName is the name of the file to map and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the longest line ReadLine() will copy.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName, unsigned aStartingLineNumber = 0,
+                             unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MAPPED_FILE_LINE_READER();
+
+protected:
+    const char*        m_mapping;
+    size_t             m_mappedSize;    ///< size of m_mapping, 0 if m_buffer is used.
+    std::vector<char>  m_buffer;
+};
+
+
 /**
  * Is a #LINE_READER that reads from a multiline 8 bit wide std::string
  */
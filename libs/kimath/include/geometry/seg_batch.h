@@ -0,0 +1,102 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __SEG_BATCH_H
+#define __SEG_BATCH_H
+
+#include <vector>
+
+#include <geometry/seg.h>
+
+class SHAPE_ARC;
+
+/**
+ * A set of candidate segments and arcs which a single segment can be tested against in one go.
+ *
+ * The bounding boxes of the candidates are kept as structure-of-arrays so that the rejection
+ * of far away candidates, which is where most of the time goes, runs several candidates at a
+ * time (AVX2 or SSE2 where the build targets them, plain C++ otherwise).  The candidates which
+ * survive it get the exact integer tests of SEG and SHAPE_ARC, so the results are the same as
+ * testing each candidate on its own.
+ *
+ * Filling the batch costs about as much as testing the candidates one by one when there are
+ * fewer than a dozen of them, so it pays off when the same candidates are tested against many
+ * segments, as in the line chain against line chain collision.  It only reports the closest
+ * (or first) colliding candidate at a single clearance, so it is not a fit for callers which
+ * need every colliding candidate, each at its own clearance, such as the DRC clearance tests.
+ */
+class SEG_BATCH
+{
+public:
+    SEG_BATCH() {}
+
+    void Clear();
+    void Reserve( size_t aCount );
+
+    /**
+     * Add a segment with an optional width.  \a aTag is returned by Collide() to identify it.
+     */
+    void Add( const SEG& aSeg, int aWidth = 0, int aTag = -1 );
+
+    /**
+     * Add an arc.  The arc is not copied and has to outlive the batch.
+     */
+    void Add( const SHAPE_ARC* aArc, int aTag = -1 );
+
+    size_t Size() const { return m_segs.size(); }
+    bool   Empty() const { return m_segs.empty(); }
+
+    /**
+     * Test \a aSeg against the candidates.
+     *
+     * @param aClearance is the distance below which a candidate collides, measured from its
+     *                   edges for candidates with a width.
+     * @param aActual if not null, look for the closest candidate and return its distance.
+     *                Otherwise stop at the first colliding candidate.
+     * @param aTag if not null, the tag of the colliding candidate.
+     * @return true if any candidate collides.
+     */
+    bool Collide( const SEG& aSeg, int aClearance, int* aActual = nullptr,
+                  int* aTag = nullptr ) const;
+
+private:
+    /**
+     * @return a bit for each of the 8 candidates from \a aFirst onwards whose bounding box
+     *         overlaps \a aQueryBox (min x, min y, max x, max y).
+     */
+    unsigned filterBlock( size_t aFirst, const int* aQueryBox ) const;
+
+    bool overlaps( size_t aIndex, const int* aQueryBox ) const;
+
+    std::vector<int>              m_minX;
+    std::vector<int>              m_minY;
+    std::vector<int>              m_maxX;
+    std::vector<int>              m_maxY;
+
+    std::vector<SEG>              m_segs;
+    std::vector<int>              m_halfWidths;
+    std::vector<const SHAPE_ARC*> m_arcs;
+    std::vector<int>              m_tags;
+};
+
+#endif // __SEG_BATCH_H
@@ -931,6 +931,15 @@ protected:
             std::vector<CLIPPER_Z_VALUE> &aZValueBuffer,
             std::vector<SHAPE_ARC> &aArcBuffer ) const;
 
+    /**
+     * Convert the SHAPE_LINE_CHAIN to a Clipper2 path in a given orientation, reusing the
+     * storage of \a aPath.
+     */
+    void convertToClipper2( bool aRequiredOrientation,
+                            std::vector<CLIPPER_Z_VALUE>& aZValueBuffer,
+                            std::vector<SHAPE_ARC>& aArcBuffer,
+                            Clipper2Lib::Path64& aPath ) const;
+
     /**
      * Fix indices of this chain to ensure arcs are not split between the end and start indices
      */
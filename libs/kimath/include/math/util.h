@@ -161,6 +161,48 @@ int sign( T val )
     return ( T( 0 ) < val) - ( val < T( 0 ) );
 }
 
+template <typename T>
+constexpr T sqrt_helper( T x, T lo, T hi )
+{
+    if( lo == hi )
+        return lo;
+
+    const T mid = ( lo + hi + 1 ) / 2;
+
+    if( x / mid < mid )
+        return sqrt_helper<T>( x, lo, mid - 1 );
+    else
+        return sqrt_helper( x, mid, hi );
+}
+
+template <typename T>
+constexpr T ct_sqrt( T x )
+{
+    return sqrt_helper<T>( x, 0, x / 2 + 1 );
+}
+
+template <typename T>
+static constexpr T sqrt_max_typed = ct_sqrt( std::numeric_limits<T>::max() );
+
+/**
+ * Integer square root, rounded down.  Unlike a plain cast of std::sqrt() this is exact for
+ * values too large to be represented exactly as a double.
+ */
+template <typename T>
+T isqrt( T x )
+{
+    T r = (T) std::sqrt( (double) x );
+    T sqrt_max = sqrt_max_typed<T>;
+
+    while( r < sqrt_max && r * r < x )
+        r++;
+
+    while( r > sqrt_max || r * r > x )
+        r--;
+
+    return r;
+}
+
 // explicit specializations for integer types, taking care of overflow.
 template <>
 int rescale( int aNumerator, int aValue, int aDenominator );
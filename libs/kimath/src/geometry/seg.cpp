@@ -35,43 +35,6 @@ int sgn( T aVal )
     return ( T( 0 ) < aVal ) - ( aVal < T( 0 ) );
 }
 
-template <typename T>
-constexpr T sqrt_helper(T x, T lo, T hi)
-{
-  if (lo == hi)
-    return lo;
-
-  const T mid = (lo + hi + 1) / 2;
-  if (x / mid < mid)
-    return sqrt_helper<T>(x, lo, mid - 1);
-  else
-    return sqrt_helper(x, mid, hi);
-}
-
-template <typename T>
-constexpr T ct_sqrt(T x)
-{
-  return sqrt_helper<T>(x, 0, x / 2 + 1);
-}
-
-template <typename T>
-static constexpr T sqrt_max_typed = ct_sqrt( std::numeric_limits<T>::max() );
-
-template <typename T>
-T isqrt(T x)
-{
-  T r = (T) std::sqrt((double) x);
-  T sqrt_max = sqrt_max_typed<T>;
-
-  while (r < sqrt_max && r * r < x)
-    r++;
-  while (r > sqrt_max || r * r > x)
-    r--;
-
-  return r;
-}
-
-
 SEG::ecoord SEG::SquaredDistance( const SEG& aSeg ) const
 {
     if( Intersects( aSeg ) )
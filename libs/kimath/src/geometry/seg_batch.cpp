@@ -0,0 +1,266 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Only the instruction sets the build targets anyway are used, so there is no need for
+// run-time dispatch.  SSE2 is part of every x86-64 target.
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#define SEG_BATCH_AVX2
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || defined( _M_AMD64 )
+#include <emmintrin.h>
+#define SEG_BATCH_SSE2
+#endif
+
+#include <geometry/seg_batch.h>
+#include <geometry/shape_arc.h>
+#include <math/util.h>
+
+typedef VECTOR2I::extended_type ecoord;
+
+
+static const size_t c_blockSize = 8;
+
+
+static int saturate( int64_t aValue )
+{
+    return (int) std::clamp<int64_t>( aValue, std::numeric_limits<int>::min(),
+                                      std::numeric_limits<int>::max() );
+}
+
+
+void SEG_BATCH::Clear()
+{
+    m_minX.clear();
+    m_minY.clear();
+    m_maxX.clear();
+    m_maxY.clear();
+    m_segs.clear();
+    m_halfWidths.clear();
+    m_arcs.clear();
+    m_tags.clear();
+}
+
+
+void SEG_BATCH::Reserve( size_t aCount )
+{
+    m_minX.reserve( aCount );
+    m_minY.reserve( aCount );
+    m_maxX.reserve( aCount );
+    m_maxY.reserve( aCount );
+    m_segs.reserve( aCount );
+    m_halfWidths.reserve( aCount );
+    m_arcs.reserve( aCount );
+    m_tags.reserve( aCount );
+}
+
+
+void SEG_BATCH::Add( const SEG& aSeg, int aWidth, int aTag )
+{
+    int halfWidth = aWidth / 2;
+
+    m_minX.push_back( saturate( (int64_t) std::min( aSeg.A.x, aSeg.B.x ) - halfWidth ) );
+    m_minY.push_back( saturate( (int64_t) std::min( aSeg.A.y, aSeg.B.y ) - halfWidth ) );
+    m_maxX.push_back( saturate( (int64_t) std::max( aSeg.A.x, aSeg.B.x ) + halfWidth ) );
+    m_maxY.push_back( saturate( (int64_t) std::max( aSeg.A.y, aSeg.B.y ) + halfWidth ) );
+
+    m_segs.push_back( aSeg );
+    m_halfWidths.push_back( halfWidth );
+    m_arcs.push_back( nullptr );
+    m_tags.push_back( aTag );
+}
+
+
+void SEG_BATCH::Add( const SHAPE_ARC* aArc, int aTag )
+{
+    // The cached bounding box of the arc is rounded, so leave some margin around it
+    BOX2I bbox = aArc->BBox( 1 );
+
+    m_minX.push_back( bbox.GetLeft() );
+    m_minY.push_back( bbox.GetTop() );
+    m_maxX.push_back( bbox.GetRight() );
+    m_maxY.push_back( bbox.GetBottom() );
+
+    m_segs.push_back( SEG( aArc->GetP0(), aArc->GetP1() ) );
+    m_halfWidths.push_back( 0 );
+    m_arcs.push_back( aArc );
+    m_tags.push_back( aTag );
+}
+
+
+bool SEG_BATCH::overlaps( size_t aIndex, const int* aQueryBox ) const
+{
+    return !( m_maxX[aIndex] < aQueryBox[0] || m_maxY[aIndex] < aQueryBox[1]
+              || m_minX[aIndex] > aQueryBox[2] || m_minY[aIndex] > aQueryBox[3] );
+}
+
+
+unsigned SEG_BATCH::filterBlock( size_t aFirst, const int* aQueryBox ) const
+{
+#if defined( SEG_BATCH_AVX2 )
+    const __m256i qMinX = _mm256_set1_epi32( aQueryBox[0] );
+    const __m256i qMinY = _mm256_set1_epi32( aQueryBox[1] );
+    const __m256i qMaxX = _mm256_set1_epi32( aQueryBox[2] );
+    const __m256i qMaxY = _mm256_set1_epi32( aQueryBox[3] );
+
+    const __m256i minX = _mm256_loadu_si256( (const __m256i*) &m_minX[aFirst] );
+    const __m256i minY = _mm256_loadu_si256( (const __m256i*) &m_minY[aFirst] );
+    const __m256i maxX = _mm256_loadu_si256( (const __m256i*) &m_maxX[aFirst] );
+    const __m256i maxY = _mm256_loadu_si256( (const __m256i*) &m_maxY[aFirst] );
+
+    const __m256i outside = _mm256_or_si256(
+            _mm256_or_si256( _mm256_cmpgt_epi32( qMinX, maxX ), _mm256_cmpgt_epi32( qMinY, maxY ) ),
+            _mm256_or_si256( _mm256_cmpgt_epi32( minX, qMaxX ), _mm256_cmpgt_epi32( minY, qMaxY ) ) );
+
+    return ~(unsigned) _mm256_movemask_ps( _mm256_castsi256_ps( outside ) ) & 0xFF;
+#elif defined( SEG_BATCH_SSE2 )
+    const __m128i qMinX = _mm_set1_epi32( aQueryBox[0] );
+    const __m128i qMinY = _mm_set1_epi32( aQueryBox[1] );
+    const __m128i qMaxX = _mm_set1_epi32( aQueryBox[2] );
+    const __m128i qMaxY = _mm_set1_epi32( aQueryBox[3] );
+
+    unsigned mask = 0;
+
+    for( size_t half = 0; half < c_blockSize; half += 4 )
+    {
+        const size_t  ii = aFirst + half;
+        const __m128i minX = _mm_loadu_si128( (const __m128i*) &m_minX[ii] );
+        const __m128i minY = _mm_loadu_si128( (const __m128i*) &m_minY[ii] );
+        const __m128i maxX = _mm_loadu_si128( (const __m128i*) &m_maxX[ii] );
+        const __m128i maxY = _mm_loadu_si128( (const __m128i*) &m_maxY[ii] );
+
+        const __m128i outside = _mm_or_si128(
+                _mm_or_si128( _mm_cmplt_epi32( maxX, qMinX ), _mm_cmplt_epi32( maxY, qMinY ) ),
+                _mm_or_si128( _mm_cmpgt_epi32( minX, qMaxX ), _mm_cmpgt_epi32( minY, qMaxY ) ) );
+
+        mask |= ( ~(unsigned) _mm_movemask_ps( _mm_castsi128_ps( outside ) ) & 0xF ) << half;
+    }
+
+    return mask;
+#else
+    unsigned mask = 0;
+
+    for( size_t ii = 0; ii < c_blockSize; ++ii )
+    {
+        if( overlaps( aFirst + ii, aQueryBox ) )
+            mask |= 1u << ii;
+    }
+
+    return mask;
+#endif
+}
+
+
+bool SEG_BATCH::Collide( const SEG& aSeg, int aClearance, int* aActual, int* aTag ) const
+{
+    const int queryBox[4] = {
+        saturate( (int64_t) std::min( aSeg.A.x, aSeg.B.x ) - aClearance ),
+        saturate( (int64_t) std::min( aSeg.A.y, aSeg.B.y ) - aClearance ),
+        saturate( (int64_t) std::max( aSeg.A.x, aSeg.B.x ) + aClearance ),
+        saturate( (int64_t) std::max( aSeg.A.y, aSeg.B.y ) + aClearance )
+    };
+
+    bool   found = false;
+    int    bestActual = std::numeric_limits<int>::max();
+    ecoord bestDistSq = VECTOR2I::ECOORD_MAX;
+    int    bestTag = -1;
+
+    // Returns true when no other candidate can do better
+    auto test =
+            [&]( size_t aIndex ) -> bool
+            {
+                int    actual = 0;
+                ecoord distSq = 0;
+
+                if( const SHAPE_ARC* arc = m_arcs[aIndex] )
+                {
+                    if( !arc->Collide( aSeg, aClearance, aActual ? &actual : nullptr ) )
+                        return false;
+
+                    distSq = (ecoord) actual * actual;
+                }
+                else
+                {
+                    const int halfWidth = m_halfWidths[aIndex];
+
+                    distSq = m_segs[aIndex].SquaredDistance( aSeg );
+
+                    if( distSq != 0 && distSq >= SEG::Square( aClearance + halfWidth ) )
+                        return false;
+
+                    actual = std::max( 0, (int) isqrt( distSq ) - halfWidth );
+                }
+
+                if( !found || actual < bestActual
+                        || ( actual == bestActual && distSq < bestDistSq ) )
+                {
+                    found = true;
+                    bestActual = actual;
+                    bestDistSq = distSq;
+                    bestTag = m_tags[aIndex];
+                }
+
+                // If we're not looking for aActual then any collision will do
+                return !aActual || bestDistSq == 0;
+            };
+
+    auto scan =
+            [&]()
+            {
+                const size_t count = m_segs.size();
+                size_t       ii = 0;
+
+                for( ; ii + c_blockSize <= count; ii += c_blockSize )
+                {
+                    for( unsigned mask = filterBlock( ii, queryBox ), bit = 0; mask;
+                         mask >>= 1, ++bit )
+                    {
+                        if( ( mask & 1 ) && test( ii + bit ) )
+                            return;
+                    }
+                }
+
+                for( ; ii < count; ++ii )
+                {
+                    if( overlaps( ii, queryBox ) && test( ii ) )
+                        return;
+                }
+            };
+
+    scan();
+
+    if( !found )
+        return false;
+
+    if( aActual )
+        *aActual = bestActual;
+
+    if( aTag )
+        *aTag = bestTag;
+
+    return true;
+}
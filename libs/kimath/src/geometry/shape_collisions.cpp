@@ -27,6 +27,7 @@
 #include <limits>
 
 #include <geometry/seg.h>                         // for SEG
+#include <geometry/seg_batch.h>
 #include <geometry/shape.h>
 #include <geometry/shape_arc.h>
 #include <geometry/shape_line_chain.h>
@@ -311,6 +312,7 @@ static inline bool Collide( const SHAPE_LINE_CHAIN_BASE& aA, const SHAPE_LINE_CH
     {
         std::vector<SEG> a_segs;
         std::vector<SEG> b_segs;
+        SEG_BATCH        b_batch;
 
         for( size_t ii = 0; ii < aA.GetSegmentCount(); ii++ )
         {
@@ -330,35 +332,30 @@ static inline bool Collide( const SHAPE_LINE_CHAIN_BASE& aA, const SHAPE_LINE_CH
             }
         }
 
-        auto seg_sort = []( const SEG& a, const SEG& b )
-        {
-            return a.A.x < b.A.x || ( a.A.x == b.A.x && a.A.y < b.A.y );
-        };
+        b_batch.Reserve( b_segs.size() );
 
-        std::sort( a_segs.begin(), a_segs.end(), seg_sort );
-        std::sort( b_segs.begin(), b_segs.end(), seg_sort );
+        for( size_t ii = 0; ii < b_segs.size(); ii++ )
+            b_batch.Add( b_segs[ii], 0, (int) ii );
+
+        // The nearest location needs the actual distance too, to pick the closest collision
+        bool wantDist = aActual || aLocation;
 
         for( const SEG& a_seg : a_segs )
         {
-            for( const SEG& b_seg : b_segs )
-            {
-                int dist = 0;
+            int dist = 0;
+            int b_idx = -1;
 
-                if( a_seg.Collide( b_seg, aClearance, aActual || aLocation ? &dist : nullptr ) )
+            if( b_batch.Collide( a_seg, aClearance, wantDist ? &dist : nullptr, &b_idx ) )
+            {
+                if( dist < closest_dist )
                 {
-                    if( dist < closest_dist )
-                    {
-                        nearest = a_seg.NearestPoint( b_seg );
-                        closest_dist = dist;
-                    }
-
-                    if( closest_dist == 0 )
-                        break;
-
-                    // If we're not looking for aActual then any collision will do
-                    if( !aActual )
-                        break;
+                    nearest = a_seg.NearestPoint( b_segs[b_idx] );
+                    closest_dist = dist;
                 }
+
+                // If we're looking for neither aActual nor aLocation then any collision will do
+                if( closest_dist == 0 || !wantDist )
+                    break;
             }
         }
     }
@@ -235,6 +235,39 @@ Clipper2Lib::Path64 SHAPE_LINE_CHAIN::convertToClipper2( bool aRequiredOrientati
 }
 
 
+void SHAPE_LINE_CHAIN::convertToClipper2( bool aRequiredOrientation,
+                                          std::vector<CLIPPER_Z_VALUE>& aZValueBuffer,
+                                          std::vector<SHAPE_ARC>& aArcBuffer,
+                                          Clipper2Lib::Path64& aPath ) const
+{
+    // Reversing a chain with arcs means renumbering its shapes, so leave that to Reverse()
+    if( !m_arcs.empty() )
+    {
+        aPath = convertToClipper2( aRequiredOrientation, aZValueBuffer, aArcBuffer );
+        return;
+    }
+
+    bool    reverse = ( Area( false ) >= 0 ) != aRequiredOrientation;
+    ssize_t shape_offset = aArcBuffer.size();
+    int     pointCount = PointCount();
+
+    aPath.clear();
+    aPath.reserve( pointCount );
+
+    for( int i = 0; i < pointCount; i++ )
+    {
+        int             idx = reverse ? pointCount - 1 - i : i;
+        const VECTOR2I& vertex = m_points[idx];
+
+        CLIPPER_Z_VALUE z_value( m_shapes[idx], shape_offset );
+        size_t          z_value_ptr = aZValueBuffer.size();
+        aZValueBuffer.push_back( z_value );
+
+        aPath.emplace_back( vertex.x, vertex.y, z_value_ptr );
+    }
+}
+
+
 void SHAPE_LINE_CHAIN::fixIndicesRotation()
 {
     wxCHECK( m_shapes.size() == m_points.size(), /*void*/ );
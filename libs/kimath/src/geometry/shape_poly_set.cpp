@@ -863,28 +863,38 @@ void SHAPE_POLY_SET::booleanOp( Clipper2Lib::ClipType aType, const SHAPE_POLY_SE
 
     Clipper2Lib::Clipper64 c;
 
-    std::vector<CLIPPER_Z_VALUE> zValues;
-    std::vector<SHAPE_ARC> arcBuffer;
-    std::map<VECTOR2I, CLIPPER_Z_VALUE> newIntersectPoints;
+    // Boolean ops are called a great many times during zone fills and DRC.  Rather than
+    // allocating the conversion buffers every time, each thread keeps its own set around.
+    // (Nothing below can call back into booleanOp() on the same thread.)
+    thread_local std::vector<CLIPPER_Z_VALUE> zValues;
+    thread_local std::vector<SHAPE_ARC>       arcBuffer;
+    thread_local Clipper2Lib::Paths64         paths;
+    thread_local Clipper2Lib::Paths64         clips;
+
+    zValues.clear();
+    arcBuffer.clear();
+
+    auto convertPaths =
+            [&]( const SHAPE_POLY_SET& aPolySet, Clipper2Lib::Paths64& aPaths )
+            {
+                size_t count = 0;
 
-    Clipper2Lib::Paths64 paths;
-    Clipper2Lib::Paths64 clips;
+                for( const POLYGON& poly : aPolySet.m_polys )
+                {
+                    for( size_t i = 0; i < poly.size(); i++ )
+                    {
+                        if( count == aPaths.size() )
+                            aPaths.emplace_back();
 
-    for( const POLYGON& poly : aShape.m_polys )
-    {
-        for( size_t i = 0; i < poly.size(); i++ )
-        {
-            paths.push_back( poly[i].convertToClipper2( i == 0, zValues, arcBuffer ) );
-        }
-    }
+                        poly[i].convertToClipper2( i == 0, zValues, arcBuffer, aPaths[count++] );
+                    }
+                }
 
-    for( const POLYGON& poly : aOtherShape.m_polys )
-    {
-        for( size_t i = 0; i < poly.size(); i++ )
-        {
-            clips.push_back( poly[i].convertToClipper2( i == 0, zValues, arcBuffer ) );
-        }
-    }
+                aPaths.resize( count );
+            };
+
+    convertPaths( aShape, paths );
+    convertPaths( aOtherShape, clips );
 
     c.AddSubject( paths );
     c.AddClip( clips );
@@ -942,10 +952,6 @@ void SHAPE_POLY_SET::booleanOp( Clipper2Lib::ClipType aType, const SHAPE_POLY_SE
                 size_t z_value_ptr = zValues.size();
                 zValues.push_back( newZval );
 
-                // Only worry about arc segments for later processing
-                if( newZval.m_FirstArcIdx != -1 )
-                    newIntersectPoints.insert( { VECTOR2I( pt.x, pt.y ), newZval } );
-
                 pt.z = z_value_ptr;
                 //@todo amend X,Y values to true intersection between arcs or arc and segment
             };
@@ -956,6 +962,17 @@ void SHAPE_POLY_SET::booleanOp( Clipper2Lib::ClipType aType, const SHAPE_POLY_SE
 
     importTree( solution, zValues, arcBuffer );
     solution.Clear(); // Free used memory (not done in dtor)
+
+    // Don't let one huge operation pin its buffers for the life of the thread
+    static const size_t MAX_RETAINED_POINTS = 1 << 20;
+
+    if( zValues.capacity() > MAX_RETAINED_POINTS )
+    {
+        zValues = std::vector<CLIPPER_Z_VALUE>();
+        arcBuffer = std::vector<SHAPE_ARC>();
+        paths = Clipper2Lib::Paths64();
+        clips = Clipper2Lib::Paths64();
+    }
 }
 
 
@@ -20,6 +20,7 @@
 #ifndef KIPLATFORM_IO_H_
 #define KIPLATFORM_IO_H_
 
+#include <stddef.h>
 #include <stdio.h>
 
 class wxString;
@@ -50,6 +51,21 @@ namespace IO
     * @return true if the file attribut is set.
     */
     bool IsFileHidden( const wxString& aFileName );
+
+    /**
+     * Map a file read-only into memory.
+     *
+     * @param aPath is the file to map.
+     * @param aSize is set to the size of the file.
+     * @return the start of the mapped file, or nullptr if it could not be mapped (this includes
+     *         empty files).  The mapping has to be released with UnmapFile().
+     */
+    const char* MapFile( const wxString& aPath, size_t& aSize );
+
+    /**
+     * Release a mapping obtained from MapFile().
+     */
+    void UnmapFile( const char* aData, size_t aSize );
 } // namespace IO
 } // namespace KIPLATFORM
 
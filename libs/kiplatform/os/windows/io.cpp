@@ -123,4 +123,47 @@ bool KIPLATFORM::IO::IsFileHidden( const wxString& aFileName )
         result = true;
 
     return result;
-}
\ No newline at end of file
+}
+
+const char* KIPLATFORM::IO::MapFile( const wxString& aPath, size_t& aSize )
+{
+    aSize = 0;
+
+    HANDLE hFile = CreateFileW( aPath.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+    if( hFile == INVALID_HANDLE_VALUE )
+        return nullptr;
+
+    LARGE_INTEGER fileSize;
+
+    if( !GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart == 0
+            || (ULONGLONG) fileSize.QuadPart > (ULONGLONG) SIZE_MAX )
+    {
+        CloseHandle( hFile );
+        return nullptr;
+    }
+
+    HANDLE hMapping = CreateFileMappingW( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+
+    // The view keeps the mapping and the file open, so the handles can go now
+    CloseHandle( hFile );
+
+    if( !hMapping )
+        return nullptr;
+
+    const char* data = static_cast<const char*>( MapViewOfFile( hMapping, FILE_MAP_READ,
+                                                                0, 0, 0 ) );
+    CloseHandle( hMapping );
+
+    if( data )
+        aSize = (size_t) fileSize.QuadPart;
+
+    return data;
+}
+
+void KIPLATFORM::IO::UnmapFile( const char* aData, size_t aSize )
+{
+    if( aData )
+        UnmapViewOfFile( aData );
+}
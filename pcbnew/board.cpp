@@ -92,6 +92,8 @@ BOARD::BOARD() :
 
     m_DRCMaxClearance = 0;
     m_DRCMaxPhysicalClearance = 0;
+    m_DRCDirtyOverflow = false;
+    m_DRCTrackChanges = false;
 
     // we have not loaded a board yet, assume latest until then.
     m_fileFormatVersionAtLoad = LEGACY_BOARD_FILE_VERSION;
@@ -290,6 +292,112 @@ void BOARD::IncrementTimeStamp()
 
         m_maxClearanceValue.reset();
     }
+
+    // The caches are gone, so there is nothing left to update incrementally
+    ClearDRCDirty();
+}
+
+
+/// Largest number of changed items an incremental DRC run updates the caches with
+static const size_t c_maxDRCDirtyItems = 10000;
+
+
+void BOARD::MarkDRCDirty( BOARD_ITEM* aItem, const BOARD_ITEM* aBefore, bool aRemoved )
+{
+    // Nothing to keep up to date until an incremental DRC run has built the caches
+    if( !m_DRCTrackChanges || !m_CopperItemRTreeCache || m_DRCDirtyOverflow )
+        return;
+
+    std::vector<BOARD_ITEM*> items = { aItem };
+
+    aItem->RunOnDescendants(
+            [&]( BOARD_ITEM* child )
+            {
+                items.push_back( child );
+            } );
+
+    BOX2I oldBBox = aBefore ? aBefore->GetBoundingBox() : aItem->GetBoundingBox();
+
+    if( aBefore )
+    {
+        size_t beforeCount = 1;
+
+        aBefore->RunOnDescendants(
+                [&]( BOARD_ITEM* child )
+                {
+                    beforeCount++;
+                    m_DRCDirtyLayers |= child->GetLayerSet();
+                } );
+
+        // Children were added or removed as part of the modification.  The stale ones have
+        // already been deleted, so we can't find them in the caches.
+        if( beforeCount != items.size() )
+        {
+            m_DRCDirtyOverflow = true;
+            return;
+        }
+
+        m_DRCDirtyLayers |= aBefore->GetLayerSet();
+    }
+
+    for( BOARD_ITEM* item : items )
+    {
+        // Children of a modified parent are only known to lie within the parent's old bbox
+        if( aBefore || aRemoved )
+            m_DRCStaleItems.emplace_back( item, aBefore ? oldBBox : item->GetBoundingBox() );
+
+        m_DRCDirtyLayers |= item->GetLayerSet();
+
+        // Holes pierce all copper layers, whatever their pads claim
+        if( item->HasHole() )
+            m_DRCDirtyLayers |= LSET::AllCuMask();
+
+        if( aRemoved )
+            m_DRCDirtyItems.erase( item );
+        else
+            m_DRCDirtyItems.insert( item );
+    }
+
+    // Past this point a full rebuild is cheaper than the update, so stop recording
+    if( m_DRCDirtyItems.size() + m_DRCStaleItems.size() > c_maxDRCDirtyItems )
+    {
+        ClearDRCDirty();
+        m_DRCDirtyOverflow = true;
+    }
+}
+
+
+void BOARD::InvalidateZoneKnockouts( BOARD_ITEM* aItem )
+{
+    std::unique_lock<std::shared_mutex> writeLock( m_CachesMutex );
+
+    if( m_ZoneKnockoutCache.empty() )
+        return;
+
+    m_ZoneKnockoutCache.erase( aItem->m_Uuid );
+
+    aItem->RunOnDescendants(
+            [&]( BOARD_ITEM* child )
+            {
+                m_ZoneKnockoutCache.erase( child->m_Uuid );
+            } );
+}
+
+
+void BOARD::ClearZoneKnockouts()
+{
+    std::unique_lock<std::shared_mutex> writeLock( m_CachesMutex );
+
+    m_ZoneKnockoutCache.clear();
+}
+
+
+void BOARD::ClearDRCDirty()
+{
+    m_DRCDirtyItems.clear();
+    m_DRCStaleItems.clear();
+    m_DRCDirtyLayers.reset();
+    m_DRCDirtyOverflow = false;
 }
 
 
@@ -40,6 +40,9 @@
 #include <tools/pcb_selection.h>
 #include <shared_mutex>
 #include <list>
+#include <map>
+#include <memory>
+#include <unordered_set>
 
 class BOARD_DESIGN_SETTINGS;
 class BOARD_CONNECTED_ITEM;
@@ -96,6 +99,27 @@ struct PTR_LAYER_CACHE_KEY
     }
 };
 
+/**
+ * Identifies one of the knockout polygons the zone filler builds for an item: its shape (or
+ * its hole) on a layer, grown by a clearance and approximated to a maximum error.
+ */
+struct ZONE_KNOCKOUT_KEY
+{
+    PCB_LAYER_ID Layer;
+    int          Clearance;
+    int          MaxError;
+    bool         Hole;
+
+    auto operator<=>( const ZONE_KNOCKOUT_KEY& other ) const = default;
+};
+
+struct ZONE_KNOCKOUTS
+{
+    size_t Fingerprint = 0; // of the item geometry the knockouts were built from
+
+    std::map<ZONE_KNOCKOUT_KEY, std::shared_ptr<const SHAPE_POLY_SET>> Knockouts;
+};
+
 struct PTR_PTR_LAYER_CACHE_KEY
 {
     BOARD_ITEM*  A;
@@ -311,6 +335,37 @@ public:
 
     int GetTimeStamp() const { return m_timeStamp; }
 
+    /**
+     * Record a committed change so that the next incremental DRC run can update its caches
+     * in place rather than rebuilding them.  Nothing is recorded unless the last DRC run was
+     * incremental (see m_DRCTrackChanges), and once too much has changed the record is dropped
+     * in favour of a full rebuild.
+     *
+     * @param aItem is the changed item.  If \a aRemoved it must not be dereferenced after
+     *              this call.
+     * @param aBefore is an image of \a aItem before it was modified (or nullptr).
+     * @param aRemoved indicates that \a aItem has been removed from the board.
+     */
+    void MarkDRCDirty( BOARD_ITEM* aItem, const BOARD_ITEM* aBefore, bool aRemoved );
+
+    /**
+     * Forget all changes recorded by MarkDRCDirty().  Called once the DRC caches are up to
+     * date.
+     */
+    void ClearDRCDirty();
+
+    /**
+     * Drop the cached zone knockouts of an item and all of its descendants.  Called by
+     * BOARD_COMMIT for every item it adds, removes or modifies.
+     */
+    void InvalidateZoneKnockouts( BOARD_ITEM* aItem );
+
+    /**
+     * Drop all cached zone knockouts.  Used where changes aren't itemized (undo, redo and
+     * reverted commits).
+     */
+    void ClearZoneKnockouts();
+
     /**
      * Find out if the board is being used to hold a single footprint for editing/viewing.
      *
@@ -1296,6 +1351,23 @@ public:
     ZONE*                 m_SolderMaskBridges;  // A container to build bridges on solder mask layers
     std::map<ZONE*, std::map<PCB_LAYER_ID, ISOLATED_ISLANDS>> m_ZoneIsolatedIslandsMap;
 
+    // ------------ Incremental DRC state -------------
+    std::unordered_set<BOARD_ITEM*>                  m_DRCDirtyItems;    // added or modified
+    std::vector<std::pair<const BOARD_ITEM*, BOX2I>> m_DRCStaleItems;    // old cache entries;
+                                                                         //   never dereferenced
+    LSET                                             m_DRCDirtyLayers;
+    bool                                             m_DRCDirtyOverflow; // too much changed to
+                                                                         //   track; rebuild
+    bool                                             m_DRCTrackChanges;  // set by incremental
+                                                                         //   DRC runs
+
+    // ------------ Zone fill caches -------------
+    // Knockout polygons of pads, tracks and vias, keyed by item UUID.  Unlike the caches above
+    // these survive IncrementTimeStamp().  Entries are checked against the item's geometry
+    // when they're used, and BOARD_COMMIT drops those of changed items.  Guarded by
+    // m_CachesMutex.
+    std::unordered_map<KIID, ZONE_KNOCKOUTS>         m_ZoneKnockoutCache;
+
 private:
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
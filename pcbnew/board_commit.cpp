@@ -155,6 +155,15 @@ void BOARD_COMMIT::dirtyIntersectingZones( BOARD_ITEM* item, int aChangeType )
 }
 
 
+/**
+ * Markers and net metadata never appear in the DRC caches.
+ */
+static bool isDRCTracked( const BOARD_ITEM* aItem )
+{
+    return aItem->Type() != PCB_MARKER_T && aItem->Type() != PCB_NETINFO_T;
+}
+
+
 void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
 {
     KIGFX::VIEW*        view = m_toolMgr->GetView();
@@ -293,6 +302,12 @@ void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
             if( boardItem->Type() == PCB_GROUP_T || boardItem->Type() == PCB_GENERATOR_T )
                 addedGroup = static_cast<PCB_GROUP*>( boardItem );
 
+            if( m_isBoardEditor && isDRCTracked( boardItem ) )
+                board->MarkDRCDirty( boardItem, nullptr, false );
+
+            if( m_isBoardEditor )
+                board->InvalidateZoneKnockouts( boardItem );
+
             if( m_isBoardEditor && autofillZones && boardItem->Type() != PCB_MARKER_T )
                 dirtyIntersectingZones( boardItem, changeType );
 
@@ -326,6 +341,12 @@ void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
             if( m_isBoardEditor && autofillZones && boardItem->Type() != PCB_MARKER_T )
                 dirtyIntersectingZones( boardItem, changeType );
 
+            if( m_isBoardEditor && isDRCTracked( boardItem ) )
+                board->MarkDRCDirty( boardItem, nullptr, true );
+
+            if( m_isBoardEditor )
+                board->InvalidateZoneKnockouts( boardItem );
+
             switch( boardItem->Type() )
             {
             case PCB_FIELD_T:
@@ -439,6 +460,12 @@ void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
                 dirtyIntersectingZones( boardItem, changeType );       // after
             }
 
+            if( m_isBoardEditor && isDRCTracked( boardItem ) )
+                board->MarkDRCDirty( boardItem, boardItemCopy, false );
+
+            if( m_isBoardEditor )
+                board->InvalidateZoneKnockouts( boardItem );
+
             if( view )
                 view->Update( boardItem );
 
@@ -596,6 +623,7 @@ void BOARD_COMMIT::Revert()
     std::shared_ptr<CONNECTIVITY_DATA> connectivity = board->GetConnectivity();
 
     board->IncrementTimeStamp();   // clear caches
+    board->ClearZoneKnockouts();
 
     std::vector<BOARD_ITEM*> bulkAddedItems;
     std::vector<BOARD_ITEM*> bulkRemovedItems;
@@ -31,6 +31,7 @@
 
 #include <connectivity/connectivity_algo.h>
 #include <progress_reporter.h>
+#include <advanced_config.h>
 #include <geometry/geometry_utils.h>
 #include <board_commit.h>
 #include <core/thread_pool.h>
@@ -43,6 +44,21 @@
 #endif
 
 
+static const std::vector<KICAD_T> withoutZones = { PCB_TRACE_T,
+                                                   PCB_ARC_T,
+                                                   PCB_PAD_T,
+                                                   PCB_VIA_T,
+                                                   PCB_FOOTPRINT_T,
+                                                   PCB_SHAPE_T };
+static const std::vector<KICAD_T> withZones = { PCB_TRACE_T,
+                                                PCB_ARC_T,
+                                                PCB_PAD_T,
+                                                PCB_VIA_T,
+                                                PCB_ZONE_T,
+                                                PCB_FOOTPRINT_T,
+                                                PCB_SHAPE_T };
+
+
 bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 {
     markItemNetAsDirty( aItem );
@@ -226,11 +242,46 @@ void CN_CONNECTIVITY_ALGO::RemoveInvalidRefs()
 }
 
 
+void CN_CONNECTIVITY_ALGO::collectChangedItems()
+{
+    for( CN_ITEM* item : m_itemList )
+    {
+        if( !item->Valid() )
+        {
+            // A removed item may have been holding its cluster together
+            m_changedItems.erase( item );
+
+            for( CN_ITEM* neighbour : item->ConnectedItems() )
+            {
+                if( neighbour->Valid() )
+                    m_changedItems.insert( neighbour );
+            }
+        }
+        else if( item->Dirty() )
+        {
+            m_changedItems.insert( item );
+        }
+    }
+
+    // Past a point, searching from the changed items costs more than searching everything
+    if( m_changedItems.size() > (size_t) m_itemList.Size() / 4 )
+    {
+        m_changedItems.clear();
+        m_propagateAll = true;
+    }
+}
+
+
 void CN_CONNECTIVITY_ALGO::searchConnections()
 {
 #ifdef PROFILE
     PROF_TIMER garbage_collection( "garbage-collection" );
 #endif
+
+    // This has to be done before the references to removed items are dropped
+    if( !m_propagateAll && ADVANCED_CFG::GetCfg().m_IncrementalNetPropagation )
+        collectChangedItems();
+
     std::vector<CN_ITEM*> garbage;
     garbage.reserve( 1024 );
 
@@ -317,20 +368,6 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode )
 {
-    static const std::vector<KICAD_T> withoutZones = { PCB_TRACE_T,
-                                                       PCB_ARC_T,
-                                                       PCB_PAD_T,
-                                                       PCB_VIA_T,
-                                                       PCB_FOOTPRINT_T,
-                                                       PCB_SHAPE_T };
-    static const std::vector<KICAD_T> withZones = { PCB_TRACE_T,
-                                                    PCB_ARC_T,
-                                                    PCB_PAD_T,
-                                                    PCB_VIA_T,
-                                                    PCB_ZONE_T,
-                                                    PCB_FOOTPRINT_T,
-                                                    PCB_SHAPE_T };
-
     return SearchClusters( aMode, aMode == CSM_PROPAGATE ? withoutZones : withZones, -1 );
 }
 
@@ -338,6 +375,19 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 const CN_CONNECTIVITY_ALGO::CLUSTERS
 CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode, const std::vector<KICAD_T>& aTypes,
                                       int aSingleNet, CN_ITEM* rootItem )
+{
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    return searchClusters( aMode, aTypes, aSingleNet, rootItem,
+                           std::vector<CN_ITEM*>( m_itemList.begin(), m_itemList.end() ) );
+}
+
+
+const CN_CONNECTIVITY_ALGO::CLUSTERS
+CN_CONNECTIVITY_ALGO::searchClusters( CLUSTER_SEARCH_MODE aMode, const std::vector<KICAD_T>& aTypes,
+                                      int aSingleNet, CN_ITEM* rootItem,
+                                      const std::vector<CN_ITEM*>& aItems )
 {
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
@@ -346,9 +396,6 @@ CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode, const std::vect
 
     CLUSTERS clusters;
 
-    if( m_itemList.IsDirty() )
-        searchConnections();
-
     auto addToSearchList =
             [&item_set, withinAnyNet, aSingleNet, &aTypes, rootItem ]( CN_ITEM *aItem )
             {
@@ -380,7 +427,7 @@ CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode, const std::vect
                 item_set.insert( aItem );
             };
 
-    std::for_each( m_itemList.begin(), m_itemList.end(), addToSearchList );
+    std::for_each( aItems.begin(), aItems.end(), addToSearchList );
 
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return CLUSTERS();
@@ -657,7 +704,55 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
 
 void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit )
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    if( !m_propagateAll && ADVANCED_CFG::GetCfg().m_IncrementalNetPropagation )
+    {
+        // Only the clusters holding a changed item can have nets to propagate.  Collect them
+        // the way the cluster search will walk them: zones are left out of the search, but
+        // it will still cross the ones it hasn't visited yet.
+        std::vector<CN_ITEM*>        items;
+        std::vector<CN_ITEM*>        stack( m_changedItems.begin(), m_changedItems.end() );
+        std::unordered_set<CN_ITEM*> reached( m_changedItems.begin(), m_changedItems.end() );
+
+        while( !stack.empty() )
+        {
+            CN_ITEM* item = stack.back();
+            stack.pop_back();
+
+            if( !item->Valid() )
+                continue;
+
+            if( item->Parent()->Type() != PCB_ZONE_T )
+                items.push_back( item );
+
+            for( CN_ITEM* neighbour : item->ConnectedItems() )
+            {
+                if( !neighbour->Valid() || reached.count( neighbour ) )
+                    continue;
+
+                if( neighbour->Parent()->Type() == PCB_ZONE_T && neighbour->Visited() )
+                    continue;
+
+                reached.insert( neighbour );
+                stack.push_back( neighbour );
+            }
+        }
+
+        m_connClusters = searchClusters( CSM_PROPAGATE, withoutZones, -1, nullptr, items );
+    }
+    else
+    {
+        m_connClusters = SearchClusters( CSM_PROPAGATE );
+    }
+
+    if( !m_progressReporter || !m_progressReporter->IsCancelled() )
+    {
+        m_changedItems.clear();
+        m_propagateAll = false;
+    }
+
     propagateConnections( aCommit );
 }
 
@@ -721,7 +816,22 @@ void CN_CONNECTIVITY_ALGO::FillIsolatedIslandsMap(
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    // Ratsnest clusters never span nets, so searching the items of the dirty nets gives the
+    // same clusters for those nets as searching everything.
+    std::vector<CN_ITEM*> items;
+
+    for( CN_ITEM* item : m_itemList )
+    {
+        int net = item->Net();
+
+        if( net >= 0 && net < (int) m_dirtyNets.size() && m_dirtyNets[net] )
+            items.push_back( item );
+    }
+
+    m_ratsnestClusters = searchClusters( CSM_RATSNEST, withZones, -1, nullptr, items );
     return m_ratsnestClusters;
 }
 
@@ -949,6 +1059,8 @@ void CN_CONNECTIVITY_ALGO::Clear()
 {
     m_ratsnestClusters.clear();
     m_connClusters.clear();
+    m_changedItems.clear();
+    m_propagateAll = true;
     m_itemMap.clear();
     m_itemList.Clear();
 
@@ -42,6 +42,7 @@
 #include <functional>
 #include <vector>
 #include <deque>
+#include <unordered_set>
 
 #include <connectivity/connectivity_rtree.h>
 #include <connectivity/connectivity_data.h>
@@ -81,13 +82,13 @@ public:
      * @param aOther the other edge to compare.
      * @return true if our weight is smaller than the other weight.
      */
-    bool operator<( CN_EDGE aOther ) const
+    bool operator<( const CN_EDGE& aOther ) const
     {
         return m_weight < aOther.m_weight;
     }
 
-    std::shared_ptr<const CN_ANCHOR> GetSourceNode() const { return m_source; }
-    std::shared_ptr<const CN_ANCHOR> GetTargetNode() const { return m_target; }
+    const std::shared_ptr<const CN_ANCHOR>& GetSourceNode() const { return m_source; }
+    const std::shared_ptr<const CN_ANCHOR>& GetTargetNode() const { return m_target; }
 
     void SetSourceNode( const std::shared_ptr<const CN_ANCHOR>& aNode ) { m_source = aNode; }
     void SetTargetNode( const std::shared_ptr<const CN_ANCHOR>& aNode ) { m_target = aNode; }
@@ -169,6 +170,7 @@ public:
 
     CN_CONNECTIVITY_ALGO( CONNECTIVITY_DATA* aParentConnectivityData ) :
             m_parentConnectivityData( aParentConnectivityData ),
+            m_propagateAll( true ),
             m_isLocal( false )
     {}
 
@@ -242,6 +244,9 @@ public:
     void FillIsolatedIslandsMap( std::map<ZONE*, std::map<PCB_LAYER_ID, ISOLATED_ISLANDS>>& aMap,
                                  bool aConnectivityAlreadyRebuilt );
 
+    /**
+     * Return the ratsnest clusters of the nets marked as dirty.
+     */
     const CLUSTERS& GetClusters();
 
     const CN_LIST& ItemList() const
@@ -274,6 +279,16 @@ public:
 private:
     void searchConnections();
 
+    const CLUSTERS searchClusters( CLUSTER_SEARCH_MODE aMode, const std::vector<KICAD_T>& aTypes,
+                                   int aSingleNet, CN_ITEM* rootItem,
+                                   const std::vector<CN_ITEM*>& aItems );
+
+    /**
+     * Record the items whose clusters may have changed since the last net propagation: items
+     * added since then, and the neighbours of items removed since then.
+     */
+    void collectChangedItems();
+
     void propagateConnections( BOARD_COMMIT* aCommit = nullptr );
 
     template <class Container, class BItem>
@@ -295,6 +310,12 @@ private:
     std::vector<std::shared_ptr<CN_CLUSTER>>              m_ratsnestClusters;
     std::vector<bool>                                     m_dirtyNets;
 
+    ///< Items whose clusters may have changed since the last net propagation
+    std::unordered_set<CN_ITEM*>                          m_changedItems;
+
+    ///< Propagate nets over all clusters rather than over those of m_changedItems
+    bool                                                  m_propagateAll;
+
     bool                                                  m_isLocal;
     std::shared_ptr<CONNECTIVITY_DATA>                    m_globalConnectivityData;
 
@@ -44,6 +44,10 @@
 #include <trigo.h>
 #include <drc/drc_rtree.h>
 
+/// Number of nodes (or edges) handed to each ratsnest update task.
+static const size_t c_ratsnestBatchSize = 512;
+
+
 CONNECTIVITY_DATA::CONNECTIVITY_DATA() :
         m_skipRatsnestUpdate( false )
 {
@@ -184,22 +188,84 @@ void CONNECTIVITY_DATA::updateRatsnest()
                 return aNet->IsDirty() && aNet->GetNodeCount() > 0;
             } );
 
+    // A few large nets (ground, power) usually dominate the run time, while thousands of
+    // two-pin nets cost almost nothing.  Queue the largest nets first so that they aren't the
+    // last ones to start, and batch the small ones so that the task overhead is paid once per
+    // batch rather than once per net.  Idle threads pick up the next batch from the queue.
+    std::sort( dirty_nets.begin(), dirty_nets.end(),
+               []( const RN_NET* a, const RN_NET* b )
+               {
+                   return a->GetNodeCount() > b->GetNodeCount();
+               } );
+
     thread_pool& tp = GetKiCadThreadPool();
+    size_t       batchStart = 0;
+    size_t       batchSize = 0;
+
+    for( size_t ii = 0; ii < dirty_nets.size(); ++ii )
+    {
+        batchSize += dirty_nets[ii]->GetNodeCount();
+
+        if( batchSize >= c_ratsnestBatchSize || ii + 1 == dirty_nets.size() )
+        {
+            tp.push_task( [&dirty_nets, batchStart, ii]()
+                          {
+                              for( size_t jj = batchStart; jj <= ii; ++jj )
+                                  dirty_nets[jj]->UpdateNet();
+                          } );
+
+            batchStart = ii + 1;
+            batchSize = 0;
+        }
+    }
 
-    tp.push_loop( dirty_nets.size(),
-            [&]( const int a, const int b )
-            {
-                for( int ii = a; ii < b; ++ii )
-                    dirty_nets[ii]->UpdateNet();
-            } );
     tp.wait_for_tasks();
 
-    tp.push_loop( dirty_nets.size(),
-            [&]( const int a, const int b )
+    // Edges are optimized independently of each other, so the edges of large nets are split
+    // across several tasks and those of small nets are batched together.
+    struct EDGE_RANGE
+    {
+        RN_NET* net;
+        size_t  first;
+        size_t  last;
+    };
+
+    std::vector<EDGE_RANGE> batch;
+
+    batchSize = 0;
+
+    auto pushBatch =
+            [&]()
             {
-                for( int ii = a; ii < b; ++ii )
-                    dirty_nets[ii]->OptimizeRNEdges();
-            } );
+                tp.push_task( [ranges = std::move( batch )]()
+                              {
+                                  for( const EDGE_RANGE& range : ranges )
+                                      range.net->OptimizeRNEdges( range.first, range.last );
+                              } );
+
+                batch.clear();
+                batchSize = 0;
+            };
+
+    for( RN_NET* net : dirty_nets )
+    {
+        size_t edgeCount = net->GetEdges().size();
+
+        for( size_t first = 0; first < edgeCount; first += c_ratsnestBatchSize )
+        {
+            size_t last = std::min( edgeCount, first + c_ratsnestBatchSize );
+
+            batch.push_back( { net, first, last } );
+            batchSize += last - first;
+
+            if( batchSize >= c_ratsnestBatchSize )
+                pushBatch();
+        }
+    }
+
+    if( !batch.empty() )
+        pushBatch();
+
     tp.wait_for_tasks();
 
 #ifdef PROFILE
@@ -317,7 +317,21 @@ void DIALOG_DRC::OnRunDRCClick( wxCommandEvent& aEvent )
     m_cancelled = false;
 
     m_frame->GetBoard()->RecordDRCExclusions();
-    deleteAllMarkers( true );
+
+    if( drcTool->GetDRCEngine()->GetIncrementalMode() )
+    {
+        // The DRC tool replaces only the markers of the providers it re-runs, so just let go
+        // of them here
+        m_frame->GetToolManager()->RunAction( PCB_ACTIONS::selectionClear );
+
+        m_markersTreeModel->DeleteItems( false, true, false );
+        m_unconnectedTreeModel->DeleteItems( false, true, false );
+        m_fpWarningsTreeModel->DeleteItems( false, true, false );
+    }
+    else
+    {
+        deleteAllMarkers( true );
+    }
 
     std::vector<std::reference_wrapper<RC_ITEM>> violations = DRC_ITEM::GetItemsWithSeverities();
     m_ignoredList->DeleteAllItems();
@@ -26,64 +26,262 @@
 #include <footprint.h>
 #include <core/thread_pool.h>
 #include <zone.h>
+#include <eda_text.h>
 #include <connectivity/connectivity_data.h>
 #include <drc/drc_engine.h>
 #include <drc/drc_rtree.h>
 #include <drc/drc_cache_generator.h>
+#include <bitset>
 #include <mutex>
+#include <unordered_set>
 
-bool DRC_CACHE_GENERATOR::Run()
+static const std::vector<KICAD_T> s_copperTreeTypes = {
+    PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T,
+    PCB_PAD_T,
+    PCB_SHAPE_T,
+    PCB_FIELD_T, PCB_TEXT_T, PCB_TEXTBOX_T,
+    PCB_DIMENSION_T
+};
+
+
+/**
+ * Text bounding boxes and outline font glyphs are cached lazily, and without locking, by whoever
+ * first asks for a text's shape.  Building them up front, whatever the font, means providers
+ * running concurrently only ever read them.
+ */
+static void primeTextShape( BOARD_ITEM* aItem )
 {
-    m_board = m_drcEngine->GetBoard();
+    if( EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( aItem ) )
+        text->BuildShapeCaches();
+}
 
-    int&           largestClearance = m_board->m_DRCMaxClearance;
-    int&           largestPhysicalClearance = m_board->m_DRCMaxPhysicalClearance;
-    DRC_CONSTRAINT worstConstraint;
-    LSET           boardCopperLayers = LSET::AllCuMask( m_board->GetCopperLayerCount() );
-    thread_pool&   tp = GetKiCadThreadPool();
 
+std::set<ZONE*> DRC_CACHE_GENERATOR::collectZones()
+{
+    LSET            boardCopperLayers = LSET::AllCuMask( m_board->GetCopperLayerCount() );
+    std::set<ZONE*> allZones;
 
-    largestClearance = std::max( largestClearance, m_board->GetMaxClearanceValue() );
+    m_board->m_DRCZones.clear();
+    m_board->m_DRCCopperZones.clear();
 
-    if( m_drcEngine->QueryWorstConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, worstConstraint ) )
-        largestPhysicalClearance = worstConstraint.GetValue().Min();
+    auto addZone =
+            [&]( ZONE* zone )
+            {
+                allZones.insert( zone );
 
-    if( m_drcEngine->QueryWorstConstraint( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT, worstConstraint ) )
-        largestPhysicalClearance = std::max( largestPhysicalClearance, worstConstraint.GetValue().Min() );
+                if( !zone->GetIsRuleArea() )
+                {
+                    m_board->m_DRCZones.push_back( zone );
 
-    std::set<ZONE*> allZones;
+                    if( ( zone->GetLayerSet() & boardCopperLayers ).any() )
+                        m_board->m_DRCCopperZones.push_back( zone );
+                }
+            };
 
     for( ZONE* zone : m_board->Zones() )
+        addZone( zone );
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
     {
-        allZones.insert( zone );
+        for( ZONE* zone : footprint->Zones() )
+            addZone( zone );
+    }
 
-        if( !zone->GetIsRuleArea() )
-        {
-            m_board->m_DRCZones.push_back( zone );
+    return allZones;
+}
 
-            if( ( zone->GetLayerSet() & boardCopperLayers ).any() )
+
+void DRC_CACHE_GENERATOR::insertCopperItem( BOARD_ITEM* aItem, const LSET& aBoardCopperLayers,
+                                            int aLargestClearance )
+{
+    LSET copperLayers = aItem->GetLayerSet() & aBoardCopperLayers;
+
+    // Special-case pad holes which pierce all the copper layers
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        PAD* pad = static_cast<PAD*>( aItem );
+
+        if( pad->HasHole() )
+            copperLayers = aBoardCopperLayers;
+    }
+
+    copperLayers.RunOnLayers(
+            [&]( PCB_LAYER_ID layer )
             {
-                m_board->m_DRCCopperZones.push_back( zone );
-            }
+                m_board->m_CopperItemRTreeCache->Insert( aItem, layer, aLargestClearance );
+            } );
+}
+
+
+void DRC_CACHE_GENERATOR::cacheZone( ZONE* aZone )
+{
+    aZone->CacheBoundingBox();
+    aZone->CacheTriangulation();
+
+    if( !aZone->GetIsRuleArea() && aZone->IsOnCopperLayer() )
+    {
+        std::unique_ptr<DRC_RTREE> rtree = std::make_unique<DRC_RTREE>();
+
+        rtree->StartBulkLoad();
+
+        aZone->GetLayerSet().RunOnLayers(
+                [&]( PCB_LAYER_ID layer )
+                {
+                    if( IsCopperLayer( layer ) )
+                        rtree->Insert( aZone, layer );
+                } );
+
+        rtree->FinishBulkLoad();
+
+        std::unique_lock<std::shared_mutex> writeLock( m_board->m_CachesMutex );
+        m_board->m_CopperZoneRTreeCache[ aZone ] = std::move( rtree );
+    }
+}
+
+
+bool DRC_CACHE_GENERATOR::updateCaches()
+{
+    LSET boardCopperLayers = LSET::AllCuMask( m_board->GetCopperLayerCount() );
+    int  largestClearance = m_board->m_DRCMaxClearance;
+
+    if( !reportPhase( _( "Updating copper items..." ) ) )
+        return false;   // DRC cancelled
+
+    std::set<ZONE*> allZones = collectZones();
+
+    {
+        std::unique_lock<std::shared_mutex> writeLock( m_board->m_CachesMutex );
+
+        // These are keyed on item pairs and cheap to regenerate lazily
+        m_board->m_IntersectsAreaCache.clear();
+        m_board->m_EnclosedByAreaCache.clear();
+        m_board->m_IntersectsCourtyardCache.clear();
+        m_board->m_IntersectsFCourtyardCache.clear();
+        m_board->m_IntersectsBCourtyardCache.clear();
+        m_board->m_ZoneBBoxCache.clear();
+
+        std::unordered_set<const BOARD_ITEM*> stale;
+
+        for( const auto& [ item, bbox ] : m_board->m_DRCStaleItems )
+        {
+            // Stale items may have been deleted; only their addresses are used here.
+            BOX2I searchBox = bbox;
+            searchBox.Inflate( largestClearance );
+
+            m_board->m_CopperItemRTreeCache->Remove( item, searchBox );
+            stale.insert( item );
+        }
+
+        for( auto it = m_board->m_CopperZoneRTreeCache.begin();
+             it != m_board->m_CopperZoneRTreeCache.end(); )
+        {
+            if( stale.count( static_cast<BOARD_ITEM*>( it->first ) ) )
+                it = m_board->m_CopperZoneRTreeCache.erase( it );
+            else
+                ++it;
         }
     }
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+    std::bitset<MAX_STRUCT_TYPE_ID> copperTreeTypes;
+
+    for( KICAD_T type : s_copperTreeTypes )
+        copperTreeTypes[ type ] = true;
+
+    for( BOARD_ITEM* item : m_board->m_DRCDirtyItems )
     {
-        for( ZONE* zone : footprint->Zones() )
+        if( m_drcEngine->IsCancelled() )
+            return false;
+
+        if( item->Type() == PCB_ZONE_T )
+        {
+            cacheZone( static_cast<ZONE*>( item ) );
+        }
+        else if( item->Type() == PCB_FOOTPRINT_T )
+        {
+            static_cast<FOOTPRINT*>( item )->BuildCourtyardCaches();
+        }
+        else if( copperTreeTypes[ BaseType( item->Type() ) ] )
         {
-            allZones.insert( zone );
+            if( m_cacheDependencies & DRC_CACHE_TEXT_SHAPES )
+                primeTextShape( item );
 
-            if( !zone->GetIsRuleArea() )
-            {
-                m_board->m_DRCZones.push_back( zone );
+            bool hasHole = item->Type() == PCB_PAD_T && static_cast<PAD*>( item )->HasHole();
 
-                if( ( zone->GetLayerSet() & boardCopperLayers ).any() )
-                    m_board->m_DRCCopperZones.push_back( zone );
-            }
+            if( hasHole || ( item->GetLayerSet() & LSET::AllCuMask() ).any() )
+                insertCopperItem( item, boardCopperLayers, largestClearance );
         }
     }
 
+    // Pick up any copper zones which weren't cached last time round
+    for( ZONE* zone : m_board->m_DRCCopperZones )
+    {
+        if( !m_board->m_CopperZoneRTreeCache.count( zone ) )
+            cacheZone( zone );
+    }
+
+    for( ZONE* zone : allZones )
+        zone->CacheBoundingBox();
+
+    m_board->m_ZoneIsolatedIslandsMap.clear();
+
+    for( ZONE* zone : m_board->Zones() )
+    {
+        if( !zone->GetIsRuleArea() && !zone->IsTeardropArea() )
+        {
+            zone->GetLayerSet().RunOnLayers(
+                    [&]( PCB_LAYER_ID layer )
+                    {
+                        m_board->m_ZoneIsolatedIslandsMap[ zone ][ layer ] = ISOLATED_ISLANDS();
+                    } );
+        }
+    }
+
+    // Connectivity is kept up to date by BOARD_COMMIT itself
+    m_board->GetConnectivity()->FillIsolatedIslandsMap( m_board->m_ZoneIsolatedIslandsMap, true );
+
+    m_board->ClearDRCDirty();
+
+    return !m_drcEngine->IsCancelled();
+}
+
+
+bool DRC_CACHE_GENERATOR::Run()
+{
+    m_board = m_drcEngine->GetBoard();
+
+    if( m_incremental )
+    {
+        // Copper tree entries were inflated by the old worst-case clearance, so if that has
+        // grown (or the caches have been thrown away) we have to start again.
+        m_board->m_maxClearanceValue.reset();
+
+        if( m_board->m_CopperItemRTreeCache && !m_board->m_DRCDirtyOverflow
+                && m_board->GetMaxClearanceValue() <= m_board->m_DRCMaxClearance )
+        {
+            return updateCaches();
+        }
+
+        m_incremental = false;
+        m_board->IncrementTimeStamp();
+    }
+
+    int&           largestClearance = m_board->m_DRCMaxClearance;
+    int&           largestPhysicalClearance = m_board->m_DRCMaxPhysicalClearance;
+    DRC_CONSTRAINT worstConstraint;
+    LSET           boardCopperLayers = LSET::AllCuMask( m_board->GetCopperLayerCount() );
+    thread_pool&   tp = GetKiCadThreadPool();
+
+
+    largestClearance = std::max( largestClearance, m_board->GetMaxClearanceValue() );
+
+    if( m_drcEngine->QueryWorstConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, worstConstraint ) )
+        largestPhysicalClearance = worstConstraint.GetValue().Min();
+
+    if( m_drcEngine->QueryWorstConstraint( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT, worstConstraint ) )
+        largestPhysicalClearance = std::max( largestPhysicalClearance, worstConstraint.GetValue().Min() );
+
+    std::set<ZONE*> allZones = collectZones();
+
     size_t              count = 0;
     std::atomic<size_t> done( 1 );
 
@@ -100,22 +298,7 @@ bool DRC_CACHE_GENERATOR::Run()
                 if( m_drcEngine->IsCancelled() )
                     return false;
 
-                LSET copperLayers = item->GetLayerSet() & boardCopperLayers;
-
-                // Special-case pad holes which pierce all the copper layers
-                if( item->Type() == PCB_PAD_T )
-                {
-                    PAD* pad = static_cast<PAD*>( item );
-
-                    if( pad->HasHole() )
-                        copperLayers = boardCopperLayers;
-                }
-
-                copperLayers.RunOnLayers(
-                        [&]( PCB_LAYER_ID layer )
-                        {
-                            m_board->m_CopperItemRTreeCache->Insert( item, layer, largestClearance );
-                        } );
+                insertCopperItem( item, boardCopperLayers, largestClearance );
 
                 done.fetch_add( 1 );
                 return true;
@@ -124,15 +307,7 @@ bool DRC_CACHE_GENERATOR::Run()
     if( !reportPhase( _( "Gathering copper items..." ) ) )
         return false;   // DRC cancelled
 
-    static const std::vector<KICAD_T> itemTypes = {
-        PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T,
-        PCB_PAD_T,
-        PCB_SHAPE_T,
-        PCB_FIELD_T, PCB_TEXT_T, PCB_TEXTBOX_T,
-        PCB_DIMENSION_T
-    };
-
-    forEachGeometryItem( itemTypes, LSET::AllCuMask(), countItems );
+    forEachGeometryItem( s_copperTreeTypes, LSET::AllCuMask(), countItems );
 
     std::future<void> retn = tp.submit(
             [&]()
@@ -142,7 +317,9 @@ bool DRC_CACHE_GENERATOR::Run()
                 if( !m_board->m_CopperItemRTreeCache )
                     m_board->m_CopperItemRTreeCache = std::make_shared<DRC_RTREE>();
 
-                forEachGeometryItem( itemTypes, LSET::AllCuMask(), addToCopperTree );
+                m_board->m_CopperItemRTreeCache->StartBulkLoad();
+
+                forEachGeometryItem( s_copperTreeTypes, LSET::AllCuMask(), addToCopperTree );
             } );
 
     std::future_status status = retn.wait_for( std::chrono::milliseconds( 250 ) );
@@ -153,6 +330,26 @@ bool DRC_CACHE_GENERATOR::Run()
         status = retn.wait_for( std::chrono::milliseconds( 250 ) );
     }
 
+    {
+        // The layers are packed on the pool, so this must be done from outside of it
+        std::unique_lock<std::shared_mutex> writeLock( m_board->m_CachesMutex );
+        m_board->m_CopperItemRTreeCache->FinishBulkLoad( &tp );
+    }
+
+    if( m_cacheDependencies & DRC_CACHE_TEXT_SHAPES )
+    {
+        static const std::vector<KICAD_T> textTypes = {
+            PCB_FIELD_T, PCB_TEXT_T, PCB_TEXTBOX_T, PCB_DIMENSION_T
+        };
+
+        forEachGeometryItem( textTypes, LSET::AllLayersMask(),
+                [&]( BOARD_ITEM* item ) -> bool
+                {
+                    primeTextShape( item );
+                    return !m_drcEngine->IsCancelled();
+                } );
+    }
+
     if( !reportPhase( _( "Tessellating copper zones..." ) ) )
         return false;   // DRC cancelled
 
@@ -172,27 +369,10 @@ bool DRC_CACHE_GENERATOR::Run()
                 if( m_drcEngine->IsCancelled() )
                     return 0;
 
-                aZone->CacheBoundingBox();
-                aZone->CacheTriangulation();
+                cacheZone( aZone );
 
                 if( !aZone->GetIsRuleArea() && aZone->IsOnCopperLayer() )
-                {
-                   std::unique_ptr<DRC_RTREE> rtree = std::make_unique<DRC_RTREE>();
-
-                   aZone->GetLayerSet().RunOnLayers(
-                           [&]( PCB_LAYER_ID layer )
-                           {
-                               if( IsCopperLayer( layer ) )
-                                   rtree->Insert( aZone, layer );
-                           } );
-
-                   {
-                       std::unique_lock<std::shared_mutex> writeLock( m_board->m_CachesMutex );
-                       m_board->m_CopperZoneRTreeCache[ aZone ] = std::move( rtree );
-                   }
-
-                   done.fetch_add( 1 );
-                }
+                    done.fetch_add( 1 );
 
                 return 1;
             };
@@ -233,6 +413,8 @@ bool DRC_CACHE_GENERATOR::Run()
     connectivity->Build( m_board, m_drcEngine->GetProgressReporter() );
     connectivity->FillIsolatedIslandsMap( m_board->m_ZoneIsolatedIslandsMap, true );
 
+    m_board->ClearDRCDirty();
+
     return !m_drcEngine->IsCancelled();
 }
 
@@ -34,7 +34,9 @@ class DRC_CACHE_GENERATOR : public DRC_TEST_PROVIDER_CLEARANCE_BASE
 {
 public:
     DRC_CACHE_GENERATOR() :
-            DRC_TEST_PROVIDER_CLEARANCE_BASE()
+            DRC_TEST_PROVIDER_CLEARANCE_BASE(),
+            m_cacheDependencies( DRC_CACHE_ALL ),
+            m_incremental( false )
     {
     }
 
@@ -42,7 +44,35 @@ public:
     {
     }
 
+    /**
+     * Set the DRC_CACHE_DEPENDENCY flags of the caches required by the providers about to be
+     * run.
+     */
+    void SetCacheDependencies( int aDependencies ) { m_cacheDependencies = aDependencies; }
+
+    /**
+     * Update the existing caches from the changes recorded by BOARD::MarkDRCDirty() rather
+     * than rebuilding them.  Falls back to a full rebuild if the caches can't be updated.
+     */
+    void SetIncremental( bool aIncremental ) { m_incremental = aIncremental; }
+
+    /**
+     * @return true if the last Run() updated the caches incrementally.
+     */
+    bool IsIncremental() const { return m_incremental; }
+
     virtual bool Run() override;
+
+private:
+    std::set<ZONE*> collectZones();
+    void insertCopperItem( BOARD_ITEM* aItem, const LSET& aBoardCopperLayers,
+                           int aLargestClearance );
+    void cacheZone( ZONE* aZone );
+    bool updateCaches();
+
+private:
+    int  m_cacheDependencies;
+    bool m_incremental;
 };
 
 
@@ -37,10 +37,14 @@
 #include <drc/drc_item.h>
 #include <drc/drc_cache_generator.h>
 #include <footprint.h>
+#include <netinfo.h>
 #include <pad.h>
 #include <pcb_track.h>
 #include <core/thread_pool.h>
 #include <zone.h>
+#include <advanced_config.h>
+#include <hash.h>
+#include <scoped_set_reset.h>
 
 
 // wxListBox's performance degrades horrifically with very large datasets.  It's not clear
@@ -49,6 +53,11 @@
 #define EXTENDED_ERROR_LIMIT 499
 
 
+// Set while a test provider is running as a thread pool task.  Progress reporters may only be
+// refreshed (and log reporters written to) from the thread which called RunTests().
+static thread_local bool s_inProviderTask = false;
+
+
 void drcPrintDebugMessage( int level, const wxString& msg, const char *function, int line )
 {
     wxString valueStr;
@@ -72,8 +81,15 @@ DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     m_rulesValid( false ),
     m_reportAllTrackErrors( false ),
     m_testFootprints( false ),
+    m_scheduledMode( ADVANCED_CFG::GetCfg().m_DRCConcurrentProviders ),
+    m_incrementalMode( false ),
+    m_rulesHash( 0 ),
+    m_lastRunHash( 0 ),
     m_reporter( nullptr ),
-    m_progressReporter( nullptr )
+    m_progressReporter( nullptr ),
+    m_constraintCacheTimestamp( -1 ),
+    m_constraintCacheHits( 0 ),
+    m_constraintCacheMisses( 0 )
 {
     m_errorLimits.resize( DRCE_LAST + 1 );
 
@@ -534,6 +550,41 @@ void DRC_ENGINE::compileRules()
             m_constraintMap[ constraint.m_Type ]->push_back( engineConstraint );
         }
     }
+
+    for( const auto& [ constraintType, ruleset ] : m_constraintMap )
+    {
+        CONSTRAINT_CACHE_POLICY policy = CONSTRAINT_CACHE_POLICY::BY_NETCLASS;
+
+        switch( constraintType )
+        {
+        case DISALLOW_CONSTRAINT:               // Tested against item flags and layers
+        case ASSERTION_CONSTRAINT:
+        case ZONE_CONNECTION_CONSTRAINT:        // Can be inherited from a pad's footprint
+        case THERMAL_RELIEF_GAP_CONSTRAINT:
+        case THERMAL_SPOKE_WIDTH_CONSTRAINT:
+            policy = CONSTRAINT_CACHE_POLICY::NONE;
+            break;
+
+        default:
+            break;
+        }
+
+        if( !ADVANCED_CFG::GetCfg().m_DRCConstraintCache )
+            policy = CONSTRAINT_CACHE_POLICY::NONE;
+
+        for( DRC_ENGINE_CONSTRAINT* c : *ruleset )
+        {
+            if( policy == CONSTRAINT_CACHE_POLICY::NONE || !c->condition )
+                continue;
+
+            if( !c->condition->IsCacheable() )
+                policy = CONSTRAINT_CACHE_POLICY::NONE;
+            else if( c->condition->DependsOnNet() )
+                policy = CONSTRAINT_CACHE_POLICY::BY_NET;
+        }
+
+        m_constraintCachePolicy[ constraintType ] = policy;
+    }
 }
 
 
@@ -559,8 +610,11 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
     }
 
     m_constraintMap.clear();
+    m_constraintCachePolicy.clear();
+    clearConstraintCache();
 
-    m_board->IncrementTimeStamp();  // Clear board-level caches
+    size_t previousRulesHash = m_rulesHash;
+    m_rulesHash = 0;
 
     try         // attempt to load full set of rules (implicit + user rules)
     {
@@ -580,9 +634,16 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
             wxFAIL_MSG( wxT( "Compiling implicit rules failed." ) );
         }
 
+        m_board->IncrementTimeStamp();  // Clear board-level caches
         throw original_parse_error;
     }
 
+    m_rulesHash = hashRules();
+
+    // Incremental runs can keep the board-level caches as long as the rules are the same
+    if( !m_incrementalMode || m_rulesHash != previousRulesHash )
+        m_board->IncrementTimeStamp();  // Clear board-level caches
+
     for( int ii = DRCE_FIRST; ii < DRCE_LAST; ++ii )
         m_errorLimits[ ii ] = ERROR_LIMIT;
 
@@ -590,10 +651,50 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
 }
 
 
+size_t DRC_ENGINE::hashRules() const
+{
+    size_t hash = hash_val( m_rules.size() );
+
+    for( const std::shared_ptr<DRC_RULE>& rule : m_rules )
+    {
+        hash_combine( hash, rule->m_Name, rule->m_LayerSource,
+                      static_cast<const BASE_SET&>( rule->m_LayerCondition ),
+                      static_cast<int>( rule->m_Severity ), rule->m_ImplicitItemId.Hash() );
+
+        if( rule->m_Condition )
+            hash_combine( hash, rule->m_Condition->GetExpression() );
+
+        for( const DRC_CONSTRAINT& constraint : rule->m_Constraints )
+        {
+            const MINOPTMAX<int>& value = constraint.GetValue();
+
+            hash_combine( hash, static_cast<int>( constraint.m_Type ), value.HasMin(), value.Min(),
+                          value.HasOpt(), value.Opt(), value.HasMax(), value.Max(),
+                          constraint.m_DisallowFlags,
+                          static_cast<int>( constraint.m_ZoneConnection ) );
+        }
+    }
+
+    return hash;
+}
+
+
 void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aTestFootprints )
 {
     SetUserUnits( aUnits );
 
+    // Everything other than the board which the results of a run depend on
+    size_t runHash = hash_val( m_rulesHash, aReportAllTrackErrors, aTestFootprints );
+
+    for( const auto& [ errorCode, severity ] : m_designSettings->m_DRCSeverities )
+        hash_combine( runHash, errorCode, static_cast<int>( severity ) );
+
+    // The last run's caches and results can only be reused if all the board changes since
+    // have been recorded.  The schematic parity tests depend on the schematic, which isn't
+    // tracked at all.
+    bool incremental = m_incrementalMode && !aTestFootprints && m_board->m_DRCTrackChanges
+                       && runHash == m_lastRunHash;
+
     m_reportAllTrackErrors = aReportAllTrackErrors;
     m_testFootprints = aTestFootprints;
 
@@ -609,27 +710,205 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
 
     DRC_TEST_PROVIDER::Init();
 
-    m_board->IncrementTimeStamp();      // Invalidate all caches...
+    // Text shape caches only need priming when they might be read from several threads at once
+    int cacheDependencies = DRC_CACHE_ALL & ~DRC_CACHE_TEXT_SHAPES;
+
+    if( m_scheduledMode )
+    {
+        for( DRC_TEST_PROVIDER* provider : m_testProviders )
+        {
+            if( provider->GetScheduling() != DRC_PROVIDER_SCHEDULING::EXCLUSIVE )
+                cacheDependencies |= provider->GetCacheDependencies();
+        }
+    }
 
     DRC_CACHE_GENERATOR cacheGenerator;
     cacheGenerator.SetDRCEngine( this );
+    cacheGenerator.SetCacheDependencies( cacheDependencies );
+
+    // A cancelled run leaves caches and markers which the next run can't build on
+    m_board->m_DRCTrackChanges = false;
+    m_lastRunHash = 0;
+
+    if( incremental )
+        cacheGenerator.SetIncremental( true );
+    else
+        m_board->IncrementTimeStamp();  // Invalidate all caches...
+
+    // Grab these before the cache generator consumes them
+    LSET dirtyLayers = m_board->m_DRCDirtyLayers;
+
+    m_lastRunProviders.clear();
 
     if( !cacheGenerator.Run() )         // ... and regenerate them.
+    {
+        m_board->IncrementTimeStamp();
         return;
+    }
 
     int timestamp = m_board->GetTimeStamp();
 
     for( DRC_TEST_PROVIDER* provider : m_testProviders )
     {
-        ReportAux( wxString::Format( wxT( "Run DRC provider: '%s'" ), provider->GetName() ) );
+        if( cacheGenerator.IsIncremental() && !( provider->GetTestedLayers() & dirtyLayers ).any() )
+        {
+            ReportAux( wxString::Format( wxT( "Skip DRC provider: '%s' (no changes)" ),
+                                         provider->GetName() ) );
+            continue;
+        }
 
-        if( !provider->RunTests( aUnits ) )
-            break;
+        m_lastRunProviders.push_back( provider );
+    }
+
+    bool cancelled = false;
+
+    if( m_scheduledMode )
+    {
+        std::vector<DRC_TEST_PROVIDER*> scheduled;
+
+        // Exclusive providers modify shared state, so each gets the board to itself before
+        // the rest are let loose on it.
+        for( DRC_TEST_PROVIDER* provider : m_lastRunProviders )
+        {
+            if( provider->GetScheduling() != DRC_PROVIDER_SCHEDULING::EXCLUSIVE )
+            {
+                scheduled.push_back( provider );
+                continue;
+            }
+
+            ReportAux( wxString::Format( wxT( "Run DRC provider: '%s'" ), provider->GetName() ) );
+
+            if( !provider->RunTests( aUnits ) )
+            {
+                cancelled = true;
+                break;
+            }
+        }
+
+        if( !cancelled && !runScheduledTests( scheduled, aUnits ) )
+            cancelled = true;
+    }
+    else
+    {
+        for( DRC_TEST_PROVIDER* provider : m_lastRunProviders )
+        {
+            ReportAux( wxString::Format( wxT( "Run DRC provider: '%s'" ), provider->GetName() ) );
+
+            if( !provider->RunTests( aUnits ) )
+            {
+                cancelled = true;
+                break;
+            }
+        }
     }
 
     // DRC tests are multi-threaded; anything that causes us to attempt to re-generate the
     // caches while DRC is running is problematic.
     wxASSERT( timestamp == m_board->GetTimeStamp() );
+
+    if( cancelled )
+    {
+        m_board->IncrementTimeStamp();
+        return;
+    }
+
+    m_board->m_DRCTrackChanges = m_incrementalMode;
+    m_lastRunHash = runHash;
+
+    int64_t lookups = m_constraintCacheHits + m_constraintCacheMisses;
+
+    if( lookups > 0 )
+    {
+        ReportAux( wxString::Format( wxT( "Constraint cache: %lld hits, %lld misses (%.1f%%)" ),
+                                     (long long) m_constraintCacheHits,
+                                     (long long) m_constraintCacheMisses,
+                                     100.0 * m_constraintCacheHits / lookups ) );
+    }
+}
+
+
+bool DRC_ENGINE::runScheduledTests( const std::vector<DRC_TEST_PROVIDER*>& aProviders,
+                                    EDA_UNITS aUnits )
+{
+    thread_pool&                   tp = GetKiCadThreadPool();
+    std::vector<std::future<bool>> returns;
+    bool                           cancelled = false;
+
+    for( DRC_TEST_PROVIDER* provider : aProviders )
+    {
+        if( provider->GetScheduling() != DRC_PROVIDER_SCHEDULING::CONCURRENT )
+            continue;
+
+        ReportAux( wxString::Format( wxT( "Schedule DRC provider: '%s'" ), provider->GetName() ) );
+
+        returns.emplace_back( tp.submit(
+                [provider, aUnits]() -> bool
+                {
+                    // Reset even if the provider throws, as the pool thread runs other tasks
+                    SCOPED_SET_RESET<bool> inProviderTask( s_inProviderTask, true );
+
+                    return provider->RunTests( aUnits );
+                } ) );
+    }
+
+    // Shared providers wait on their own thread pool tasks, so they must not be run from
+    // inside the pool.  They run here, alongside the concurrent ones.
+    for( DRC_TEST_PROVIDER* provider : aProviders )
+    {
+        if( provider->GetScheduling() != DRC_PROVIDER_SCHEDULING::SHARED )
+            continue;
+
+        flushAuxMessages();
+        ReportAux( wxString::Format( wxT( "Run DRC provider: '%s'" ), provider->GetName() ) );
+
+        if( !provider->RunTests( aUnits ) )
+        {
+            cancelled = true;
+            break;
+        }
+    }
+
+    // Even when cancelled the outstanding tasks still reference the board, so they must be
+    // waited for.  They will notice the cancellation at their next progress report.
+    if( !returns.empty() && !cancelled )
+        ReportPhase( _( "Finishing remaining tests..." ) );
+
+    size_t done = 0;
+
+    for( std::future<bool>& ret : returns )
+    {
+        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+
+        while( status != std::future_status::ready )
+        {
+            flushAuxMessages();
+            ReportProgress( static_cast<double>( done ) / returns.size() );
+            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+        }
+
+        if( !ret.get() )
+            cancelled = true;
+
+        done++;
+    }
+
+    flushAuxMessages();
+
+    return !cancelled && !IsCancelled();
+}
+
+
+void DRC_ENGINE::flushAuxMessages()
+{
+    std::vector<wxString> messages;
+
+    {
+        std::lock_guard<std::mutex> lock( m_auxMutex );
+        messages.swap( m_auxMessages );
+    }
+
+    for( const wxString& msg : messages )
+        ReportAux( msg );
 }
 
 
@@ -1280,9 +1559,35 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRules( DRC_CONSTRAINT_T aConstraintType, const BO
     if( m_constraintMap.count( aConstraintType ) )
     {
         std::vector<DRC_ENGINE_CONSTRAINT*>* ruleset = m_constraintMap[ aConstraintType ];
+        CONSTRAINT_CACHE_POLICY              cachePolicy = CONSTRAINT_CACHE_POLICY::NONE;
+        CONSTRAINT_CACHE_KEY                 cacheKey;
 
-        for( int ii = 0; ii < (int) ruleset->size(); ++ii )
-            processConstraint( ruleset->at( ii ) );
+        // Resolution info has to be reported in full, so it's never served from the cache
+        if( !aReporter )
+        {
+            auto policyIt = m_constraintCachePolicy.find( aConstraintType );
+
+            if( policyIt != m_constraintCachePolicy.end() )
+                cachePolicy = policyIt->second;
+        }
+
+        if( cachePolicy != CONSTRAINT_CACHE_POLICY::NONE )
+        {
+            cacheKey.constraintType = aConstraintType;
+            cacheKey.layer = aLayer;
+            cacheKey.a = makeCacheItem( a, a_is_non_copper, cachePolicy );
+            cacheKey.b = makeCacheItem( b, b_is_non_copper, cachePolicy );
+        }
+
+        if( cachePolicy == CONSTRAINT_CACHE_POLICY::NONE
+                || !lookupCachedConstraint( cacheKey, constraint ) )
+        {
+            for( int ii = 0; ii < (int) ruleset->size(); ++ii )
+                processConstraint( ruleset->at( ii ) );
+
+            if( cachePolicy != CONSTRAINT_CACHE_POLICY::NONE )
+                storeCachedConstraint( cacheKey, constraint );
+        }
     }
 
     if( constraint.GetParentRule() && !constraint.GetParentRule()->m_Implicit )
@@ -1571,15 +1876,12 @@ bool DRC_ENGINE::IsErrorLimitExceeded( int error_code )
 void DRC_ENGINE::ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, const VECTOR2I& aPos,
                                   int aMarkerLayer )
 {
-    static std::mutex globalLock;
+    std::lock_guard<std::mutex> guard( m_violationMutex );
 
     m_errorLimits[ aItem->GetErrorCode() ] -= 1;
 
     if( m_violationHandler )
-    {
-        std::lock_guard<std::mutex> guard( globalLock );
         m_violationHandler( aItem, aPos, aMarkerLayer );
-    }
 
     if( m_reporter )
     {
@@ -1609,6 +1911,13 @@ void DRC_ENGINE::ReportAux ( const wxString& aStr )
     if( !m_reporter )
         return;
 
+    if( s_inProviderTask )
+    {
+        std::lock_guard<std::mutex> lock( m_auxMutex );
+        m_auxMessages.push_back( aStr );
+        return;
+    }
+
     m_reporter->Report( aStr, RPT_SEVERITY_INFO );
 }
 
@@ -1618,20 +1927,23 @@ bool DRC_ENGINE::KeepRefreshing( bool aWait )
     if( !m_progressReporter )
         return true;
 
+    if( s_inProviderTask )
+        return !m_progressReporter->IsCancelled();
+
     return m_progressReporter->KeepRefreshing( aWait );
 }
 
 
 void DRC_ENGINE::AdvanceProgress()
 {
-    if( m_progressReporter )
+    if( m_progressReporter && !s_inProviderTask )
         m_progressReporter->AdvanceProgress();
 }
 
 
 void DRC_ENGINE::SetMaxProgress( int aSize )
 {
-    if( m_progressReporter )
+    if( m_progressReporter && !s_inProviderTask )
         m_progressReporter->SetMaxProgress( aSize );
 }
 
@@ -1641,6 +1953,10 @@ bool DRC_ENGINE::ReportProgress( double aProgress )
     if( !m_progressReporter )
         return true;
 
+    // Concurrent providers share the calling thread's progress display
+    if( s_inProviderTask )
+        return !m_progressReporter->IsCancelled();
+
     m_progressReporter->SetCurrentProgress( aProgress );
     return m_progressReporter->KeepRefreshing( false );
 }
@@ -1651,6 +1967,9 @@ bool DRC_ENGINE::ReportPhase( const wxString& aMessage )
     if( !m_progressReporter )
         return true;
 
+    if( s_inProviderTask )
+        return !m_progressReporter->IsCancelled();
+
     m_progressReporter->AdvancePhase( aMessage );
     return m_progressReporter->KeepRefreshing( false );
 }
@@ -1662,6 +1981,104 @@ bool DRC_ENGINE::IsCancelled() const
 }
 
 
+std::size_t
+DRC_ENGINE::CONSTRAINT_CACHE_KEY_HASH::operator()( const CONSTRAINT_CACHE_KEY& aKey ) const
+{
+    return hash_val( static_cast<int>( aKey.constraintType ), static_cast<int>( aKey.layer ),
+                     static_cast<int>( aKey.a.type ), aKey.a.netCode, aKey.a.netclass,
+                     aKey.a.nonCopper, aKey.a.drilledHole,
+                     static_cast<int>( aKey.b.type ), aKey.b.netCode, aKey.b.netclass,
+                     aKey.b.nonCopper, aKey.b.drilledHole );
+}
+
+
+DRC_ENGINE::CONSTRAINT_CACHE_ITEM DRC_ENGINE::makeCacheItem( const BOARD_ITEM* aItem,
+                                                             bool aNonCopper,
+                                                             CONSTRAINT_CACHE_POLICY aPolicy ) const
+{
+    CONSTRAINT_CACHE_ITEM item = { TYPE_NOT_INIT, -1, nullptr, aNonCopper, false };
+
+    if( !aItem )
+        return item;
+
+    item.type = aItem->Type();
+    item.drilledHole = aItem->HasDrilledHole();
+
+    // Match the netclass and net name references of the rule compiler, which accept any
+    // BOARD_CONNECTED_ITEM regardless of IsConnected()
+    if( const BOARD_CONNECTED_ITEM* cItem = dynamic_cast<const BOARD_CONNECTED_ITEM*>( aItem ) )
+    {
+        // A null netclass stands in for the board default, which is what the item would
+        // report as its effective netclass
+        if( cItem->GetNet() )
+            item.netclass = cItem->GetNet()->GetNetClass();
+
+        if( aPolicy == CONSTRAINT_CACHE_POLICY::BY_NET )
+            item.netCode = cItem->GetNetCode();
+    }
+
+    return item;
+}
+
+
+bool DRC_ENGINE::lookupCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey,
+                                         DRC_CONSTRAINT& aConstraint )
+{
+    {
+        std::shared_lock<std::shared_mutex> readLock( m_constraintCacheMutex );
+
+        if( m_constraintCacheTimestamp == m_board->GetTimeStamp()
+                && m_constraintCacheLayers == m_board->GetEnabledLayers() )
+        {
+            auto it = m_constraintCache.find( aKey );
+
+            if( it != m_constraintCache.end() )
+            {
+                aConstraint = it->second;
+                m_constraintCacheHits++;
+                return true;
+            }
+        }
+    }
+
+    m_constraintCacheMisses++;
+    return false;
+}
+
+
+void DRC_ENGINE::storeCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey,
+                                        const DRC_CONSTRAINT& aConstraint )
+{
+    // Keyed on nets the cache could in principle grow with the square of the net count; it's
+    // cheaper to start over than to let it get that far.
+    static const size_t MAX_CACHED_CONSTRAINTS = 1 << 20;
+
+    std::unique_lock<std::shared_mutex> writeLock( m_constraintCacheMutex );
+
+    if( m_constraintCacheTimestamp != m_board->GetTimeStamp()
+            || m_constraintCacheLayers != m_board->GetEnabledLayers()
+            || m_constraintCache.size() >= MAX_CACHED_CONSTRAINTS )
+    {
+        m_constraintCache.clear();
+        m_constraintCacheTimestamp = m_board->GetTimeStamp();
+        m_constraintCacheLayers = m_board->GetEnabledLayers();
+    }
+
+    m_constraintCache.emplace( aKey, aConstraint );
+}
+
+
+void DRC_ENGINE::clearConstraintCache()
+{
+    std::unique_lock<std::shared_mutex> writeLock( m_constraintCacheMutex );
+
+    m_constraintCache.clear();
+    m_constraintCacheTimestamp = -1;
+    m_constraintCacheHits = 0;
+    m_constraintCacheMisses = 0;
+}
+
+
 bool DRC_ENGINE::HasRulesForConstraintType( DRC_CONSTRAINT_T constraintID )
 {
     //drc_dbg(10,"hascorrect id %d size %d\n", ruleID,  m_ruleMap[ruleID]->sortedRules.size( ) );
@@ -1672,6 +2089,19 @@ bool DRC_ENGINE::HasRulesForConstraintType( DRC_CONSTRAINT_T constraintID )
 }
 
 
+bool DRC_ENGINE::IsConstraintNetclassBased( DRC_CONSTRAINT_T aConstraintType ) const
+{
+    // No rules at all means only the board minimums apply
+    if( !m_constraintMap.count( aConstraintType ) )
+        return true;
+
+    auto it = m_constraintCachePolicy.find( aConstraintType );
+
+    return it != m_constraintCachePolicy.end()
+            && it->second == CONSTRAINT_CACHE_POLICY::BY_NETCLASS;
+}
+
+
 bool DRC_ENGINE::QueryWorstConstraint( DRC_CONSTRAINT_T aConstraintId, DRC_CONSTRAINT& aConstraint )
 {
     int worst = 0;
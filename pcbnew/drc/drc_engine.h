@@ -24,12 +24,16 @@
 #ifndef DRC_ENGINE_H
 #define DRC_ENGINE_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <unordered_map>
 
 #include <units_provider.h>
 #include <geometry/shape.h>
+#include <core/typeinfo.h>
 #include <lset.h>
 #include <drc/drc_rule.h>
 
@@ -144,6 +148,36 @@ public:
      */
     void RunTests( EDA_UNITS aUnits,  bool aReportAllTrackErrors, bool aTestFootprints );
 
+    /**
+     * In scheduled mode providers which declare themselves CONCURRENT are run as thread pool
+     * tasks while SHARED providers run on the calling thread.  EXCLUSIVE providers are always
+     * run first, one at a time.
+     */
+    void SetScheduledMode( bool aScheduled ) { m_scheduledMode = aScheduled; }
+    bool GetScheduledMode() const { return m_scheduledMode; }
+
+    /**
+     * In incremental mode the DRC caches are updated from the changes committed since the last
+     * run (see BOARD::MarkDRCDirty()) rather than rebuilt, and only providers whose tested
+     * layers were touched by those changes are run again.  Providers which do run still test
+     * the whole board.  Callers are responsible for keeping the markers of providers which
+     * were not re-run (see GetLastRunProviders()).
+     *
+     * A full run is made instead whenever the rules, the severities or the test options have
+     * changed since the last run, when the schematic parity tests are requested, and after a
+     * cancelled run.
+     */
+    void SetIncrementalMode( bool aIncremental ) { m_incrementalMode = aIncremental; }
+    bool GetIncrementalMode() const { return m_incrementalMode; }
+
+    /**
+     * @return the providers which were run by the last call to RunTests().
+     */
+    const std::vector<DRC_TEST_PROVIDER*>& GetLastRunProviders() const
+    {
+        return m_lastRunProviders;
+    }
+
     bool IsErrorLimitExceeded( int error_code );
 
     DRC_CONSTRAINT EvalRules( DRC_CONSTRAINT_T aConstraintType, const BOARD_ITEM* a,
@@ -159,6 +193,20 @@ public:
 
     bool HasRulesForConstraintType( DRC_CONSTRAINT_T constraintID );
 
+    /**
+     * @return true if the rules for \a aConstraintType only look at the layer and at the types
+     *         and netclasses of the items, so that any two items sharing those get the same
+     *         constraint (local clearance overrides aside).
+     */
+    bool IsConstraintNetclassBased( DRC_CONSTRAINT_T aConstraintType ) const;
+
+    /**
+     * Constraint cache statistics, accumulated since the rules were last compiled.  Lookups
+     * which can't be cached at all (see DRC_RULE_CONDITION::IsCacheable()) aren't counted.
+     */
+    int64_t GetConstraintCacheHits() const { return m_constraintCacheHits; }
+    int64_t GetConstraintCacheMisses() const { return m_constraintCacheMisses; }
+
     bool GetReportAllTrackErrors() const { return m_reportAllTrackErrors; }
     bool GetTestFootprints() const { return m_testFootprints; }
 
@@ -227,6 +275,68 @@ private:
     void loadImplicitRules();
     std::shared_ptr<DRC_RULE> createImplicitRule( const wxString& name );
 
+    /**
+     * How the rule-based part of EvalRules() can be cached for a given constraint type.
+     */
+    enum class CONSTRAINT_CACHE_POLICY
+    {
+        NONE,           // At least one rule condition looks at item-specific properties
+        BY_NETCLASS,    // Rules depend only on the layer and the items' types and netclasses
+        BY_NET          // As above, but some rules look at net names too
+    };
+
+    /**
+     * The attributes of an item which decide the outcome of a cacheable rule.
+     */
+    struct CONSTRAINT_CACHE_ITEM
+    {
+        KICAD_T         type;
+        int             netCode;
+        const NETCLASS* netclass;
+        bool            nonCopper;
+        bool            drilledHole;
+
+        bool operator==( const CONSTRAINT_CACHE_ITEM& aOther ) const = default;
+    };
+
+    struct CONSTRAINT_CACHE_KEY
+    {
+        DRC_CONSTRAINT_T      constraintType;
+        PCB_LAYER_ID          layer;
+        CONSTRAINT_CACHE_ITEM a;
+        CONSTRAINT_CACHE_ITEM b;
+
+        bool operator==( const CONSTRAINT_CACHE_KEY& aOther ) const = default;
+    };
+
+    struct CONSTRAINT_CACHE_KEY_HASH
+    {
+        std::size_t operator()( const CONSTRAINT_CACHE_KEY& aKey ) const;
+    };
+
+    CONSTRAINT_CACHE_ITEM makeCacheItem( const BOARD_ITEM* aItem, bool aNonCopper,
+                                         CONSTRAINT_CACHE_POLICY aPolicy ) const;
+
+    bool lookupCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey, DRC_CONSTRAINT& aConstraint );
+    void storeCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey,
+                                const DRC_CONSTRAINT& aConstraint );
+    void clearConstraintCache();
+
+    /**
+     * Run the non-exclusive providers concurrently.  Must be called from the thread which
+     * owns the progress reporter.
+     *
+     * @return false if the run was cancelled.
+     */
+    bool runScheduledTests( const std::vector<DRC_TEST_PROVIDER*>& aProviders, EDA_UNITS aUnits );
+
+    /**
+     * @return a hash of the compiled rules, used to tell whether InitEngine() changed them.
+     */
+    size_t hashRules() const;
+
+    void flushAuxMessages();
+
 protected:
     BOARD_DESIGN_SETTINGS*     m_designSettings;
     BOARD*                     m_board;
@@ -240,14 +350,33 @@ protected:
     std::vector<int>           m_errorLimits;
     bool                       m_reportAllTrackErrors;
     bool                       m_testFootprints;
+    bool                       m_scheduledMode;
+    bool                       m_incrementalMode;
+    std::vector<DRC_TEST_PROVIDER*> m_lastRunProviders;
+    size_t                     m_rulesHash;     // of the rules compiled by InitEngine()
+    size_t                     m_lastRunHash;   // of the rules and options of the last run
 
     // constraint -> rule -> provider
     std::map<DRC_CONSTRAINT_T, std::vector<DRC_ENGINE_CONSTRAINT*>*> m_constraintMap;
+    std::map<DRC_CONSTRAINT_T, CONSTRAINT_CACHE_POLICY>             m_constraintCachePolicy;
+
+    // Rule resolution results, valid for a single board timestamp and set of enabled layers
+    std::shared_mutex          m_constraintCacheMutex;
+    std::unordered_map<CONSTRAINT_CACHE_KEY, DRC_CONSTRAINT, CONSTRAINT_CACHE_KEY_HASH>
+                               m_constraintCache;
+    int                        m_constraintCacheTimestamp;
+    LSET                       m_constraintCacheLayers;
+    std::atomic<int64_t>       m_constraintCacheHits;
+    std::atomic<int64_t>       m_constraintCacheMisses;
 
     DRC_VIOLATION_HANDLER      m_violationHandler;
     REPORTER*                  m_reporter;
     PROGRESS_REPORTER*         m_progressReporter;
 
+    std::mutex                 m_violationMutex;
+    std::mutex                 m_auxMutex;
+    std::vector<wxString>      m_auxMessages;   // Reported from thread pool tasks
+
     std::shared_ptr<KIGFX::VIEW_OVERLAY> m_debugOverlay;
 };
 
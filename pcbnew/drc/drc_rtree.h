@@ -26,6 +26,7 @@
 #define DRC_RTREE_H_
 
 #include <board_item.h>
+#include <core/thread_pool.h>
 #include <pad.h>
 #include <pcb_text.h>
 #include <memory>
@@ -76,6 +77,7 @@ public:
 private:
 
     using drc_rtree = RTree<ITEM_WITH_SHAPE*, int, 2, double>;
+    using drc_rtree_entry = std::pair<drc_rtree::Rect, ITEM_WITH_SHAPE*>;
 
 public:
 
@@ -85,6 +87,7 @@ public:
             m_tree[layer] = new drc_rtree();
 
         m_count = 0;
+        m_bulkLoading = false;
     }
 
     ~DRC_RTREE()
@@ -96,6 +99,72 @@ public:
 
             delete tree;
         }
+
+        for( std::vector<drc_rtree_entry>& pending : m_pending )
+        {
+            for( drc_rtree_entry& entry : pending )
+                delete entry.second;
+        }
+    }
+
+    /**
+     * Defer all following Insert()s until FinishBulkLoad().
+     *
+     * Use this when the full item set is known up front: packing the items into the tree in
+     * one go is much faster than inserting them one at a time, and gives a smaller tree which
+     * is cheaper to query.
+     */
+    void StartBulkLoad()
+    {
+        m_bulkLoading = true;
+    }
+
+    /**
+     * Pack the items inserted since StartBulkLoad() into the tree.
+     *
+     * @param aThreadPool if not null, the per-layer trees are built concurrently on this pool.
+     *                    Must not be used from within one of the pool's own tasks.
+     */
+    void FinishBulkLoad( thread_pool* aThreadPool = nullptr )
+    {
+        auto buildLayer =
+                [this]( int aLayer )
+                {
+                    std::vector<drc_rtree_entry>& pending = m_pending[aLayer];
+
+                    if( m_tree[aLayer]->Count() == 0 )
+                    {
+                        m_tree[aLayer]->BulkLoad( pending );
+                    }
+                    else
+                    {
+                        for( drc_rtree_entry& entry : pending )
+                        {
+                            m_tree[aLayer]->Insert( entry.first.m_min, entry.first.m_max,
+                                                    entry.second );
+                        }
+                    }
+
+                    std::vector<drc_rtree_entry>().swap( pending );
+                };
+
+        std::vector<std::future<void>> returns;
+
+        for( int layer : LSET::AllLayersMask().Seq() )
+        {
+            if( m_pending[layer].empty() )
+                continue;
+
+            if( aThreadPool )
+                returns.emplace_back( aThreadPool->submit( buildLayer, layer ) );
+            else
+                buildLayer( layer );
+        }
+
+        for( std::future<void>& ret : returns )
+            ret.wait();
+
+        m_bulkLoading = false;
     }
 
     /**
@@ -142,8 +211,7 @@ public:
             const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
             ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, subshape, shape );
 
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+            insert( aTargetLayer, mmin, mmax, itemShape );
         }
 
         if( aItem->Type() == PCB_PAD_T && aItem->HasHole() )
@@ -157,11 +225,51 @@ public:
             const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
             ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, hole, shape );
 
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+            insert( aTargetLayer, mmin, mmax, itemShape );
         }
     }
 
+    /**
+     * Remove all entries belonging to an item.  The item is not dereferenced, so it may already
+     * have been deleted.
+     *
+     * @param aBBox must overlap all of the item's entries (for instance, the bounding box the
+     *              item had when it was inserted).
+     * @return the number of entries removed.
+     */
+    int Remove( const BOARD_ITEM* aItem, const BOX2I& aBBox )
+    {
+        const int min[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int max[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+        int       removed = 0;
+
+        for( int layer : LSET::AllLayersMask().Seq() )
+        {
+            std::vector<ITEM_WITH_SHAPE*> entries;
+
+            auto visitor =
+                    [&]( ITEM_WITH_SHAPE* aEntry ) -> bool
+                    {
+                        if( aEntry->parent == aItem )
+                            entries.push_back( aEntry );
+
+                        return true;
+                    };
+
+            m_tree[layer]->Search( min, max, visitor );
+
+            for( ITEM_WITH_SHAPE* entry : entries )
+            {
+                m_tree[layer]->Remove( min, max, entry );
+                delete entry;
+                removed++;
+            }
+        }
+
+        m_count -= removed;
+        return removed;
+    }
+
     /**
      * Remove all items from the RTree.
      */
@@ -579,8 +687,27 @@ public:
 
 
 private:
-    drc_rtree*  m_tree[PCB_LAYER_ID_COUNT];
-    size_t      m_count;
+    void insert( PCB_LAYER_ID aLayer, const int aMin[2], const int aMax[2],
+                 ITEM_WITH_SHAPE* aItemShape )
+    {
+        if( m_bulkLoading )
+        {
+            drc_rtree::Rect rect = { { aMin[0], aMin[1] }, { aMax[0], aMax[1] } };
+            m_pending[aLayer].emplace_back( rect, aItemShape );
+        }
+        else
+        {
+            m_tree[aLayer]->Insert( aMin, aMax, aItemShape );
+        }
+
+        m_count++;
+    }
+
+private:
+    drc_rtree*                   m_tree[PCB_LAYER_ID_COUNT];
+    std::vector<drc_rtree_entry> m_pending[PCB_LAYER_ID_COUNT];
+    bool                         m_bulkLoading;
+    size_t                       m_count;
 };
 
 
@@ -86,6 +86,21 @@ bool DRC_RULE_CONDITION::EvaluateFor( const BOARD_ITEM* aItemA, const BOARD_ITEM
 }
 
 
+bool DRC_RULE_CONDITION::IsCacheable() const
+{
+    if( GetExpression().IsEmpty() )
+        return true;
+
+    return m_ucode && m_ucode->IsCacheable();
+}
+
+
+bool DRC_RULE_CONDITION::DependsOnNet() const
+{
+    return m_ucode && m_ucode->DependsOnNet();
+}
+
+
 bool DRC_RULE_CONDITION::Compile( REPORTER* aReporter, int aSourceLine, int aSourceOffset )
 {
     PCBEXPR_COMPILER compiler( new PCBEXPR_UNIT_RESOLVER() );
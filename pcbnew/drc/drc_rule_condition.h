@@ -43,6 +43,14 @@ public:
 
     bool Compile( REPORTER* aReporter, int aSourceLine = 0, int aSourceOffset = 0 );
 
+    /**
+     * @return true if the result of EvaluateFor() is fully determined by the layer and by the
+     *         type, net and netclass of the two items (see PCBEXPR_UCODE::IsCacheable()).
+     */
+    bool IsCacheable() const;
+
+    bool DependsOnNet() const;
+
     void SetExpression( const wxString& aExpression ) { m_expression = aExpression; }
     wxString GetExpression() const { return m_expression; }
 
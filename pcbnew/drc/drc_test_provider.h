@@ -36,6 +36,35 @@ class DRC_TEST_PROVIDER;
 class DRC_RULE;
 class DRC_CONSTRAINT;
 
+
+/**
+ * Board-level caches built by DRC_CACHE_GENERATOR which a test provider reads.
+ */
+enum DRC_CACHE_DEPENDENCY
+{
+    DRC_CACHE_NONE          = 0,
+    DRC_CACHE_COPPER_ITEMS  = 1 << 0,   ///< BOARD::m_CopperItemRTreeCache
+    DRC_CACHE_COPPER_ZONES  = 1 << 1,   ///< BOARD::m_CopperZoneRTreeCache & m_DRCCopperZones
+    DRC_CACHE_ZONES         = 1 << 2,   ///< BOARD::m_DRCZones, zone bboxes & triangulations
+    DRC_CACHE_COURTYARDS    = 1 << 3,   ///< Footprint courtyard caches
+    DRC_CACHE_CONNECTIVITY  = 1 << 4,   ///< Connectivity data & BOARD::m_ZoneIsolatedIslandsMap
+    DRC_CACHE_TEXT_SHAPES   = 1 << 5,   ///< Outline font glyph caches of board text items
+
+    DRC_CACHE_ALL           = ( 1 << 6 ) - 1
+};
+
+
+/**
+ * How a test provider may be scheduled with respect to the other providers.
+ */
+enum class DRC_PROVIDER_SCHEDULING
+{
+    EXCLUSIVE,      ///< Modifies shared board state; must run alone on the calling thread
+    SHARED,         ///< Read-only, but waits on its own thread pool tasks so must run on the
+                    ///<   calling thread (alongside any CONCURRENT providers)
+    CONCURRENT      ///< Read-only and single-threaded; may run as a thread pool task
+};
+
 class DRC_TEST_PROVIDER_REGISTRY
 {
 public:
@@ -99,6 +128,27 @@ public:
     virtual const wxString GetName() const;
     virtual const wxString GetDescription() const;
 
+    /**
+     * Return the DRC_CACHE_DEPENDENCY flags of the caches this provider reads.  Only consulted
+     * for providers which are not DRC_PROVIDER_SCHEDULING::EXCLUSIVE.
+     */
+    virtual int GetCacheDependencies() const { return DRC_CACHE_ALL; }
+
+    /**
+     * Providers which modify shared board state (or whose thread safety has not been audited)
+     * must remain EXCLUSIVE.  Read-only providers may opt into concurrent scheduling.
+     */
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const
+    {
+        return DRC_PROVIDER_SCHEDULING::EXCLUSIVE;
+    }
+
+    /**
+     * Return the layers on which a change can affect this provider's results.  In incremental
+     * mode providers are only re-run when a committed change touches one of these layers.
+     */
+    virtual LSET GetTestedLayers() const { return LSET::AllLayersMask(); }
+
 protected:
     int forEachGeometryItem( const std::vector<KICAD_T>& aTypes, LSET aLayers,
                              const std::function<bool(BOARD_ITEM*)>& aFunc );
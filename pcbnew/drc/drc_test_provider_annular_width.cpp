@@ -168,6 +168,21 @@ public:
     {
         return wxT( "Tests pad/via annular rings" );
     }
+
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::CONCURRENT;
+    }
+
+    virtual LSET GetTestedLayers() const override
+    {
+        return LSET::AllCuMask();
+    }
 };
 
 
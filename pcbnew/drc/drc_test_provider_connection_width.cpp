@@ -107,6 +107,16 @@ public:
         return wxT( "Checks copper nets for connections less than a specified minimum" );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_COPPER_ITEMS | DRC_CACHE_COPPER_ZONES | DRC_CACHE_ZONES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::SHARED;
+    }
+
 private:
     wxString layerDesc( PCB_LAYER_ID aLayer );
 };
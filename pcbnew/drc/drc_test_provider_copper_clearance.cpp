@@ -81,6 +81,17 @@ public:
         return wxT( "Tests copper item clearance" );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_COPPER_ITEMS | DRC_CACHE_COPPER_ZONES | DRC_CACHE_ZONES
+                   | DRC_CACHE_TEXT_SHAPES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::SHARED;
+    }
+
 private:
     /**
      * Checks for track/via/hole <-> clearance
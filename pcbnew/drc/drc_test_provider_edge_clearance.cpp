@@ -65,6 +65,16 @@ public:
         return wxT( "Tests items vs board edge clearance" );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES | DRC_CACHE_TEXT_SHAPES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::CONCURRENT;
+    }
+
 private:
     bool testAgainstEdge( BOARD_ITEM* item, SHAPE* itemShape, BOARD_ITEM* other,
                           DRC_CONSTRAINT_T aConstraintType, PCB_DRC_CODE aErrorCode );
@@ -62,6 +62,21 @@ public:
         return wxT( "Tests sizes of drilled holes (via/pad drills)" );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::CONCURRENT;
+    }
+
+    virtual LSET GetTestedLayers() const override
+    {
+        return LSET::AllCuMask();
+    }
+
 private:
     void checkViaHole( PCB_VIA* via, bool aExceedMicro, bool aExceedStd );
     void checkPadHole( PAD* aPad );
@@ -67,6 +67,21 @@ public:
         return wxT( "Tests hole to hole spacing" );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::CONCURRENT;
+    }
+
+    virtual LSET GetTestedLayers() const override
+    {
+        return LSET::AllCuMask();
+    }
+
 private:
     bool testHoleAgainstHole( BOARD_ITEM* aItem, SHAPE_CIRCLE* aHole, BOARD_ITEM* aOther );
 
@@ -66,6 +66,21 @@ public:
         return wxT( "Tests for overlapping silkscreen features." );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES | DRC_CACHE_TEXT_SHAPES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::CONCURRENT;
+    }
+
+    virtual LSET GetTestedLayers() const override
+    {
+        return LSET::FrontMask() | LSET::BackMask() | LSET( { Edge_Cuts, Margin } );
+    }
+
 private:
 
     BOARD* m_board;
@@ -141,12 +156,19 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
                          LSET::FrontMask() | LSET::BackMask() | LSET( { Edge_Cuts, Margin } ),
                          countItems );
 
+    silkTree.StartBulkLoad();
+    targetTree.StartBulkLoad();
+
     forEachGeometryItem( s_allBasicItems, LSET( { F_SilkS, B_SilkS } ), addToSilkTree );
 
     forEachGeometryItem( s_allBasicItems,
                          LSET::FrontMask() | LSET::BackMask() | LSET( { Edge_Cuts, Margin } ),
                          addToTargetTree );
 
+    // This provider may be running on the thread pool, so pack the trees in-line
+    silkTree.FinishBulkLoad();
+    targetTree.FinishBulkLoad();
+
     reportAux( wxT( "Testing %d silkscreen features against %d board items." ),
                silkTree.size(),
                targetTree.size() );
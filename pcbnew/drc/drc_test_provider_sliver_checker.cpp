@@ -65,6 +65,16 @@ public:
         return wxT( "Checks copper layers for slivers" );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_NONE;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::SHARED;
+    }
+
 private:
     wxString layerDesc( PCB_LAYER_ID aLayer );
 };
@@ -61,6 +61,16 @@ public:
     {
         return wxT( "Tests text height and thickness" );
     }
+
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES | DRC_CACHE_TEXT_SHAPES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::CONCURRENT;
+    }
 };
 
 
@@ -54,6 +54,21 @@ public:
     {
         return wxT( "Tests track widths" );
     }
+
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::CONCURRENT;
+    }
+
+    virtual LSET GetTestedLayers() const override
+    {
+        return LSET::AllCuMask();
+    }
 };
 
 
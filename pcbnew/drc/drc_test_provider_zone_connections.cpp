@@ -68,6 +68,16 @@ public:
         return wxT( "Checks thermal reliefs for a sufficient number of connecting spokes" );
     }
 
+    virtual int GetCacheDependencies() const override
+    {
+        return DRC_CACHE_ZONES | DRC_CACHE_CONNECTIVITY;
+    }
+
+    virtual DRC_PROVIDER_SCHEDULING GetScheduling() const override
+    {
+        return DRC_PROVIDER_SCHEDULING::SHARED;
+    }
+
 private:
     void testZoneLayer( ZONE* aZone, PCB_LAYER_ID aLayer );
 };
@@ -22,6 +22,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
 // base64 code. Needed for PCB_REFERENCE_IMAGE
 #define wxUSE_BASE64 1
 #include <wx/base64.h>
@@ -37,6 +46,7 @@
 #include <callback_gal.h>
 #include <confirm.h>
 #include <convert_basic_shapes_to_polygon.h> // for enum RECT_CHAMFER_POSITIONS definition
+#include <core/thread_pool.h>
 #include <fmt/core.h>
 #include <font/fontconfig.h>
 #include <footprint.h>
@@ -75,6 +85,67 @@
 using namespace PCB_KEYS_T;
 
 
+/// Libraries with fewer files than this are not worth spreading over the thread pool.
+static const size_t c_minConcurrentFootprintFiles = 16;
+
+
+/**
+ * Run \a aJob for each index below \a aCount on the calling thread and on the idle threads of
+ * the pool.
+ *
+ * The calling thread takes a share of the work and only waits for jobs which have already
+ * started, so this can't deadlock when it is itself running on the pool (the footprint list
+ * loads its libraries there).
+ */
+static void runConcurrently( size_t aCount, const std::function<void( size_t )>& aJob )
+{
+    struct SHARED_STATE
+    {
+        std::function<void( size_t )> job;
+        size_t                        count;
+        std::atomic<size_t>           next = 0;
+        std::atomic<size_t>           done = 0;
+        std::mutex                    mutex;
+        std::condition_variable       finished;
+    };
+
+    auto state = std::make_shared<SHARED_STATE>();
+    state->job = aJob;
+    state->count = aCount;
+
+    // Jobs still queued when all the work is done just return; the state outlives us for them.
+    auto worker =
+            [state]()
+            {
+                for( size_t idx = state->next++; idx < state->count; idx = state->next++ )
+                {
+                    state->job( idx );
+
+                    if( ++state->done == state->count )
+                    {
+                        std::lock_guard<std::mutex> lock( state->mutex );
+                        state->finished.notify_all();
+                    }
+                }
+            };
+
+    thread_pool& tp = GetKiCadThreadPool();
+    size_t       helpers = std::min<size_t>( tp.get_thread_count(), aCount ) - 1;
+
+    for( size_t ii = 0; ii < helpers; ++ii )
+        tp.push_task( worker );
+
+    worker();
+
+    std::unique_lock<std::mutex> lock( state->mutex );
+    state->finished.wait( lock,
+                          [&]()
+                          {
+                              return state->done == state->count;
+                          } );
+}
+
+
 FP_CACHE_ITEM::FP_CACHE_ITEM( FOOTPRINT* aFootprint, const WX_FILENAME& aFileName ) :
         m_filename( aFileName ),
         m_footprint( aFootprint )
@@ -186,49 +257,104 @@ void FP_CACHE::Load()
     wxString fullName;
     wxString fileSpec = wxT( "*." ) + wxString( FILEEXT::KiCadFootprintFileExtension );
 
-    // wxFileName construction is egregiously slow.  Construct it once and just swap out
-    // the filename thereafter.
-    WX_FILENAME fn( m_lib_raw_path, wxT( "dummyName" ) );
+    std::vector<wxString> fileNames;
 
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
-            fn.SetFullName( fullName );
+            fileNames.push_back( fullName );
+        } while( dir.GetNext( &fullName ) );
+    }
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER reader( fn.GetFullPath() );
-                PCB_IO_KICAD_SEXPR_PARSER       parser( &reader, nullptr, nullptr );
+    if( fileNames.empty() )
+        return;
 
-                FOOTPRINT* footprint = dynamic_cast<FOOTPRINT*>( parser.Parse() );
-                wxString fpName = fn.GetName();
+    // Each file gets its own slot so the parsers never share anything, and the footprints and
+    // errors are merged in directory order whichever thread got to them first.
+    struct LOADED_FILE
+    {
+        std::optional<WX_FILENAME> fileName;
+        std::unique_ptr<FOOTPRINT> footprint;
+        wxString                   error;
+        std::exception_ptr         exception;   // Anything but an IO_ERROR is passed on
+    };
 
-                if( !footprint )
-                    THROW_IO_ERROR( wxEmptyString );   // caught locally, just below...
+    std::vector<LOADED_FILE> loaded( fileNames.size() );
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_footprints.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
-            }
-            catch( const IO_ERROR& ioe )
+    auto loadFile =
+            [&]( size_t aIdx )
             {
-                if( !cacheError.IsEmpty() )
-                    cacheError += wxT( "\n\n" );
+                // The slow wxFileName construction is spread over the threads along with the
+                // parsing.
+                loaded[aIdx].fileName.emplace( m_lib_raw_path, fileNames[aIdx] );
 
-                cacheError += wxString::Format( _( "Unable to read file '%s'" ) + '\n',
-                                                fn.GetFullPath() );
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fullName ) );
+                wxString fullPath = loaded[aIdx].fileName->GetFullPath();
+
+                // Queue I/O errors so only files that fail to parse don't get loaded.
+                try
+                {
+                    FILE_LINE_READER          reader( fullPath );
+                    PCB_IO_KICAD_SEXPR_PARSER parser( &reader, nullptr, nullptr );
+
+                    loaded[aIdx].footprint.reset( dynamic_cast<FOOTPRINT*>( parser.Parse() ) );
 
-        m_cache_timestamp = GetTimestamp( m_lib_raw_path );
+                    if( !loaded[aIdx].footprint )
+                        THROW_IO_ERROR( wxEmptyString );   // caught locally, just below...
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    loaded[aIdx].error = wxString::Format( _( "Unable to read file '%s'" ) + '\n',
+                                                           fullPath );
+                    loaded[aIdx].error += ioe.What();
+                }
+                catch( ... )
+                {
+                    loaded[aIdx].exception = std::current_exception();
+                }
+            };
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+    if( ADVANCED_CFG::GetCfg().m_FootprintCacheConcurrentLoad
+            && fileNames.size() >= c_minConcurrentFootprintFiles )
+    {
+        runConcurrently( fileNames.size(), loadFile );
     }
+    else
+    {
+        for( size_t ii = 0; ii < fileNames.size(); ++ii )
+            loadFile( ii );
+    }
+
+    wxString cacheError;
+
+    for( const LOADED_FILE& file : loaded )
+    {
+        if( file.exception )
+            std::rethrow_exception( file.exception );
+    }
+
+    for( size_t ii = 0; ii < fileNames.size(); ++ii )
+    {
+        if( !loaded[ii].footprint )
+        {
+            if( !cacheError.IsEmpty() )
+                cacheError += wxT( "\n\n" );
+
+            cacheError += loaded[ii].error;
+            continue;
+        }
+
+        const WX_FILENAME& fn = *loaded[ii].fileName;
+        wxString           fpName = fn.GetName();
+
+        loaded[ii].footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
+        m_footprints.insert( fpName, new FP_CACHE_ITEM( loaded[ii].footprint.release(), fn ) );
+    }
+
+    m_cache_timestamp = GetTimestamp( m_lib_raw_path );
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
 }
 
 
@@ -479,6 +605,44 @@ std::string formatInternalUnits( const VECTOR2I& aCoord, const FOOTPRINT* aParen
 }
 
 
+/**
+ * Internal units formatted into a buffer of its own, for the values written in large numbers
+ * (polygon points and tracks), so that each of them doesn't allocate a std::string.
+ */
+class FORMATTED_IU
+{
+public:
+    FORMATTED_IU( int aValue )
+    {
+        *EDA_UNIT_UTILS::FormatInternalUnits( m_buf, end(), pcbIUScale, aValue ).ptr = '\0';
+    }
+
+    FORMATTED_IU( const VECTOR2I& aCoord, const FOOTPRINT* aParentFP = nullptr )
+    {
+        VECTOR2I coord = aCoord;
+
+        if( aParentFP )
+        {
+            coord -= aParentFP->GetPosition();
+            RotatePoint( coord, -aParentFP->GetOrientation() );
+        }
+
+        char* pos = EDA_UNIT_UTILS::FormatInternalUnits( m_buf, end(), pcbIUScale, coord.x ).ptr;
+
+        *pos++ = ' ';
+        *EDA_UNIT_UTILS::FormatInternalUnits( pos, end(), pcbIUScale, coord.y ).ptr = '\0';
+    }
+
+    const char* c_str() const { return m_buf; }
+
+private:
+    /// Leaves room for the terminating nul
+    char* end() { return m_buf + sizeof( m_buf ) - 1; }
+
+    char m_buf[64];
+};
+
+
 void PCB_IO_KICAD_SEXPR::formatLayer( PCB_LAYER_ID aLayer, bool aIsKnockout ) const
 {
     m_out->Print( 0, " (layer %s%s)",
@@ -503,16 +667,16 @@ void PCB_IO_KICAD_SEXPR::formatPolyPts( const SHAPE_LINE_CHAIN& outline, int aNe
         if( ind < 0 )
         {
             m_out->Print( nestLevel, "(xy %s)",
-                          formatInternalUnits( outline.CPoint( ii ), aParentFP ).c_str() );
+                          FORMATTED_IU( outline.CPoint( ii ), aParentFP ).c_str() );
             needNewline = true;
         }
         else
         {
             const SHAPE_ARC& arc = outline.Arc( ind );
             m_out->Print( nestLevel, "(arc (start %s) (mid %s) (end %s))",
-                          formatInternalUnits( arc.GetP0(), aParentFP ).c_str(),
-                          formatInternalUnits( arc.GetArcMid(), aParentFP ).c_str(),
-                          formatInternalUnits( arc.GetP1(), aParentFP ).c_str() );
+                          FORMATTED_IU( arc.GetP0(), aParentFP ).c_str(),
+                          FORMATTED_IU( arc.GetArcMid(), aParentFP ).c_str(),
+                          FORMATTED_IU( arc.GetP1(), aParentFP ).c_str() );
             needNewline = true;
 
             do
@@ -2272,8 +2436,8 @@ void PCB_IO_KICAD_SEXPR::format( const PCB_TRACK* aTrack, int aNestLevel ) const
         }
 
         m_out->Print( 0, " (at %s) (size %s)",
-                      formatInternalUnits( aTrack->GetStart() ).c_str(),
-                      formatInternalUnits( aTrack->GetWidth() ).c_str() );
+                      FORMATTED_IU( aTrack->GetStart() ).c_str(),
+                      FORMATTED_IU( aTrack->GetWidth() ).c_str() );
 
         // Old boards were using UNDEFINED_DRILL_DIAMETER value in file for via drill when
         // via drill was the netclass value.
@@ -2281,9 +2445,9 @@ void PCB_IO_KICAD_SEXPR::format( const PCB_TRACK* aTrack, int aNestLevel ) const
         // always store the drill value, because netclass value is not stored in the board file.
         // Otherwise the drill value of some (old) vias can be unknown
         if( via->GetDrill() != UNDEFINED_DRILL_DIAMETER )
-            m_out->Print( 0, " (drill %s)", formatInternalUnits( via->GetDrill() ).c_str() );
+            m_out->Print( 0, " (drill %s)", FORMATTED_IU( via->GetDrill() ).c_str() );
         else
-            m_out->Print( 0, " (drill %s)", formatInternalUnits( via->GetDrillValue() ).c_str() );
+            m_out->Print( 0, " (drill %s)", FORMATTED_IU( via->GetDrillValue() ).c_str() );
 
         m_out->Print( 0, " (layers %s %s)",
                       m_out->Quotew( LSET::Name( layer1 ) ).c_str(),
@@ -2357,10 +2521,10 @@ void PCB_IO_KICAD_SEXPR::format( const PCB_TRACK* aTrack, int aNestLevel ) const
         const PCB_ARC* arc = static_cast<const PCB_ARC*>( aTrack );
 
         m_out->Print( aNestLevel, "(arc (start %s) (mid %s) (end %s) (width %s)",
-                      formatInternalUnits( arc->GetStart() ).c_str(),
-                      formatInternalUnits( arc->GetMid() ).c_str(),
-                      formatInternalUnits( arc->GetEnd() ).c_str(),
-                      formatInternalUnits( arc->GetWidth() ).c_str() );
+                      FORMATTED_IU( arc->GetStart() ).c_str(),
+                      FORMATTED_IU( arc->GetMid() ).c_str(),
+                      FORMATTED_IU( arc->GetEnd() ).c_str(),
+                      FORMATTED_IU( arc->GetWidth() ).c_str() );
 
         if( arc->IsLocked() )
             KICAD_FORMAT::FormatBool( m_out, 0, "locked", arc->IsLocked() );
@@ -2370,9 +2534,9 @@ void PCB_IO_KICAD_SEXPR::format( const PCB_TRACK* aTrack, int aNestLevel ) const
     else
     {
         m_out->Print( aNestLevel, "(segment (start %s) (end %s) (width %s)",
-                      formatInternalUnits( aTrack->GetStart() ).c_str(),
-                      formatInternalUnits( aTrack->GetEnd() ).c_str(),
-                      formatInternalUnits( aTrack->GetWidth() ).c_str() );
+                      FORMATTED_IU( aTrack->GetStart() ).c_str(),
+                      FORMATTED_IU( aTrack->GetEnd() ).c_str(),
+                      FORMATTED_IU( aTrack->GetWidth() ).c_str() );
 
         if( aTrack->IsLocked() )
             KICAD_FORMAT::FormatBool( m_out, 0, "locked", aTrack->IsLocked() );
@@ -2630,7 +2794,14 @@ PCB_IO_KICAD_SEXPR::~PCB_IO_KICAD_SEXPR()
 BOARD* PCB_IO_KICAD_SEXPR::LoadBoard( const wxString& aFileName, BOARD* aAppendToMe,
                               const STRING_UTF8_MAP* aProperties, PROJECT* aProject )
 {
-    FILE_LINE_READER reader( aFileName );
+    std::unique_ptr<LINE_READER> reader;
+    MAPPED_FILE_LINE_READER*     mappedReader = nullptr;
+    FILE_LINE_READER*            fileReader = nullptr;
+
+    if( ADVANCED_CFG::GetCfg().m_MappedFileLoad )
+        reader.reset( mappedReader = new MAPPED_FILE_LINE_READER( aFileName ) );
+    else
+        reader.reset( fileReader = new FILE_LINE_READER( aFileName ) );
 
     unsigned lineCount = 0;
 
@@ -2643,13 +2814,20 @@ BOARD* PCB_IO_KICAD_SEXPR::LoadBoard( const wxString& aFileName, BOARD* aAppendT
         if( !m_progressReporter->KeepRefreshing() )
             THROW_IO_ERROR( _( "Open cancelled by user." ) );
 
-        while( reader.ReadLine() )
-            lineCount++;
+        if( mappedReader )
+        {
+            lineCount = (unsigned) std::count( mappedReader->Begin(), mappedReader->End(), '\n' );
+        }
+        else
+        {
+            while( fileReader->ReadLine() )
+                lineCount++;
 
-        reader.Rewind();
+            fileReader->Rewind();
+        }
     }
 
-    BOARD* board = DoLoad( reader, aAppendToMe, aProperties, m_progressReporter, lineCount );
+    BOARD* board = DoLoad( *reader, aAppendToMe, aProperties, m_progressReporter, lineCount );
 
     // Give the filename to the board if it's new
     if( !aAppendToMe )
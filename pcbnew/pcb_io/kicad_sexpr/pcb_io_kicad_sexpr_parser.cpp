@@ -27,16 +27,25 @@
  * @brief Pcbnew s-expression file format parser implementation.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string_view>
 #include <confirm.h>
 #include <macros.h>
 #include <fmt/format.h>
 #include <title_block.h>
 #include <trigo.h>
 
+#include <advanced_config.h>
 #include <board.h>
 #include <board_design_settings.h>
+#include <eda_units.h>
 #include <embedded_files.h>
 #include <font/fontconfig.h>
 #include <pcb_dimension.h>
@@ -55,6 +64,7 @@
 #include <geometry/shape_line_chain.h>
 #include <font/font.h>
 #include <core/ignore.h>
+#include <core/thread_pool.h>
 #include <netclass.h>
 #include <pcb_io/kicad_sexpr/pcb_io_kicad_sexpr.h>
 #include <pcb_plot_params_parser.h>
@@ -140,11 +150,13 @@ void PCB_IO_KICAD_SEXPR_PARSER::checkpoint()
     if( m_progressReporter )
     {
         TIME_PT curTime = CLOCK::now();
-        unsigned curLine = reader->LineNumber();
         auto delta = std::chrono::duration_cast<TIMEOUT>( curTime - m_lastProgressTime );
 
         if( delta > std::chrono::milliseconds( 250 ) )
         {
+            // Readers may work out line numbers lazily, so only ask when reporting
+            unsigned curLine = reader->LineNumber();
+
             m_progressReporter->SetCurrentProgress( ( (double) curLine )
                                                             / std::max( 1U, m_lineCount ) );
 
@@ -192,12 +204,18 @@ void PCB_IO_KICAD_SEXPR_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 int PCB_IO_KICAD_SEXPR_PARSER::parseBoardUnits()
 {
-    // There should be no major rounding issues here, since the values in
-    // the file are in mm and get converted to nano-meters.
-    // See test program tools/test-nm-biu-to-ascii-mm-round-tripping.cpp
-    // to confirm or experiment.  Use a similar strategy in both places, here
-    // and in the test program. Make that program with:
-    // $ make test-nm-biu-to-ascii-mm-round-tripping
+    // The values in the file are in mm and are converted to nanometers exactly, without going
+    // through floating point.
+    const std::string& str = CurStr();
+    int                value;
+
+    if( EDA_UNIT_UTILS::ParseInternalUnits( str.data(), str.data() + str.size(), pcbIUScale,
+                                            value ).ec == std::errc() )
+    {
+        return std::clamp( value, -int( INT_LIMIT ), int( INT_LIMIT ) );
+    }
+
+    // Leave anything else, such as leading whitespace or errors, to the floating point parser
     auto retval = parseDouble() * pcbIUScale.IU_PER_MM;
 
     // N.B. we currently represent board units as integers.  Any values that are
@@ -209,12 +227,8 @@ int PCB_IO_KICAD_SEXPR_PARSER::parseBoardUnits()
 
 int PCB_IO_KICAD_SEXPR_PARSER::parseBoardUnits( const char* aExpected )
 {
-    auto retval = parseDouble( aExpected ) * pcbIUScale.IU_PER_MM;
-
-    // N.B. we currently represent board units as integers.  Any values that are
-    // larger or smaller than those board units represent undefined behavior for
-    // the system.  We limit values to the largest that is visible on the screen
-    return KiROUND( std::clamp( retval, -INT_LIMIT, INT_LIMIT ) );
+    NeedNUMBER( aExpected );
+    return parseBoardUnits();
 }
 
 
@@ -920,6 +934,10 @@ BOARD* PCB_IO_KICAD_SEXPR_PARSER::parseBOARD_unchecked()
     std::vector<BOARD_ITEM*> bulkAddedItems;
     BOARD_ITEM* item = nullptr;
 
+    // Large boards have their footprints, tracks, vias and zones parsed concurrently, and
+    // attached here in file order
+    std::unique_ptr<CONCURRENT_LOAD> concurrentLoad = scanConcurrentChunks();
+
     for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
     {
         checkpoint();
@@ -927,6 +945,9 @@ BOARD* PCB_IO_KICAD_SEXPR_PARSER::parseBOARD_unchecked()
         if( token != T_LEFT )
             Expecting( T_LEFT );
 
+        if( concurrentLoad && attachConcurrentChunk( *concurrentLoad, bulkAddedItems ) )
+            continue;
+
         token = NextTok();
 
         if( token == T_page && m_requiredVersion <= 20200119 )
@@ -1118,6 +1139,20 @@ BOARD* PCB_IO_KICAD_SEXPR_PARSER::parseBOARD_unchecked()
         }
     }
 
+    if( concurrentLoad )
+    {
+        concurrentLoad.reset();
+        m_deferBoardChanges = false;
+
+        for( const auto& [zone, netName] : m_deferredZoneNets )
+            fixupZoneNet( zone, netName );
+
+        m_deferredZoneNets.clear();
+
+        if( m_deferredLegacyTeardrops )
+            m_board->SetLegacyTeardrops( true );
+    }
+
     if( bulkAddedItems.size() > 0 )
         m_board->FinalizeBulkAdd( bulkAddedItems );
 
@@ -1229,6 +1264,426 @@ BOARD* PCB_IO_KICAD_SEXPR_PARSER::parseBOARD_unchecked()
 }
 
 
+/**
+ * A run of top-level footprints, tracks, vias and zones, with nothing else between them,
+ * which is parsed by a parser of its own.
+ */
+struct PCB_IO_KICAD_SEXPR_PARSER::CONCURRENT_CHUNK
+{
+    const char*              m_begin = nullptr;      ///< where the text of the chunk starts
+    const char*              m_firstItem = nullptr;  ///< the '(' of the first item
+    const char*              m_end = nullptr;        ///< one past the ')' of the last item
+    unsigned                 m_lineNumber = 0;       ///< line number before m_begin
+    wxString                 m_source;
+
+    std::atomic<bool>        m_claimed = false;      ///< set by whoever parses the chunk
+    std::mutex               m_mutex;
+    std::condition_variable  m_condition;
+    bool                     m_done = false;
+
+    std::unique_ptr<SPAN_LINE_READER>          m_reader;
+    std::unique_ptr<PCB_IO_KICAD_SEXPR_PARSER> m_parser;
+    std::vector<BOARD_ITEM*>                   m_items;
+    std::exception_ptr                         m_error;
+};
+
+
+struct PCB_IO_KICAD_SEXPR_PARSER::CONCURRENT_LOAD
+{
+    ~CONCURRENT_LOAD()
+    {
+        // Make sure no other thread still parses a chunk, and free the chunks which were not
+        // attached because the board parser stopped early
+        for( const std::shared_ptr<CONCURRENT_CHUNK>& chunk : m_chunks )
+        {
+            if( chunk->m_claimed.exchange( true ) )
+            {
+                std::unique_lock<std::mutex> lock( chunk->m_mutex );
+                chunk->m_condition.wait( lock, [&]() { return chunk->m_done; } );
+            }
+
+            for( BOARD_ITEM* item : chunk->m_items )
+                delete item;
+
+            chunk->m_items.clear();
+            chunk->m_parser.reset();
+            chunk->m_reader.reset();
+        }
+    }
+
+    std::vector<std::shared_ptr<CONCURRENT_CHUNK>> m_chunks;
+    std::shared_ptr<std::atomic<size_t>>           m_nextClaim =
+                                                        std::make_shared<std::atomic<size_t>>( 0 );
+    size_t                                         m_nextAttach = 0;
+    bool                                           m_started = false;
+};
+
+
+std::unique_ptr<PCB_IO_KICAD_SEXPR_PARSER::CONCURRENT_LOAD>
+PCB_IO_KICAD_SEXPR_PARSER::scanConcurrentChunks()
+{
+    SPAN_LINE_READER* spanReader = dynamic_cast<SPAN_LINE_READER*>( reader );
+
+    // Older boards can need fixups which are not safe to make concurrently
+    if( !ADVANCED_CFG::GetCfg().m_ConcurrentBoardLoad || !spanReader
+            || m_requiredVersion < 20211014 )
+    {
+        return nullptr;
+    }
+
+    const char* end = spanReader->End();
+
+    // The current line has to be read in place for positions in it to mean anything
+    if( start < spanReader->Begin() || start >= end
+            || size_t( end - next ) < m_minConcurrentBoardBytes )
+    {
+        return nullptr;
+    }
+
+    const size_t chunkBytes = std::max( m_minConcurrentChunkBytes,
+                                        size_t( end - next )
+                                                / ( GetKiCadThreadPool().get_thread_count() * 4 ) );
+
+    enum ITEM_KIND
+    {
+        IK_CONCURRENT,      ///< footprint, segment, via or zone
+        IK_SEQUENTIAL,      ///< another board item, parsed by the board parser
+        IK_SETTINGS         ///< anything else, which the items might depend on
+    };
+
+    auto itemKind =
+            []( std::string_view aKeyword ) -> ITEM_KIND
+            {
+                static const std::string_view concurrent[] = { "footprint", "segment", "via",
+                                                               "zone" };
+                static const std::string_view sequential[] = {
+                    "arc", "gr_arc", "gr_curve", "gr_line", "gr_poly", "gr_circle", "gr_rect",
+                    "image", "gr_text", "gr_text_box", "table", "dimension", "group",
+                    "generated", "target", "embedded_fonts", "embedded_files", "property",
+                    "module"
+                };
+
+                for( std::string_view keyword : concurrent )
+                {
+                    if( aKeyword == keyword )
+                        return IK_CONCURRENT;
+                }
+
+                for( std::string_view keyword : sequential )
+                {
+                    if( aKeyword == keyword )
+                        return IK_SEQUENTIAL;
+                }
+
+                return IK_SETTINGS;
+            };
+
+    auto isSpace =
+            []( char cc )
+            {
+                return cc == ' ' || cc == '\t' || cc == '\r' || cc == '\n' || cc == '\0';
+            };
+
+    std::unique_ptr<CONCURRENT_LOAD> load = std::make_unique<CONCURRENT_LOAD>();
+    CONCURRENT_CHUNK*                chunk = nullptr;   // the chunk which can still grow
+
+    unsigned    lineNumber = reader->LineNumber();
+    const char* lineStart = start;
+    int         depth = 1;          // inside (kicad_pcb
+    bool        inSymbol = false;   // a '"' inside a symbol does not start a string
+
+    const char* itemParen = nullptr;
+    const char* itemBegin = nullptr;
+    unsigned    itemLine = 0;
+    ITEM_KIND   itemKindFound = IK_SETTINGS;
+
+    // Tokenize just enough to match the parentheses the way the lexer does: quoted strings end
+    // on their line and lines starting with a '#' are comments
+    for( const char* p = next; p < end; ++p )
+    {
+        switch( *p )
+        {
+        case '\n':
+        {
+            ++lineNumber;
+            lineStart = p + 1;
+            inSymbol = false;
+
+            const char* q = lineStart;
+
+            while( q < end && *q != '\n' && isSpace( *q ) )
+                ++q;
+
+            if( q < end && *q == '#' )
+            {
+                const char* nl = static_cast<const char*>( memchr( q, '\n', end - q ) );
+
+                if( !nl )
+                    return nullptr;
+
+                p = nl - 1;
+            }
+
+            break;
+        }
+
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\0':
+        case '|':
+            inSymbol = false;
+            break;
+
+        case '"':
+            if( inSymbol )
+                break;
+
+            for( ++p; p < end && *p != '"'; ++p )
+            {
+                if( *p == '\n' )
+                    return nullptr;
+
+                if( *p == '\\' )
+                {
+                    if( p + 1 >= end || p[1] == '\n' )
+                        return nullptr;
+
+                    ++p;
+                }
+            }
+
+            if( p >= end )
+                return nullptr;
+
+            break;
+
+        case '(':
+            inSymbol = false;
+
+            if( depth++ == 1 )
+            {
+                const char* keyword = p + 1;
+                const char* keywordEnd = keyword;
+
+                while( keywordEnd < end && !isSpace( *keywordEnd ) && *keywordEnd != '('
+                       && *keywordEnd != ')' && *keywordEnd != '"' && *keywordEnd != '|' )
+                {
+                    ++keywordEnd;
+                }
+
+                itemParen = p;
+                itemBegin = std::all_of( lineStart, p, isSpace ) ? lineStart : p;
+                itemLine = lineNumber;
+                itemKindFound = itemKind( std::string_view( keyword, keywordEnd - keyword ) );
+            }
+
+            break;
+
+        case ')':
+            inSymbol = false;
+
+            if( --depth == 0 )
+            {
+                // The end of the board.  Seeking past the last chunk needs a newline after it.
+                if( chunk && !memchr( chunk->m_end, '\n', end - chunk->m_end ) )
+                    load->m_chunks.pop_back();
+
+                if( load->m_chunks.size() < 2 )
+                    return nullptr;
+
+                return load;
+            }
+
+            if( depth == 1 )
+            {
+                if( itemKindFound == IK_SETTINGS )
+                {
+                    load->m_chunks.clear();
+                    chunk = nullptr;
+                }
+                else if( itemKindFound == IK_SEQUENTIAL )
+                {
+                    chunk = nullptr;
+                }
+                else if( chunk && size_t( chunk->m_end - chunk->m_begin ) < chunkBytes )
+                {
+                    chunk->m_end = p + 1;
+                }
+                else
+                {
+                    load->m_chunks.push_back( std::make_shared<CONCURRENT_CHUNK>() );
+                    chunk = load->m_chunks.back().get();
+                    chunk->m_begin = itemBegin;
+                    chunk->m_firstItem = itemParen;
+                    chunk->m_end = p + 1;
+                    chunk->m_lineNumber = itemLine - 1;
+                    chunk->m_source = CurSource();
+                }
+            }
+
+            break;
+
+        default:
+            inSymbol = true;
+            break;
+        }
+    }
+
+    // The board is not closed, which the board parser will report
+    return nullptr;
+}
+
+
+bool PCB_IO_KICAD_SEXPR_PARSER::attachConcurrentChunk( CONCURRENT_LOAD& aLoad,
+                                                       std::vector<BOARD_ITEM*>& aBulkAdded )
+{
+    if( aLoad.m_nextAttach >= aLoad.m_chunks.size()
+            || CurPos() != aLoad.m_chunks[aLoad.m_nextAttach]->m_firstItem )
+    {
+        return false;
+    }
+
+    if( !aLoad.m_started )
+    {
+        // Everything the chunks depend on has been parsed by now.  Create what would otherwise
+        // be created lazily by several threads at once.
+        KIFONT::FONT::GetFont();
+        NETINFO_LIST::OrphanedItem();
+
+        m_deferBoardChanges = true;
+        aLoad.m_started = true;
+
+        thread_pool& tp = GetKiCadThreadPool();
+        size_t       workers = std::min<size_t>( tp.get_thread_count(), aLoad.m_chunks.size() );
+
+        for( size_t ii = 0; ii < workers; ++ii )
+        {
+            tp.push_task(
+                    [this, chunks = aLoad.m_chunks, nextClaim = aLoad.m_nextClaim]()
+                    {
+                        size_t jj;
+
+                        while( ( jj = ( *nextClaim )++ ) < chunks.size() )
+                        {
+                            // This parser is only used once the chunk is claimed, which can
+                            // no longer happen after it is gone
+                            if( !chunks[jj]->m_claimed.exchange( true ) )
+                                parseConcurrentChunk( *chunks[jj] );
+                        }
+                    } );
+        }
+    }
+
+    std::shared_ptr<CONCURRENT_CHUNK> chunk = aLoad.m_chunks[aLoad.m_nextAttach++];
+
+    // Rather than wait for a thread which has not got to this chunk yet, parse it here
+    if( !chunk->m_claimed.exchange( true ) )
+    {
+        parseConcurrentChunk( *chunk );
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock( chunk->m_mutex );
+        chunk->m_condition.wait( lock, [&]() { return chunk->m_done; } );
+    }
+
+    // Parse the items of a chunk which failed here, so that any error is reported exactly as
+    // without the concurrent load
+    if( chunk->m_error )
+        return false;
+
+    for( BOARD_ITEM* item : chunk->m_items )
+    {
+        m_board->Add( item, ADD_MODE::BULK_APPEND, true );
+        aBulkAdded.push_back( item );
+    }
+
+    chunk->m_items.clear();
+
+    PCB_IO_KICAD_SEXPR_PARSER& parser = *chunk->m_parser;
+
+    m_groupInfos.insert( m_groupInfos.end(), parser.m_groupInfos.begin(),
+                         parser.m_groupInfos.end() );
+    m_generatorInfos.insert( m_generatorInfos.end(), parser.m_generatorInfos.begin(),
+                             parser.m_generatorInfos.end() );
+    m_deferredZoneNets.insert( m_deferredZoneNets.end(), parser.m_deferredZoneNets.begin(),
+                               parser.m_deferredZoneNets.end() );
+    m_fontTextMap.merge( parser.m_fontTextMap );
+    m_undefinedLayers.merge( parser.m_undefinedLayers );
+    m_resetKIIDMap.merge( parser.m_resetKIIDMap );
+    m_deferredLegacyTeardrops |= parser.m_deferredLegacyTeardrops;
+
+    chunk->m_parser.reset();
+    chunk->m_reader.reset();
+
+    SeekSpan( chunk->m_end );
+
+    return true;
+}
+
+
+void PCB_IO_KICAD_SEXPR_PARSER::parseConcurrentChunk( CONCURRENT_CHUNK& aChunk )
+{
+    try
+    {
+        aChunk.m_reader = std::make_unique<SPAN_LINE_READER>( aChunk.m_begin, aChunk.m_end,
+                                                              aChunk.m_source,
+                                                              aChunk.m_lineNumber );
+        aChunk.m_parser = std::make_unique<PCB_IO_KICAD_SEXPR_PARSER>( aChunk.m_reader.get(),
+                                                                       m_board,
+                                                                       m_queryUserCallback );
+
+        // None of these change once the items are reached
+        PCB_IO_KICAD_SEXPR_PARSER& parser = *aChunk.m_parser;
+        parser.m_layerIndices = m_layerIndices;
+        parser.m_layerMasks = m_layerMasks;
+        parser.m_netCodes = m_netCodes;
+        parser.m_tooRecent = m_tooRecent;
+        parser.m_requiredVersion = m_requiredVersion;
+        parser.m_generatorVersion = m_generatorVersion;
+        parser.m_appendToExisting = m_appendToExisting;
+        parser.m_deferBoardChanges = true;
+
+        parser.parseChunkItems( aChunk.m_items );
+    }
+    catch( ... )
+    {
+        for( BOARD_ITEM* item : aChunk.m_items )
+            delete item;
+
+        aChunk.m_items.clear();
+        aChunk.m_error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( aChunk.m_mutex );
+        aChunk.m_done = true;
+    }
+
+    aChunk.m_condition.notify_all();
+}
+
+
+void PCB_IO_KICAD_SEXPR_PARSER::parseChunkItems( std::vector<BOARD_ITEM*>& aItems )
+{
+    for( T token = NextTok(); token != T_EOF; token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        switch( NextTok() )
+        {
+        case T_footprint: aItems.push_back( parseFOOTPRINT() );     break;
+        case T_segment:   aItems.push_back( parsePCB_TRACK() );     break;
+        case T_via:       aItems.push_back( parsePCB_VIA() );       break;
+        case T_zone:      aItems.push_back( parseZONE( m_board ) ); break;
+        default:          Expecting( "footprint, segment, via or zone" );
+        }
+    }
+}
+
+
 void PCB_IO_KICAD_SEXPR_PARSER::resolveGroups( BOARD_ITEM* aParent )
 {
     auto getItem =
@@ -6600,34 +7055,21 @@ ZONE* PCB_IO_KICAD_SEXPR_PARSER::parseZONE( BOARD_ITEM_CONTAINER* aParent )
         zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
 
     // Ensure the zone net name is valid, and matches the net code, for copper zones
-    if( zone_has_net
-        && ( !zone->GetNet() || zone->GetNet()->GetNetname() != netnameFromfile ) )
+    if( zone_has_net )
     {
-        // Can happens which old boards, with nonexistent nets ...
-        // or after being edited by hand
-        // We try to fix the mismatch.
-        NETINFO_ITEM* net = m_board->FindNet( netnameFromfile );
-
-        if( net )   // An existing net has the same net name. use it for the zone
-        {
-            zone->SetNetCode( net->GetNetCode() );
-        }
-        else    // Not existing net: add a new net to keep trace of the zone netname
-        {
-            int newnetcode = m_board->GetNetCount();
-            net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
-            m_board->Add( net, ADD_MODE::INSERT, true );
-
-            // Store the new code mapping
-            pushValueIntoMap( newnetcode, net->GetNetCode() );
-
-            // and update the zone netcode
-            zone->SetNetCode( net->GetNetCode() );
-        }
+        if( m_deferBoardChanges )
+            m_deferredZoneNets.emplace_back( zone.get(), netnameFromfile );
+        else
+            fixupZoneNet( zone.get(), netnameFromfile );
     }
 
     if( zone->IsTeardropArea() && m_requiredVersion < 20230517 )
-        m_board->SetLegacyTeardrops( true );
+    {
+        if( m_deferBoardChanges )
+            m_deferredLegacyTeardrops = true;
+        else
+            m_board->SetLegacyTeardrops( true );
+    }
 
     // Clear flags used in zone edition:
     zone->SetNeedRefill( false );
@@ -6636,6 +7078,35 @@ ZONE* PCB_IO_KICAD_SEXPR_PARSER::parseZONE( BOARD_ITEM_CONTAINER* aParent )
 }
 
 
+void PCB_IO_KICAD_SEXPR_PARSER::fixupZoneNet( ZONE* aZone, const wxString& aNetName )
+{
+    if( aZone->GetNet() && aZone->GetNet()->GetNetname() == aNetName )
+        return;
+
+    // Can happens which old boards, with nonexistent nets ...
+    // or after being edited by hand
+    // We try to fix the mismatch.
+    NETINFO_ITEM* net = m_board->FindNet( aNetName );
+
+    if( net )   // An existing net has the same net name. use it for the zone
+    {
+        aZone->SetNetCode( net->GetNetCode() );
+    }
+    else    // Not existing net: add a new net to keep trace of the zone netname
+    {
+        int newnetcode = m_board->GetNetCount();
+        net = new NETINFO_ITEM( m_board, aNetName, newnetcode );
+        m_board->Add( net, ADD_MODE::INSERT, true );
+
+        // Store the new code mapping
+        pushValueIntoMap( newnetcode, net->GetNetCode() );
+
+        // and update the zone netcode
+        aZone->SetNetCode( net->GetNetCode() );
+    }
+}
+
+
 PCB_TARGET* PCB_IO_KICAD_SEXPR_PARSER::parsePCB_TARGET()
 {
     wxCHECK_MSG( CurTok() == T_target, nullptr,
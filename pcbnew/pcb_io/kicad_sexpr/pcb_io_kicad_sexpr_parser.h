@@ -40,6 +40,7 @@
 #include <string_any_map.h>
 
 #include <chrono>
+#include <memory>
 #include <unordered_map>
 
 
@@ -85,7 +86,11 @@ public:
         m_progressReporter( aProgressReporter ),
         m_lastProgressTime( std::chrono::steady_clock::now() ),
         m_lineCount( aLineCount ),
-        m_queryUserCallback( std::move( aQueryUserCallback ) )
+        m_queryUserCallback( std::move( aQueryUserCallback ) ),
+        m_minConcurrentBoardBytes( 1024 * 1024 ),
+        m_minConcurrentChunkBytes( 128 * 1024 ),
+        m_deferBoardChanges( false ),
+        m_deferredLegacyTeardrops( false )
     {
         init();
     }
@@ -122,6 +127,19 @@ public:
      */
     bool IsValidBoardHeader();
 
+    /**
+     * Set how much text a board needs after its settings to be parsed concurrently, and the
+     * least amount of it handed to another thread in one go.
+     *
+     * The defaults only spread large boards over the thread pool; tests lower them to run
+     * small boards through the concurrent path.
+     */
+    void SetConcurrentLoadThresholds( size_t aMinBoardBytes, size_t aMinChunkBytes )
+    {
+        m_minConcurrentBoardBytes = aMinBoardBytes;
+        m_minConcurrentChunkBytes = aMinChunkBytes;
+    }
+
 private:
 
     // Group membership info refers to other Uuids in the file.
@@ -241,6 +259,42 @@ private:
     // Parse a board, but do not replace PARSE_ERROR with FUTURE_FORMAT_ERROR automatically.
     BOARD*      parseBOARD_unchecked();
 
+    struct CONCURRENT_CHUNK;
+    struct CONCURRENT_LOAD;
+
+    /**
+     * Find the runs of top-level footprints, tracks, vias and zones which follow the last
+     * section of board settings, so that they can be parsed concurrently.
+     *
+     * @return nullptr unless the board is read in place from a #SPAN_LINE_READER and is large
+     *         enough to be worth it.
+     */
+    std::unique_ptr<CONCURRENT_LOAD> scanConcurrentChunks();
+
+    /**
+     * If the current item starts the next chunk of @a aLoad, add the items parsed from the
+     * chunk to the board and continue after it.
+     *
+     * @return false if the current item has to be parsed here.
+     */
+    bool attachConcurrentChunk( CONCURRENT_LOAD& aLoad, std::vector<BOARD_ITEM*>& aBulkAdded );
+
+    /**
+     * Parse @a aChunk with a parser of its own which is set up like this one.
+     */
+    void parseConcurrentChunk( CONCURRENT_CHUNK& aChunk );
+
+    /**
+     * Parse the items of a chunk, when this is the parser of the chunk.
+     */
+    void parseChunkItems( std::vector<BOARD_ITEM*>& aItems );
+
+    /**
+     * Make the net of a copper zone match the net name read from the file, adding the net
+     * to the board if there is none by that name.
+     */
+    void fixupZoneNet( ZONE* aZone, const wxString& aNetName );
+
     /**
      * Parse the current token for the layer definition of a #BOARD_ITEM object.
      *
@@ -413,6 +467,19 @@ private:
     std::vector<GENERATOR_INFO> m_generatorInfos;
 
     std::function<bool( wxString aTitle, int aIcon, wxString aMsg, wxString aAction )> m_queryUserCallback;
+
+    ///< Boards with less text than this after their settings are parsed faster than the
+    ///< threads can be set up.
+    size_t                                   m_minConcurrentBoardBytes;
+
+    ///< The least amount of text handed to another thread in one go.
+    size_t                                   m_minConcurrentChunkBytes;
+
+    ///< Set while items are parsed concurrently.  Changes to the board which the other parsers
+    ///< could see are recorded below instead, and made once they are done.
+    bool                                     m_deferBoardChanges;
+    std::vector<std::pair<ZONE*, wxString>>  m_deferredZoneNets;
+    bool                                     m_deferredLegacyTeardrops;
 };
 
 
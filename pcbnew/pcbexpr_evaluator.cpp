@@ -200,6 +200,17 @@ protected:
 };
 
 
+void PCBEXPR_VAR_REF::AddAllowedClass( TYPE_ID type_hash, PROPERTY_BASE* prop )
+{
+    m_matchingTypes[type_hash] = prop;
+
+    m_isPinType = prop->Name() == wxT( "Pin Type" );
+    m_isLayer = prop->Name() == wxT( "Layer" )
+                    || prop->Name() == wxT( "Layer Top" )
+                    || prop->Name() == wxT( "Layer Bottom" );
+}
+
+
 LIBEVAL::VALUE* PCBEXPR_VAR_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 {
     PCBEXPR_CONTEXT* context = static_cast<PCBEXPR_CONTEXT*>( aCtx );
@@ -236,7 +247,7 @@ LIBEVAL::VALUE* PCBEXPR_VAR_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
             {
                 str = item->Get<wxString>( it->second );
 
-                if( it->second->Name() == wxT( "Pin Type" ) )
+                if( m_isPinType )
                     return new PCBEXPR_PINTYPE_VALUE( str );
                 else
                     return new LIBEVAL::VALUE( str );
@@ -246,9 +257,7 @@ LIBEVAL::VALUE* PCBEXPR_VAR_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
                 const wxAny& any = item->Get( it->second );
                 PCB_LAYER_ID layer;
 
-                if( it->second->Name() == wxT( "Layer" )
-                        || it->second->Name() == wxT( "Layer Top" )
-                        || it->second->Name() == wxT( "Layer Bottom" ) )
+                if( m_isLayer )
                 {
                     if( any.GetAs<PCB_LAYER_ID>( &layer ) )
                         return new PCBEXPR_LAYER_VALUE( layer );
@@ -304,8 +313,15 @@ LIBEVAL::VALUE* PCBEXPR_TYPE_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 LIBEVAL::FUNC_CALL_REF PCBEXPR_UCODE::CreateFuncCall( const wxString& aName )
 {
     PCBEXPR_BUILTIN_FUNCTIONS& registry = PCBEXPR_BUILTIN_FUNCTIONS::Instance();
+    wxString                   name = aName.Lower();
+
+    // Everything else may look at geometry or at other item properties
+    if( name == wxT( "indiffpair" ) )
+        m_netDependent = true;
+    else if( name != wxT( "hasnetclass" ) )
+        m_cacheable = false;
 
-    return registry.Get( aName.Lower() );
+    return registry.Get( name );
 }
 
 
@@ -328,6 +344,8 @@ std::unique_ptr<LIBEVAL::VAR_REF> PCBEXPR_UCODE::CreateVarRef( const wxString& a
     }
     else if( aField.CmpNoCase( wxT( "NetName" ) ) == 0 )
     {
+        m_netDependent = true;
+
         if( aVar == wxT( "A" ) )
             return std::make_unique<PCBEXPR_NETNAME_REF>( 0 );
         else if( aVar == wxT( "B" ) )
@@ -345,6 +363,11 @@ std::unique_ptr<LIBEVAL::VAR_REF> PCBEXPR_UCODE::CreateVarRef( const wxString& a
             return nullptr;
     }
 
+    // Bare object references are only used for method calls, which are vetted above.  Any
+    // other property might differ between items of the same type and net.
+    if( aField.length() > 0 )
+        m_cacheable = false;
+
     if( aVar == wxT( "A" ) || aVar == wxT( "AB" ) )
         vref = std::make_unique<PCBEXPR_VAR_REF>( 0 );
     else if( aVar == wxT( "B" ) )
@@ -46,6 +46,21 @@ public:
     virtual std::unique_ptr<LIBEVAL::VAR_REF> CreateVarRef( const wxString& aVar,
                                                             const wxString& aField ) override;
     virtual LIBEVAL::FUNC_CALL_REF CreateFuncCall( const wxString& aName ) override;
+
+    /**
+     * @return true if the compiled expression depends only on the layer and on the type, net
+     *         and netclass of the items it's run against, so its result can be cached on those.
+     */
+    bool IsCacheable() const { return m_cacheable; }
+
+    /**
+     * @return true if a cacheable expression looks at net names rather than just netclasses.
+     */
+    bool DependsOnNet() const { return m_netDependent; }
+
+private:
+    bool m_cacheable = true;
+    bool m_netDependent = false;
 };
 
 
@@ -85,7 +100,9 @@ public:
     PCBEXPR_VAR_REF( int aItemIndex ) :
             m_itemIndex( aItemIndex ),
             m_type( LIBEVAL::VT_UNDEFINED ),
-            m_isEnum( false )
+            m_isEnum( false ),
+            m_isPinType( false ),
+            m_isLayer( false )
     {}
 
     ~PCBEXPR_VAR_REF() {};
@@ -96,10 +113,7 @@ public:
     void SetType( LIBEVAL::VAR_TYPE_T type ) { m_type = type; }
     LIBEVAL::VAR_TYPE_T GetType() const override { return m_type; }
 
-    void AddAllowedClass( TYPE_ID type_hash, PROPERTY_BASE* prop )
-    {
-        m_matchingTypes[type_hash] = prop;
-    }
+    void AddAllowedClass( TYPE_ID type_hash, PROPERTY_BASE* prop );
 
     LIBEVAL::VALUE* GetValue( LIBEVAL::CONTEXT* aCtx ) override;
 
@@ -110,6 +124,10 @@ private:
     int                                         m_itemIndex;
     LIBEVAL::VAR_TYPE_T                         m_type;
     bool                                        m_isEnum;
+
+    // All the matching properties share a name, so these are worked out once at compile time
+    bool                                        m_isPinType;
+    bool                                        m_isLayer;
 };
 
 
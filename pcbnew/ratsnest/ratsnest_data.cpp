@@ -38,9 +38,13 @@
 #include <functional>
 using namespace std::placeholders;
 
+#include <advanced_config.h>
+
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <limits>
+#include <numeric>
 
 #include <delaunator.hpp>
 
@@ -107,52 +111,94 @@ private:
 };
 
 
-void RN_NET::kruskalMST( const std::vector<CN_EDGE> &aEdges )
+void RN_NET::kruskalMST( const std::vector<NODE_EDGE>& aEdges )
 {
-    disjoint_set dset( m_nodes.size() );
+    disjoint_set      dset( m_nodes.size() );
+    std::vector<bool> usable( m_nodes.size() );
+    size_t            joined = 0;
 
     m_rnEdges.clear();
 
-    int i = 0;
-
-    for( const std::shared_ptr<CN_ANCHOR>& node : m_nodes )
-        node->SetTag( i++ );
+    for( size_t i = 0; i < m_nodes.size(); i++ )
+        usable[i] = !m_nodes[i]->Dirty();
 
-    for( const CN_EDGE& tmp : aEdges )
+    for( const NODE_EDGE& tmp : aEdges )
     {
-        const std::shared_ptr<const CN_ANCHOR>& source = tmp.GetSourceNode();
-        const std::shared_ptr<const CN_ANCHOR>& target = tmp.GetTargetNode();
+        wxCHECK2( usable[tmp.m_source] && usable[tmp.m_target], continue );
 
-        wxCHECK2( source && !source->Dirty() && target && !target->Dirty(), continue );
-
-        if( dset.unite( source->GetTag(), target->GetTag() ) )
+        if( dset.unite( tmp.m_source, tmp.m_target ) )
         {
-            if( tmp.GetWeight() > 0 )
-                m_rnEdges.push_back( tmp );
+            if( tmp.m_weight > 0 )
+            {
+                m_rnEdges.emplace_back( m_nodes[tmp.m_source], m_nodes[tmp.m_target],
+                                        tmp.m_weight );
+            }
+
+            // A spanning tree is complete once every node has been joined
+            if( ++joined == m_nodes.size() - 1 )
+                break;
         }
     }
 }
 
 
+/**
+ * Candidate edges for the minimum spanning tree of a net.
+ *
+ * The Delaunay triangulation of the net's distinct anchor positions is kept between updates.
+ * When only a few positions have been added or removed since it was built (a moved footprint
+ * or a new track on a large power net, for instance), the candidate edges are patched locally
+ * instead of triangulating the whole net again:
+ *  - triangulation edges between surviving positions are kept as they are,
+ *  - the hole left by each group of adjacent removed positions is re-triangulated from the
+ *    surviving positions around it,
+ *  - each new position is joined to its nearest neighbour in each of six 60 degree cones.
+ *
+ * The patched edges are no longer a triangulation, but for any split of the positions into
+ * two sets they still hold a shortest edge crossing between them, so the spanning tree built
+ * from them is the same as the one built from a full triangulation.
+ */
 class RN_NET::TRIANGULATOR_STATE
 {
 private:
-    std::multiset<std::shared_ptr<CN_ANCHOR>, CN_PTR_CMP> m_allNodes;
+    struct POINT_EDGE
+    {
+        int m_a;
+        int m_b;
+    };
+
+    ///< Distinct positions of the last full triangulation, in CN_PTR_CMP order.
+    std::vector<VECTOR2I>   m_basePoints;
 
+    ///< Edges of the last full triangulation, as indices into m_basePoints.
+    std::vector<POINT_EDGE> m_baseEdges;
 
-    // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
-    // have unique coordinates!
-    bool areNodesColinear( const std::vector<std::shared_ptr<CN_ANCHOR>>& aNodes ) const
+    ///< Neighbours of each base point in the triangulation (compressed row storage).
+    std::vector<int>        m_baseAdjStart;
+    std::vector<int>        m_baseAdj;
+
+    static bool lessPos( const VECTOR2I& aFirst, const VECTOR2I& aSecond )
     {
-        if ( aNodes.size() <= 2 )
+        if( aFirst.x == aSecond.x )
+            return aFirst.y < aSecond.y;
+        else
+            return aFirst.x < aSecond.x;
+    }
+
+    // Checks if all points in aIndices lie on a single line. Requires the points to have unique
+    // coordinates!
+    static bool arePointsColinear( const std::vector<VECTOR2I>& aPoints,
+                                   const std::vector<int>& aIndices )
+    {
+        if( aIndices.size() <= 2 )
             return true;
 
-        const VECTOR2I p0( aNodes[0]->Pos() );
-        const VECTOR2I v0( aNodes[1]->Pos() - p0 );
+        const VECTOR2I p0( aPoints[aIndices[0]] );
+        const VECTOR2I v0( aPoints[aIndices[1]] - p0 );
 
-        for( unsigned i = 2; i < aNodes.size(); i++ )
+        for( unsigned i = 2; i < aIndices.size(); i++ )
         {
-            const VECTOR2I v1 = aNodes[i]->Pos() - p0;
+            const VECTOR2I v1 = aPoints[aIndices[i]] - p0;
 
             if( v0.Cross( v1 ) != 0 )
                 return false;
@@ -161,100 +207,296 @@ private:
         return true;
     }
 
-public:
-
-    void Clear()
+    /**
+     * Append the edges of the Delaunay triangulation of a subset of points.
+     *
+     * @param aIndices indices into \a aPoints, in ascending order.
+     */
+    static void triangulate( const std::vector<VECTOR2I>& aPoints,
+                             const std::vector<int>& aIndices, std::vector<POINT_EDGE>& aEdges )
     {
-        m_allNodes.clear();
+        if( aIndices.size() < 2 )
+        {
+            return;
+        }
+        else if( arePointsColinear( aPoints, aIndices ) )
+        {
+            // special case: all points are on the same line - there's no triangulation for
+            // such set.  As they are sorted along the line, chain them together.
+            for( size_t i = 0; i < aIndices.size() - 1; i++ )
+                aEdges.push_back( { aIndices[i], aIndices[i + 1] } );
+
+            return;
+        }
+
+        std::vector<double> coords;
+        coords.reserve( 2 * aIndices.size() );
+
+        for( int idx : aIndices )
+        {
+            coords.push_back( aPoints[idx].x );
+            coords.push_back( aPoints[idx].y );
+        }
+
+        delaunator::Delaunator delaunator( coords );
+        const std::vector<size_t>& triangles = delaunator.triangles;
+        const std::vector<size_t>& halfedges = delaunator.halfedges;
+
+        for( size_t i = 0; i < triangles.size(); i++ )
+        {
+            // Inner edges have two half edges; only take the first one
+            if( halfedges[i] != delaunator::INVALID_INDEX && halfedges[i] < i )
+                continue;
+
+            size_t next = ( i % 3 == 2 ) ? i - 2 : i + 1;
+
+            aEdges.push_back( { aIndices[triangles[i]], aIndices[triangles[next]] } );
+        }
     }
 
-    void AddNode( const std::shared_ptr<CN_ANCHOR>& aNode )
+    static int coneIndex( const VECTOR2I& aDelta )
     {
-        m_allNodes.insert( aNode );
+        double angle = std::atan2( (double) aDelta.y, (double) aDelta.x ) + M_PI;
+
+        return std::min( 5, (int) ( angle * 3.0 / M_PI ) );
     }
 
-    void Triangulate( std::vector<CN_EDGE>& mstEdges )
+    void rebuild( const std::vector<VECTOR2I>& aPoints )
     {
-        std::vector<double>                                    node_pts;
-        std::vector<std::shared_ptr<CN_ANCHOR>>                anchors;
-        std::vector< std::vector<std::shared_ptr<CN_ANCHOR>> > anchorChains( m_allNodes.size() );
+        std::vector<int> all( aPoints.size() );
+        std::iota( all.begin(), all.end(), 0 );
 
-        node_pts.reserve( 2 * m_allNodes.size() );
-        anchors.reserve( m_allNodes.size() );
+        m_basePoints = aPoints;
+        m_baseEdges.clear();
+        triangulate( m_basePoints, all, m_baseEdges );
 
-        auto addEdge =
-                [&]( const std::shared_ptr<CN_ANCHOR>& src, const std::shared_ptr<CN_ANCHOR>& dst )
-                {
-                    mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
-                };
+        m_baseAdjStart.assign( m_basePoints.size() + 1, 0 );
+
+        for( const POINT_EDGE& edge : m_baseEdges )
+        {
+            m_baseAdjStart[edge.m_a + 1]++;
+            m_baseAdjStart[edge.m_b + 1]++;
+        }
+
+        std::partial_sum( m_baseAdjStart.begin(), m_baseAdjStart.end(), m_baseAdjStart.begin() );
 
-        std::shared_ptr<CN_ANCHOR> prev = nullptr;
+        std::vector<int> fill( m_baseAdjStart.begin(), m_baseAdjStart.end() - 1 );
+        m_baseAdj.resize( 2 * m_baseEdges.size() );
 
-        for( const std::shared_ptr<CN_ANCHOR>& n : m_allNodes )
+        for( const POINT_EDGE& edge : m_baseEdges )
         {
-            if( !prev || prev->Pos() != n->Pos() )
+            m_baseAdj[fill[edge.m_a]++] = edge.m_b;
+            m_baseAdj[fill[edge.m_b]++] = edge.m_a;
+        }
+    }
+
+    /**
+     * Patch the base triangulation for the current points.
+     *
+     * @return false if too many points have changed for patching to be worth it.
+     */
+    bool update( const std::vector<VECTOR2I>& aPoints, std::vector<POINT_EDGE>& aEdges ) const
+    {
+        std::vector<int> baseToCur( m_basePoints.size(), -1 );
+        std::vector<int> added;
+        size_t           ii = 0;
+        size_t           jj = 0;
+
+        // Both point lists are sorted, so they can be matched in a single pass
+        while( ii < m_basePoints.size() || jj < aPoints.size() )
+        {
+            if( jj == aPoints.size()
+                    || ( ii < m_basePoints.size() && lessPos( m_basePoints[ii], aPoints[jj] ) ) )
             {
-                node_pts.push_back( n->Pos().x );
-                node_pts.push_back( n->Pos().y );
-                anchors.push_back( n );
-                prev = n;
+                ii++;
+            }
+            else if( ii == m_basePoints.size() || lessPos( aPoints[jj], m_basePoints[ii] ) )
+            {
+                added.push_back( jj++ );
+            }
+            else
+            {
+                baseToCur[ii++] = jj++;
             }
-
-            anchorChains[anchors.size() - 1].push_back( n );
         }
 
-        if( anchors.size() < 2 )
+        size_t removed = m_basePoints.size() - ( aPoints.size() - added.size() );
+
+        if( removed + added.size() > aPoints.size() / 4 )
+            return false;
+
+        for( const POINT_EDGE& edge : m_baseEdges )
         {
-            return;
+            int a = baseToCur[edge.m_a];
+            int b = baseToCur[edge.m_b];
+
+            if( a >= 0 && b >= 0 )
+                aEdges.push_back( { a, b } );
         }
-        else if( areNodesColinear( anchors ) )
+
+        // Re-triangulate the hole left by each group of adjacent removed points from the
+        // surviving points around it.  New triangulation edges can only appear there.
+        std::vector<int> group( m_basePoints.size(), -1 );
+        std::vector<int> stack;
+        std::vector<int> boundary;
+
+        for( int first = 0; removed > 0 && first < (int) m_basePoints.size(); first++ )
         {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for( size_t i = 0; i < anchors.size() - 1; i++ )
-                addEdge( anchors[i], anchors[i + 1] );
+            if( baseToCur[first] >= 0 || group[first] >= 0 )
+                continue;
+
+            boundary.clear();
+            stack.push_back( first );
+            group[first] = first;
+
+            while( !stack.empty() )
+            {
+                int pt = stack.back();
+                stack.pop_back();
+
+                for( int k = m_baseAdjStart[pt]; k < m_baseAdjStart[pt + 1]; k++ )
+                {
+                    int neighbour = m_baseAdj[k];
+
+                    if( group[neighbour] == first )
+                        continue;
+
+                    group[neighbour] = first;
+
+                    if( baseToCur[neighbour] < 0 )
+                        stack.push_back( neighbour );
+                    else
+                        boundary.push_back( baseToCur[neighbour] );
+                }
+            }
+
+            std::sort( boundary.begin(), boundary.end() );
+            triangulate( aPoints, boundary, aEdges );
         }
-        else
+
+        // Join each added point to the nearest point in each 60 degree cone around it.  The
+        // points are sorted by x, so the search can stop once the x distance alone is larger
+        // than what has been found in every cone.
+        for( int pt : added )
         {
-            delaunator::Delaunator delaunator( node_pts );
-            auto& triangles = delaunator.triangles;
+            const VECTOR2I& pos = aPoints[pt];
+            int             nearest[6] = { -1, -1, -1, -1, -1, -1 };
+            SEG::ecoord     nearestDistSq[6];
+            SEG::ecoord     reach = VECTOR2I::ECOORD_MAX;
 
-            for( size_t i = 0; i < triangles.size(); i += 3 )
+            std::fill( std::begin( nearestDistSq ), std::end( nearestDistSq ),
+                       VECTOR2I::ECOORD_MAX );
+
+            auto visit =
+                    [&]( int aOther ) -> bool
+                    {
+                        VECTOR2I delta = aPoints[aOther] - pos;
+
+                        if( SEG::Square( delta.x ) > reach )
+                            return false;
+
+                        SEG::ecoord distSq = delta.SquaredEuclideanNorm();
+                        int         cone = coneIndex( delta );
+
+                        if( distSq < nearestDistSq[cone] )
+                        {
+                            nearest[cone] = aOther;
+                            nearestDistSq[cone] = distSq;
+                            reach = *std::max_element( std::begin( nearestDistSq ),
+                                                       std::end( nearestDistSq ) );
+                        }
+
+                        return true;
+                    };
+
+            for( int other = pt + 1; other < (int) aPoints.size() && visit( other ); other++ )
+                ;
+
+            for( int other = pt - 1; other >= 0 && visit( other ); other-- )
+                ;
+
+            for( int other : nearest )
             {
-                addEdge( anchors[triangles[i]],     anchors[triangles[i + 1]] );
-                addEdge( anchors[triangles[i + 1]], anchors[triangles[i + 2]] );
-                addEdge( anchors[triangles[i + 2]], anchors[triangles[i]]     );
+                if( other >= 0 )
+                    aEdges.push_back( { pt, other } );
             }
+        }
 
-            for( size_t i = 0; i < delaunator.halfedges.size(); i++ )
-            {
-                if( delaunator.halfedges[i] == delaunator::INVALID_INDEX )
-                    continue;
+        return true;
+    }
 
-                addEdge( anchors[triangles[i]], anchors[triangles[delaunator.halfedges[i]]] );
+public:
+    void Triangulate( const std::vector<std::shared_ptr<CN_ANCHOR>>& aNodes,
+                      std::vector<NODE_EDGE>& aEdges )
+    {
+        std::vector<VECTOR2I> points;
+        std::vector<uint32_t> firstNode;
+
+        points.reserve( aNodes.size() );
+        firstNode.reserve( aNodes.size() + 1 );
+
+        // Nodes are sorted by position, so the nodes sharing a position are consecutive
+        for( uint32_t i = 0; i < aNodes.size(); i++ )
+        {
+            if( points.empty() || points.back() != aNodes[i]->Pos() )
+            {
+                points.push_back( aNodes[i]->Pos() );
+                firstNode.push_back( i );
             }
         }
 
-        for( size_t i = 0; i < anchorChains.size(); i++ )
+        firstNode.push_back( aNodes.size() );
+
+        if( points.size() < 2 )
+            return;
+
+        auto addEdge =
+                [&]( const POINT_EDGE& aEdge )
+                {
+                    VECTOR2I delta = points[aEdge.m_a] - points[aEdge.m_b];
+
+                    aEdges.push_back( { firstNode[aEdge.m_a], firstNode[aEdge.m_b],
+                                        (uint32_t) delta.EuclideanNorm() } );
+                };
+
+        std::vector<POINT_EDGE> edges;
+
+        if( ADVANCED_CFG::GetCfg().m_IncrementalRatsnest && !m_basePoints.empty()
+                && update( points, edges ) )
+        {
+            for( const POINT_EDGE& edge : edges )
+                addEdge( edge );
+        }
+        else
         {
-            std::vector<std::shared_ptr<CN_ANCHOR>>& chain = anchorChains[i];
+            rebuild( points );
 
-            if( chain.size() < 2 )
+            for( const POINT_EDGE& edge : m_baseEdges )
+                addEdge( edge );
+        }
+
+        std::vector<uint32_t> chain;
+
+        for( size_t i = 0; i < points.size(); i++ )
+        {
+            if( firstNode[i + 1] - firstNode[i] < 2 )
                 continue;
 
+            chain.resize( firstNode[i + 1] - firstNode[i] );
+            std::iota( chain.begin(), chain.end(), firstNode[i] );
+
             std::sort( chain.begin(), chain.end(),
-                    [] ( const std::shared_ptr<CN_ANCHOR>& a, const std::shared_ptr<CN_ANCHOR>& b )
+                    [&]( uint32_t a, uint32_t b )
                     {
-                        return a->GetCluster().get() < b->GetCluster().get();
+                        return aNodes[a]->GetCluster().get() < aNodes[b]->GetCluster().get();
                     } );
 
             for( unsigned int j = 1; j < chain.size(); j++ )
             {
-                const std::shared_ptr<CN_ANCHOR>& prevNode = chain[j - 1];
-                const std::shared_ptr<CN_ANCHOR>& curNode  = chain[j];
-                int weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
-                mstEdges.emplace_back( prevNode, curNode, weight );
+                const std::shared_ptr<CN_ANCHOR>& prevNode = aNodes[chain[j - 1]];
+                const std::shared_ptr<CN_ANCHOR>& curNode  = aNodes[chain[j]];
+                uint32_t weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
+                aEdges.push_back( { chain[j - 1], chain[j], weight } );
             }
         }
     }
@@ -279,9 +521,8 @@ void RN_NET::compute()
         if( m_boardEdges.size() == 0 && m_nodes.size() == 2 )
         {
             // There can be only one possible connection, but it is missing
-            auto                              it = m_nodes.begin();
-            const std::shared_ptr<CN_ANCHOR>& source = *it++;
-            const std::shared_ptr<CN_ANCHOR>& target = *it;
+            const std::shared_ptr<CN_ANCHOR>& source = m_nodes[0];
+            const std::shared_ptr<CN_ANCHOR>& target = m_nodes[1];
 
             source->SetTag( 0 );
             target->SetTag( 1 );
@@ -298,24 +539,22 @@ void RN_NET::compute()
     }
 
 
-    m_triangulator->Clear();
-
-    for( const std::shared_ptr<CN_ANCHOR>& n : m_nodes )
-        m_triangulator->AddNode( n );
-
-    std::vector<CN_EDGE> triangEdges;
-    triangEdges.reserve( m_nodes.size() + m_boardEdges.size() );
+    std::vector<NODE_EDGE> triangEdges;
+    triangEdges.reserve( 3 * m_nodes.size() + m_boardEdges.size() );
 
 #ifdef PROFILE
     PROF_TIMER cnt( "triangulate" );
 #endif
-    m_triangulator->Triangulate( triangEdges );
+    m_triangulator->Triangulate( m_nodes, triangEdges );
 #ifdef PROFILE
     cnt.Show();
 #endif
 
-    for( const CN_EDGE& e : m_boardEdges )
-        triangEdges.emplace_back( e );
+    for( size_t i = 0; i < m_nodes.size(); i++ )
+        m_nodes[i]->SetTag( i );
+
+    for( const auto& [source, target] : m_boardEdges )
+        triangEdges.push_back( { (uint32_t) source->GetTag(), (uint32_t) target->GetTag(), 0 } );
 
     std::sort( triangEdges.begin(), triangEdges.end() );
 
@@ -331,6 +570,12 @@ void RN_NET::compute()
 
 
 void RN_NET::OptimizeRNEdges()
+{
+    OptimizeRNEdges( 0, m_rnEdges.size() );
+}
+
+
+void RN_NET::OptimizeRNEdges( size_t aFirst, size_t aLast )
 {
     auto optimizeZoneAnchor =
             [&]( const VECTOR2I& aPos, const LSET& aLayerSet,
@@ -480,8 +725,9 @@ void RN_NET::OptimizeRNEdges()
         }
     };
 
-    for( CN_EDGE& edge : m_rnEdges )
+    for( size_t ii = aFirst; ii < aLast && ii < m_rnEdges.size(); ++ii )
     {
+        CN_EDGE&                                edge = m_rnEdges[ii];
         const std::shared_ptr<const CN_ANCHOR>& source = edge.GetSourceNode();
         const std::shared_ptr<const CN_ANCHOR>& target = edge.GetTargetNode();
 
@@ -521,6 +767,9 @@ void RN_NET::OptimizeRNEdges()
 
 void RN_NET::UpdateNet()
 {
+    // Nodes sharing a position keep the order they were added in
+    std::stable_sort( m_nodes.begin(), m_nodes.end(), CN_PTR_CMP() );
+
     compute();
 
     m_dirty = false;
@@ -531,9 +780,6 @@ void RN_NET::RemoveInvalidRefs()
 {
     for( CN_EDGE& edge : m_rnEdges )
         edge.RemoveInvalidRefs();
-
-    for( CN_EDGE& edge : m_boardEdges )
-        edge.RemoveInvalidRefs();
 }
 
 
@@ -549,7 +795,7 @@ void RN_NET::Clear()
 
 void RN_NET::AddCluster( std::shared_ptr<CN_CLUSTER> aCluster )
 {
-    std::shared_ptr<CN_ANCHOR> firstAnchor;
+    CN_ANCHOR* firstAnchor = nullptr;
 
     for( CN_ITEM* item : *aCluster )
     {
@@ -562,16 +808,16 @@ void RN_NET::AddCluster( std::shared_ptr<CN_CLUSTER> aCluster )
         for( unsigned int i = 0; i < nAnchors; i++ )
         {
             anchors[i]->SetCluster( aCluster );
-            m_nodes.insert( anchors[i] );
+            m_nodes.push_back( anchors[i] );
 
             if( firstAnchor )
             {
-                if( firstAnchor != anchors[i] )
-                    m_boardEdges.emplace_back( firstAnchor, anchors[i], 0 );
+                if( firstAnchor != anchors[i].get() )
+                    m_boardEdges.emplace_back( firstAnchor, anchors[i].get() );
             }
             else
             {
-                firstAnchor = anchors[i];
+                firstAnchor = anchors[i].get();
             }
         }
     }
@@ -612,7 +858,7 @@ bool RN_NET::NearestBicoloredPair( RN_NET* aOtherNet, VECTOR2I& aPos1, VECTOR2I&
         /// Step 2: O( log n ) search to identify a close element ordered by x
         /// The fwd_it iterator will move forward through the elements while
         /// the rev_it iterator will move backward through the same set
-        auto fwd_it = m_nodes.lower_bound( nodeA );
+        auto fwd_it = std::lower_bound( m_nodes.begin(), m_nodes.end(), nodeA, CN_PTR_CMP() );
         auto rev_it = std::make_reverse_iterator( fwd_it );
 
         for( ; fwd_it != m_nodes.end(); ++fwd_it )
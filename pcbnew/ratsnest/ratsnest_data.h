@@ -35,6 +35,7 @@
 #include <core/typeinfo.h>
 #include <math/box2.h>
 
+#include <cstdint>
 #include <set>
 #include <vector>
 
@@ -87,6 +88,12 @@ public:
      */
     void OptimizeRNEdges();
 
+    /**
+     * Find optimal ends of the RNEdges in the range [aFirst, aLast).  Edges are independent
+     * of each other, so separate ranges of a net may be optimized concurrently.
+     */
+    void OptimizeRNEdges( size_t aFirst, size_t aLast );
+
     void Clear();
 
     void AddCluster( std::shared_ptr<CN_CLUSTER> aCluster );
@@ -99,18 +106,28 @@ public:
     bool NearestBicoloredPair( RN_NET* aOtherNet, VECTOR2I& aPos1, VECTOR2I& aPos2 ) const;
 
 protected:
-    ///< Recompute ratsnest from scratch.
+    ///< Recompute ratsnest, reusing the previous triangulation where possible.
     void compute();
 
+    ///< Candidate ratsnest edge, as indices into m_nodes.
+    struct NODE_EDGE
+    {
+        uint32_t m_source;
+        uint32_t m_target;
+        uint32_t m_weight;
+
+        bool operator<( const NODE_EDGE& aOther ) const { return m_weight < aOther.m_weight; }
+    };
+
     ///< Compute the minimum spanning tree using Kruskal's algorithm
-    void kruskalMST( const std::vector<CN_EDGE> &aEdges );
+    void kruskalMST( const std::vector<NODE_EDGE>& aEdges );
 
 protected:
-    ///< Vector of nodes
-    std::multiset<std::shared_ptr<CN_ANCHOR>, CN_PTR_CMP> m_nodes;
+    ///< Vector of nodes, sorted by CN_PTR_CMP when the net is updated
+    std::vector<std::shared_ptr<CN_ANCHOR>> m_nodes;
 
-    ///< Vector of edges that make pre-defined connections
-    std::vector<CN_EDGE> m_boardEdges;
+    ///< Pairs of nodes that make pre-defined connections
+    std::vector<std::pair<CN_ANCHOR*, CN_ANCHOR*>> m_boardEdges;
 
     ///< Vector of edges that makes ratsnest for a given net.
     std::vector<CN_EDGE> m_rnEdges;
@@ -120,6 +137,7 @@ protected:
 
     class TRIANGULATOR_STATE;
 
+    ///< Triangulation of the net, kept between updates.
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
 };
 
@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "pns_index.h"
 #include "pns_router.h"
 
@@ -33,8 +35,19 @@ void INDEX::Add( ITEM* aItem )
     if( m_subIndices.size() <= static_cast<size_t>( range.End() ) )
         m_subIndices.resize( 2 * range.End() + 1 ); // +1 handles the 0 case
 
-    for( int i = range.Start(); i <= range.End(); ++i )
-        m_subIndices[i].Add( aItem );
+    if( m_bulkLoading )
+    {
+        if( m_pending.size() < m_subIndices.size() )
+            m_pending.resize( m_subIndices.size() );
+
+        for( int i = range.Start(); i <= range.End(); ++i )
+            m_pending[i].push_back( aItem );
+    }
+    else
+    {
+        for( int i = range.Start(); i <= range.End(); ++i )
+            m_subIndices[i].Add( aItem );
+    }
 
     m_allItems.insert( aItem );
     NET_HANDLE net = aItem->Net();
@@ -53,13 +66,63 @@ void INDEX::Remove( ITEM* aItem )
         return;
 
     for( int i = range.Start(); i <= range.End(); ++i )
+    {
+        if( m_bulkLoading && static_cast<size_t>( i ) < m_pending.size() )
+        {
+            std::vector<ITEM*>& pending = m_pending[i];
+            pending.erase( std::remove( pending.begin(), pending.end(), aItem ), pending.end() );
+        }
+
         m_subIndices[i].Remove( aItem );
+    }
 
     m_allItems.erase( aItem );
     NET_HANDLE net = aItem->Net();
 
-    if( net && m_netMap.find( net ) != m_netMap.end() )
-        m_netMap[net].remove( aItem );
+    if( net )
+    {
+        auto it = m_netMap.find( net );
+
+        if( it != m_netMap.end() )
+        {
+            NET_ITEMS_LIST& items = it->second;
+            items.erase( std::remove( items.begin(), items.end(), aItem ), items.end() );
+        }
+    }
+}
+
+
+void INDEX::Clear()
+{
+    for( ITEM_SHAPE_INDEX& subIndex : m_subIndices )
+        subIndex.RemoveAll();
+
+    m_netMap.clear();
+    m_allItems.clear();
+    m_pending.clear();
+    m_bulkLoading = false;
+}
+
+
+void INDEX::StartBulkLoad()
+{
+    // Packing replaces the contents of the trees, so only an empty index can be bulk loaded.
+    m_bulkLoading = m_allItems.empty();
+}
+
+
+void INDEX::FinishBulkLoad()
+{
+    if( !m_bulkLoading )
+        return;
+
+    m_bulkLoading = false;
+
+    for( size_t i = 0; i < m_pending.size(); ++i )
+        m_subIndices[i].BulkLoad( m_pending[i] );
+
+    m_pending.clear();
+    m_pending.shrink_to_fit();
 }
 
 
@@ -72,10 +135,12 @@ void INDEX::Replace( ITEM* aOldItem, ITEM* aNewItem )
 
 INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( NET_HANDLE aNet )
 {
-    if( m_netMap.find( aNet ) == m_netMap.end() )
+    auto it = m_netMap.find( aNet );
+
+    if( it == m_netMap.end() )
         return nullptr;
 
-    return &m_netMap[aNet];
+    return &it->second;
 }
 
 };
@@ -23,9 +23,9 @@
 #define __PNS_INDEX_H
 
 #include <deque>
-#include <list>
-#include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <layer_ids.h>
 #include <geometry/shape_index.h>
@@ -45,11 +45,13 @@ namespace PNS {
 class INDEX
 {
 public:
-    typedef std::list<ITEM*>            NET_ITEMS_LIST;
+    typedef std::vector<ITEM*>          NET_ITEMS_LIST;
     typedef SHAPE_INDEX<ITEM*>          ITEM_SHAPE_INDEX;
     typedef std::unordered_set<ITEM*>   ITEM_SET;
 
-    INDEX(){};
+    INDEX() :
+            m_bulkLoading( false )
+    {}
 
     /**
      * Adds item to the spatial index.
@@ -61,6 +63,25 @@ public:
      */
     void Remove( ITEM* aItem );
 
+    /**
+     * Removes all items, keeping the storage of the index around for reuse.
+     */
+    void Clear();
+
+    /**
+     * Defers the spatial indexing of the following Add()s until FinishBulkLoad(), which packs
+     * them into the per-layer trees in one go. Used to build the root node of the world, which
+     * is then only touched by commits.
+     *
+     * Has no effect unless the index is empty. The index must not be queried while loading.
+     */
+    void StartBulkLoad();
+
+    /**
+     * Packs the items added since StartBulkLoad() into the spatial index.
+     */
+    void FinishBulkLoad();
+
     /**
      * Replaces one item with another.
      */
@@ -122,15 +143,20 @@ private:
     int querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
 
 private:
-    std::deque<ITEM_SHAPE_INDEX>         m_subIndices;
-    std::map<NET_HANDLE, NET_ITEMS_LIST> m_netMap;
-    ITEM_SET                             m_allItems;
+    std::deque<ITEM_SHAPE_INDEX>                   m_subIndices;
+    std::unordered_map<NET_HANDLE, NET_ITEMS_LIST> m_netMap;
+    ITEM_SET                                       m_allItems;
+
+    bool                                           m_bulkLoading;
+    std::vector<std::vector<ITEM*>>                m_pending;     ///< per layer, while loading
 };
 
 
 template<class Visitor>
 int INDEX::querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const
 {
+    wxASSERT_MSG( !m_bulkLoading, wxT( "PNS::INDEX queried while bulk loading" ) );
+
     if( aIndex >= m_subIndices.size() )
         return 0;
 
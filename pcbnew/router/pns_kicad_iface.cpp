@@ -143,6 +143,33 @@ public:
 private:
     BOARD_ITEM* getBoardItem( const PNS::ITEM* aItem, int aLayer, int aIdx = 0 );
 
+    int layerClearance( const PNS::ITEM* aA, const PNS::ITEM* aB, int aLayer );
+
+    /**
+     * The clearance matrix holds the clearances between tracks, arcs, vias and via holes for
+     * every pair of netclasses and every copper layer.  It is only used when the clearance
+     * rules depend on nothing else, and is filled on first use as most of it is never needed.
+     */
+    enum MATRIX_KIND
+    {
+        MK_TRACK = 0,
+        MK_ARC,
+        MK_VIA,
+        MK_VIA_HOLE,
+        MK_COUNT
+    };
+
+    void initClearanceMatrix();
+    int  matrixKind( const PNS::ITEM* aItem ) const;
+    int  matrixNetclass( const PNS::ITEM* aItem ) const;
+    int  matrixLayer( int aLayer ) const;
+
+    /**
+     * @return the per-layer matrix entries for the pair, or nullptr if their clearance has to
+     *         be evaluated from the rules.
+     */
+    int* clearanceMatrixRow( const PNS::ITEM* aA, const PNS::ITEM* aB );
+
 private:
     PNS::ROUTER_IFACE* m_routerIface;
     BOARD*             m_board;
@@ -153,16 +180,25 @@ private:
 
     std::unordered_map<CLEARANCE_CACHE_KEY, int> m_clearanceCache;
     std::unordered_map<CLEARANCE_CACHE_KEY, int> m_tempClearanceCache;
+
+    std::unordered_map<const NETCLASS*, int>     m_matrixNetclasses;
+    int                                          m_matrixLayers;
+    std::vector<int>                             m_clearanceMatrix;
 };
 
 
+/// Boards with more netclasses than this evaluate all their clearances from the rules.
+static const int c_maxMatrixNetclasses = 32;
+
+
 PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard,
                                                     PNS::ROUTER_IFACE* aRouterIface ) :
     m_routerIface( aRouterIface ),
     m_board( aBoard ),
     m_dummyTracks{ { aBoard }, { aBoard } },
     m_dummyArcs{ { aBoard }, { aBoard } },
-    m_dummyVias{ { aBoard }, { aBoard } }
+    m_dummyVias{ { aBoard }, { aBoard } },
+    m_matrixLayers( 0 )
 {
     for( PCB_TRACK& track : m_dummyTracks )
         track.SetFlags( ROUTER_TRANSIENT );
@@ -177,6 +213,118 @@ PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard,
         m_clearanceEpsilon = aBoard->GetDesignSettings().GetDRCEpsilon();
     else
         m_clearanceEpsilon = 0;
+
+    if( aBoard && ADVANCED_CFG::GetCfg().m_RouterClearanceMatrix )
+        initClearanceMatrix();
+}
+
+
+void PNS_PCBNEW_RULE_RESOLVER::initClearanceMatrix()
+{
+    std::shared_ptr<DRC_ENGINE> drcEngine = m_board->GetDesignSettings().m_DRCEngine;
+
+    if( !drcEngine )
+        return;
+
+    for( DRC_CONSTRAINT_T type : { CLEARANCE_CONSTRAINT, HOLE_CLEARANCE_CONSTRAINT,
+                                   PHYSICAL_CLEARANCE_CONSTRAINT } )
+    {
+        if( !drcEngine->IsConstraintNetclassBased( type ) )
+            return;
+    }
+
+    for( NETINFO_ITEM* net : m_board->GetNetInfo() )
+    {
+        const NETCLASS* netclass = net->GetNetClass();
+
+        if( !m_matrixNetclasses.count( netclass ) )
+        {
+            if( (int) m_matrixNetclasses.size() == c_maxMatrixNetclasses )
+            {
+                m_matrixNetclasses.clear();
+                return;
+            }
+
+            int idx = (int) m_matrixNetclasses.size();
+            m_matrixNetclasses[ netclass ] = idx;
+        }
+    }
+
+    int netclasses = (int) m_matrixNetclasses.size();
+
+    m_matrixLayers = m_board->GetCopperLayerCount();
+    m_clearanceMatrix.assign( MK_COUNT * MK_COUNT * netclasses * netclasses * m_matrixLayers,
+                              -1 );
+}
+
+
+int PNS_PCBNEW_RULE_RESOLVER::matrixKind( const PNS::ITEM* aItem ) const
+{
+    switch( aItem->Kind() )
+    {
+    case PNS::ITEM::SEGMENT_T: return MK_TRACK;
+    case PNS::ITEM::ARC_T:     return MK_ARC;
+    case PNS::ITEM::VIA_T:     return MK_VIA;
+
+    case PNS::ITEM::HOLE_T:
+        if( aItem->ParentPadVia() && aItem->ParentPadVia()->Kind() == PNS::ITEM::VIA_T )
+            return MK_VIA_HOLE;
+
+        return -1;
+
+    default:
+        return -1;
+    }
+}
+
+
+int PNS_PCBNEW_RULE_RESOLVER::matrixNetclass( const PNS::ITEM* aItem ) const
+{
+    NETINFO_ITEM* net = static_cast<NETINFO_ITEM*>( aItem->Net() );
+
+    if( !net )
+        return -1;
+
+    auto it = m_matrixNetclasses.find( net->GetNetClass() );
+
+    return it != m_matrixNetclasses.end() ? it->second : -1;
+}
+
+
+int PNS_PCBNEW_RULE_RESOLVER::matrixLayer( int aLayer ) const
+{
+    if( aLayer == B_Cu )
+        return m_matrixLayers - 1;
+
+    if( aLayer >= F_Cu && aLayer < m_matrixLayers - 1 )
+        return aLayer;
+
+    return -1;
+}
+
+
+int* PNS_PCBNEW_RULE_RESOLVER::clearanceMatrixRow( const PNS::ITEM* aA, const PNS::ITEM* aB )
+{
+    if( m_clearanceMatrix.empty() || !aA || !aB )
+        return nullptr;
+
+    int kindA = matrixKind( aA );
+    int kindB = matrixKind( aB );
+
+    // Hole-to-hole spacing has its own rules
+    if( kindA < 0 || kindB < 0 || ( kindA == MK_VIA_HOLE && kindB == MK_VIA_HOLE ) )
+        return nullptr;
+
+    int netclassA = matrixNetclass( aA );
+    int netclassB = matrixNetclass( aB );
+
+    if( netclassA < 0 || netclassB < 0 )
+        return nullptr;
+
+    int netclasses = (int) m_matrixNetclasses.size();
+    int idx = ( ( kindA * MK_COUNT + kindB ) * netclasses + netclassA ) * netclasses + netclassB;
+
+    return &m_clearanceMatrix[ idx * m_matrixLayers ];
 }
 
 
@@ -486,9 +634,91 @@ void PNS_PCBNEW_RULE_RESOLVER::ClearTemporaryCaches()
 }
 
 
+int PNS_PCBNEW_RULE_RESOLVER::layerClearance( const PNS::ITEM* aA, const PNS::ITEM* aB,
+                                              int aLayer )
+{
+    PNS::CONSTRAINT constraint;
+    int             rv = 0;
+
+    if( IsDrilledHole( aA ) && IsDrilledHole( aB ) )
+    {
+        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_TO_HOLE, aA, aB, aLayer, &constraint ) )
+        {
+            if( constraint.m_Value.Min() > rv )
+                rv = constraint.m_Value.Min();
+        }
+    }
+    else if( isHole( aA ) || isHole( aB ) )
+    {
+        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_CLEARANCE, aA, aB, aLayer, &constraint ) )
+        {
+            if( constraint.m_Value.Min() > rv )
+                rv = constraint.m_Value.Min();
+        }
+    }
+
+    // No 'else'; plated holes get both HOLE_CLEARANCE and CLEARANCE
+    if( isCopper( aA ) && ( !aB || isCopper( aB ) ) )
+    {
+        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_CLEARANCE, aA, aB, aLayer, &constraint ) )
+        {
+            if( constraint.m_Value.Min() > rv )
+                rv = constraint.m_Value.Min();
+        }
+    }
+
+    // No 'else'; non-plated milled holes get both HOLE_CLEARANCE and EDGE_CLEARANCE
+    if( isEdge( aA ) || IsNonPlatedSlot( aA ) || isEdge( aB ) || IsNonPlatedSlot( aB ) )
+    {
+        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_EDGE_CLEARANCE, aA, aB, aLayer, &constraint ) )
+        {
+            if( constraint.m_Value.Min() > rv )
+                rv = constraint.m_Value.Min();
+        }
+    }
+
+    if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_PHYSICAL_CLEARANCE, aA, aB, aLayer, &constraint ) )
+    {
+        if( constraint.m_Value.Min() > rv )
+            rv = constraint.m_Value.Min();
+    }
+
+    return rv;
+}
+
+
 int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* aB,
                                          bool aUseClearanceEpsilon )
 {
+    // The matrix depends only on the rules and the netclasses, neither of which can change
+    // during a routing session, so it never needs to be invalidated.
+    if( int* row = clearanceMatrixRow( aA, aB ) )
+    {
+        LAYER_RANGE layers = aA->Layers().Intersection( aB->Layers() );
+        int         rv = 0;
+
+        for( int layer = layers.Start(); layer <= layers.End(); ++layer )
+        {
+            int idx = matrixLayer( layer );
+
+            if( idx < 0 )
+            {
+                rv = std::max( rv, layerClearance( aA, aB, layer ) );
+                continue;
+            }
+
+            if( row[idx] < 0 )
+                row[idx] = layerClearance( aA, aB, layer );
+
+            rv = std::max( rv, row[idx] );
+        }
+
+        if( aUseClearanceEpsilon && rv > 0 )
+            rv = std::max( 0, rv - m_clearanceEpsilon );
+
+        return rv;
+    }
+
     CLEARANCE_CACHE_KEY key = { aA, aB, aUseClearanceEpsilon };
 
     // Search cache (used for actual board items)
@@ -503,9 +733,8 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
     if( it != m_tempClearanceCache.end() )
         return it->second;
 
-    PNS::CONSTRAINT constraint;
-    int             rv = 0;
-    LAYER_RANGE     layers;
+    int         rv = 0;
+    LAYER_RANGE layers;
 
     if( !aB )
         layers = aA->Layers();
@@ -520,50 +749,7 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
     layers = layers.Intersection( LAYER_RANGE( PCBNEW_LAYER_ID_START, PCB_LAYER_ID_COUNT - 1 ) );
 
     for( int layer = layers.Start(); layer <= layers.End(); ++layer )
-    {
-        if( IsDrilledHole( aA ) && IsDrilledHole( aB ) )
-        {
-            if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_TO_HOLE, aA, aB, layer, &constraint ) )
-            {
-                if( constraint.m_Value.Min() > rv )
-                    rv = constraint.m_Value.Min();
-            }
-        }
-        else if( isHole( aA ) || isHole( aB ) )
-        {
-            if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_CLEARANCE, aA, aB, layer, &constraint ) )
-            {
-                if( constraint.m_Value.Min() > rv )
-                    rv = constraint.m_Value.Min();
-            }
-        }
-
-        // No 'else'; plated holes get both HOLE_CLEARANCE and CLEARANCE
-        if( isCopper( aA ) && ( !aB || isCopper( aB ) ) )
-        {
-            if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_CLEARANCE, aA, aB, layer, &constraint ) )
-            {
-                if( constraint.m_Value.Min() > rv )
-                    rv = constraint.m_Value.Min();
-            }
-        }
-
-        // No 'else'; non-plated milled holes get both HOLE_CLEARANCE and EDGE_CLEARANCE
-        if( isEdge( aA ) || IsNonPlatedSlot( aA ) || isEdge( aB ) || IsNonPlatedSlot( aB ) )
-        {
-            if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_EDGE_CLEARANCE, aA, aB, layer, &constraint ) )
-            {
-                if( constraint.m_Value.Min() > rv )
-                    rv = constraint.m_Value.Min();
-            }
-        }
-
-        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_PHYSICAL_CLEARANCE, aA, aB, layer, &constraint ) )
-        {
-            if( constraint.m_Value.Min() > rv )
-                rv = constraint.m_Value.Min();
-        }
-    }
+        rv = std::max( rv, layerClearance( aA, aB, layer ) );
 
     if( aUseClearanceEpsilon && rv > 0 )
         rv = std::max( 0, rv - m_clearanceEpsilon );
@@ -1535,6 +1721,7 @@ void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
     int worstClearance = m_board->GetMaxClearanceValue();
 
     m_world = aWorld;
+    aWorld->StartBulkLoad();
 
     for( BOARD_ITEM* gitem : m_board->Drawings() )
     {
@@ -1622,6 +1809,8 @@ void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
         }
     }
 
+    aWorld->FinishBulkLoad();
+
     // NB: if this were ever to become a long-lived object we would need to dirty its
     // clearance cache here....
     delete m_ruleResolver;
@@ -40,6 +40,7 @@ LOGGER::~LOGGER()
 void LOGGER::Clear()
 {
     m_events.clear();
+    m_branchStats = BRANCH_STATS();
 }
 
 
@@ -64,6 +65,16 @@ void LOGGER::Log( LOGGER::EVENT_TYPE evt, const VECTOR2I& pos, const ITEM* item,
 }
 
 
+void LOGGER::LogBranchStats( const BRANCH_STATS& aStats )
+{
+    m_branchStats.Add( aStats );
+
+    wxLogTrace( wxT( "PNS" ), wxT( "step: %d branches (%d pooled), %lld items copied, %.1f us" ),
+                aStats.m_branches, aStats.m_pooledBranches, (long long) aStats.m_copiedItems,
+                aStats.m_usecs );
+}
+
+
 wxString LOGGER::FormatLogFileAsString( int aMode,
                                         const std::vector<ITEM*>& aAddedItems,
                                         const std::set<KIID>&     aRemovedItems,
@@ -22,6 +22,7 @@
 #ifndef __PNS_LOGGER_H
 #define __PNS_LOGGER_H
 
+#include <cstdint>
 #include <cstdio>
 #include <vector>
 #include <string>
@@ -67,6 +68,28 @@ public:
         }
     };
 
+    /**
+     * Cost of branching NODEs: how many branches were made, how many of them reused storage
+     * pooled by their root, how many items were copied into them and the time it took.
+     */
+    struct BRANCH_STATS
+    {
+        int     m_steps = 0;
+        int     m_branches = 0;
+        int     m_pooledBranches = 0;
+        int64_t m_copiedItems = 0;
+        double  m_usecs = 0.0;
+
+        void Add( const BRANCH_STATS& aOther )
+        {
+            m_steps += aOther.m_steps;
+            m_branches += aOther.m_branches;
+            m_pooledBranches += aOther.m_pooledBranches;
+            m_copiedItems += aOther.m_copiedItems;
+            m_usecs += aOther.m_usecs;
+        }
+    };
+
     LOGGER();
     ~LOGGER();
 
@@ -80,6 +103,13 @@ public:
         return m_events;
     }
 
+    /**
+     * Accumulate the branch counters of a routing step.
+     */
+    void LogBranchStats( const BRANCH_STATS& aStats );
+
+    const BRANCH_STATS& GetBranchStats() const { return m_branchStats; }
+
     static wxString FormatLogFileAsString( int aMode,
                                            const std::vector<ITEM*>& aAddedItems,
                                            const std::set<KIID>&     aRemovedItems,
@@ -92,6 +122,7 @@ public:
 
 private:
     std::vector<EVENT_ENTRY> m_events;
+    BRANCH_STATS             m_branchStats;
 };
 
 }
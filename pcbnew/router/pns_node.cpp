@@ -29,6 +29,8 @@
 #include <geometry/seg.h>
 #include <geometry/shape_line_chain.h>
 #include <zone.h>
+#include <advanced_config.h>
+#include <core/profile.h>
 
 #include <wx/log.h>
 
@@ -52,14 +54,25 @@ namespace PNS {
 static std::unordered_set<const NODE*> allocNodes;
 #endif
 
-NODE::NODE()
+/// Most branch storages a root node keeps for reuse.  Shoving and walkaround rarely have
+/// more branches alive at once.
+static const size_t c_maxPooledBranches = 32;
+
+
+NODE::NODE() :
+        NODE( new INDEX )
+{
+}
+
+
+NODE::NODE( INDEX* aIndex )
 {
     m_depth = 0;
     m_root = this;
     m_parent = nullptr;
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = nullptr;
-    m_index = new INDEX;
+    m_index = aIndex;
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -85,8 +98,6 @@ NODE::~NODE()
     allocNodes.erase( this );
 #endif
 
-    m_joints.clear();
-
     std::vector<const ITEM*> toDelete;
 
     toDelete.reserve( m_index->Size() );
@@ -122,7 +133,11 @@ NODE::~NODE()
     releaseGarbage();
     unlinkParent();
 
-    delete m_index;
+    if( isRoot() )
+        ReleaseBranchPool();
+
+    if( isRoot() || !m_root->recycleBranch( this ) )
+        delete m_index;
 }
 
 
@@ -142,7 +157,24 @@ int NODE::GetClearance( const ITEM* aA, const ITEM* aB, bool aUseClearanceEpsilo
 
 NODE* NODE::Branch()
 {
-    NODE* child = new NODE;
+    PROF_TIMER            timer;
+    LOGGER::BRANCH_STATS& stats = m_root->m_branchStats;
+    NODE*                 child;
+
+    if( !m_root->m_branchPool.empty() )
+    {
+        BRANCH_STORAGE& storage = m_root->m_branchPool.back();
+
+        child = new NODE( storage.m_index );
+        child->m_joints = std::move( storage.m_joints );
+        child->m_override = std::move( storage.m_override );
+        m_root->m_branchPool.pop_back();
+        stats.m_pooledBranches++;
+    }
+    else
+    {
+        child = new NODE;
+    }
 
     m_children.insert( child );
 
@@ -163,6 +195,13 @@ NODE* NODE::Branch()
 
         child->m_joints = m_joints;
         child->m_override = m_override;
+        stats.m_copiedItems += m_index->Size();
+    }
+    else
+    {
+        // Pooled tables still hold the entries of the branch they came from.
+        child->m_joints.clear();
+        child->m_override.clear();
     }
 
 #if 0
@@ -172,10 +211,52 @@ NODE* NODE::Branch()
                 (int) child->m_override.size() );
 #endif
 
+    stats.m_branches++;
+    stats.m_usecs += timer.msecs() * 1000.0;
+
     return child;
 }
 
 
+bool NODE::recycleBranch( NODE* aBranch )
+{
+    if( !ADVANCED_CFG::GetCfg().m_RouterBranchPool
+            || m_branchPool.size() >= c_maxPooledBranches )
+    {
+        return false;
+    }
+
+    aBranch->m_index->Clear();
+
+    m_branchPool.push_back( { aBranch->m_index, std::move( aBranch->m_joints ),
+                              std::move( aBranch->m_override ) } );
+    aBranch->m_index = nullptr;
+
+    return true;
+}
+
+
+void NODE::StartBulkLoad()
+{
+    m_index->StartBulkLoad();
+}
+
+
+void NODE::FinishBulkLoad()
+{
+    m_index->FinishBulkLoad();
+}
+
+
+void NODE::ReleaseBranchPool()
+{
+    for( BRANCH_STORAGE& storage : m_branchPool )
+        delete storage.m_index;
+
+    m_branchPool.clear();
+}
+
+
 void NODE::unlinkParent()
 {
     if( isRoot() )
@@ -34,6 +34,7 @@
 #include "pns_item.h"
 #include "pns_joint.h"
 #include "pns_itemset.h"
+#include "pns_logger.h"
 
 class ZONE;
 namespace PNS {
@@ -377,6 +378,23 @@ public:
      */
     NODE* Branch();
 
+    ///< Return the branching counters gathered by the root of this node since the last reset.
+    const LOGGER::BRANCH_STATS& BranchStats() const { return m_root->m_branchStats; }
+
+    void ResetBranchStats() { m_root->m_branchStats = LOGGER::BRANCH_STATS(); }
+
+    ///< Free the storage kept for reuse by the branches of this node. Applicable only to the
+    ///< root node.
+    void ReleaseBranchPool();
+
+    /**
+     * Defer the spatial indexing of the items added to an empty node until FinishBulkLoad(),
+     * which packs them all at once. Building the world this way is faster and gives a spatial
+     * index which is cheaper to query. The node must not be queried until the load is finished.
+     */
+    void StartBulkLoad();
+    void FinishBulkLoad();
+
     /**
      * Follow the joint map to assemble a line connecting two non-trivial joints starting from
      * segment \a aSeg.
@@ -504,8 +522,11 @@ private:
     void removeViaIndex( VIA* aVia );
     void removeArcIndex( ARC* aVia );
 
+    explicit NODE( INDEX* aIndex );
+
     void doRemove( ITEM* aItem );
     void unlinkParent();
+    bool recycleBranch( NODE* aBranch );
     void releaseChildren();
     void releaseGarbage();
     void rebuildJoint( const JOINT* aJoint, const ITEM* aItem );
@@ -552,6 +573,19 @@ private:
     std::vector< std::unique_ptr<SHAPE> > m_edgeExclusions;
 
     std::unordered_set<ITEM*> m_garbageItems;
+
+    /// Storage of a deleted branch, kept by the root to be handed to the next branch rather
+    /// than freed and allocated again.  The hash tables keep their buckets and nodes, which
+    /// the copy-assignments in Branch() reuse.
+    struct BRANCH_STORAGE
+    {
+        INDEX*                    m_index;
+        JOINT_MAP                 m_joints;
+        std::unordered_set<ITEM*> m_override;
+    };
+
+    std::vector<BRANCH_STORAGE> m_branchPool;   ///< root only: storage of deleted branches
+    LOGGER::BRANCH_STATS        m_branchStats;  ///< root only: branching counters
 };
 
 }
@@ -452,22 +452,37 @@ bool ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
     if( m_logger )
         m_logger->Log( LOGGER::EVT_MOVE, aP, endItem );
 
+    bool ret = false;
+
     switch( m_state )
     {
     case ROUTE_TRACK:
-        return movePlacing( aP, endItem );
+        ret = movePlacing( aP, endItem );
+        break;
 
     case DRAG_SEGMENT:
     case DRAG_COMPONENT:
-        return moveDragging( aP, endItem );
+        ret = moveDragging( aP, endItem );
+        break;
 
     default:
+        GetRuleResolver()->ClearTemporaryCaches();
         break;
     }
 
-    GetRuleResolver()->ClearTemporaryCaches();
+    if( m_world )
+    {
+        if( m_logger )
+        {
+            LOGGER::BRANCH_STATS stats = m_world->BranchStats();
+            stats.m_steps = 1;
+            m_logger->LogBranchStats( stats );
+        }
 
-    return false;
+        m_world->ResetBranchStats();
+    }
+
+    return ret;
 }
 
 
@@ -926,6 +941,7 @@ void ROUTER::StopRouting()
 
     m_state = IDLE;
     m_world->KillChildren();
+    m_world->ReleaseBranchPool();
     m_world->ClearRanks();
 }
 
@@ -36,6 +36,9 @@
 #include <drc/drc_engine.h>
 #include <drc/drc_item.h>
 #include <netlist_reader/pcb_netlist.h>
+#include <pcb_marker.h>
+#include <advanced_config.h>
+#include <core/kicad_algo.h>
 #include <macros.h>
 
 DRC_TOOL::DRC_TOOL() :
@@ -64,6 +67,7 @@ void DRC_TOOL::Reset( RESET_REASON aReason )
 
         m_pcb = m_editFrame->GetBoard();
         m_drcEngine = m_pcb->GetDesignSettings().m_DRCEngine;
+        m_drcEngine->SetIncrementalMode( ADVANCED_CFG::GetCfg().m_IncrementalDRC );
     }
 }
 
@@ -171,6 +175,21 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
 
     m_drcEngine->SetProgressReporter( aProgressReporter );
 
+    // In incremental mode the dialog leaves the markers in place; those of the providers
+    // which are re-run are replaced below.
+    MARKERS previousMarkers = m_pcb->Markers();
+
+    for( PCB_MARKER* marker : previousMarkers )
+    {
+        // Markers which can't be attributed to a provider (such as those loaded from the
+        // board file) can only be replaced by a full run.
+        if( !static_cast<DRC_ITEM*>( marker->GetRCItem().get() )->GetViolatingTest() )
+        {
+            m_pcb->IncrementTimeStamp();
+            break;
+        }
+    }
+
     m_drcEngine->SetViolationHandler(
             [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
             {
@@ -183,6 +202,29 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
     m_drcEngine->SetProgressReporter( nullptr );
     m_drcEngine->ClearViolationHandler();
 
+    const std::vector<DRC_TEST_PROVIDER*>& rerunProviders = m_drcEngine->GetLastRunProviders();
+    std::vector<BOARD_ITEM*>               staleMarkers;
+
+    for( PCB_MARKER* marker : previousMarkers )
+    {
+        DRC_ITEM* drcItem = static_cast<DRC_ITEM*>( marker->GetRCItem().get() );
+
+        if( !drcItem->GetViolatingTest()
+                || alg::contains( rerunProviders, drcItem->GetViolatingTest() ) )
+        {
+            m_editFrame->GetCanvas()->GetView()->Remove( marker );
+            staleMarkers.push_back( marker );
+        }
+    }
+
+    for( BOARD_ITEM* marker : staleMarkers )
+        m_pcb->Remove( marker, REMOVE_MODE::BULK );
+
+    m_pcb->FinalizeBulkRemove( staleMarkers );
+
+    for( BOARD_ITEM* marker : staleMarkers )
+        delete marker;
+
     if( m_drcDialog )
     {
         m_drcDialog->SetDrcRun();
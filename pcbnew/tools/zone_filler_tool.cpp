@@ -167,12 +167,14 @@ void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller, PROGRESS_REPORTER* aRepo
         m_filler->SetProgressReporter( reporter.get() );
     }
 
+    m_filler->SetKeepPartialFills( true );
+
     if( m_filler->Fill( toFill ) )
     {
         m_filler->GetProgressReporter()->AdvancePhase();
 
         commit.Push( _( "Fill Zone(s)" ), SKIP_CONNECTIVITY | ZONE_FILL_OP );
-        frame->m_ZoneFillsDirty = false;
+        frame->m_ZoneFillsDirty = !m_filler->GetAbandonedZones().empty();
     }
     else
     {
@@ -262,10 +264,20 @@ int ZONE_FILLER_TOOL::ZoneFillDirty( const TOOL_EVENT& aEvent )
         }
     }
 
+    m_filler->SetKeepPartialFills( true );
+
     if( m_filler->Fill( toFill ) )
+    {
         commit.Push( _( "Auto-fill Zone(s)" ), APPEND_UNDO | SKIP_CONNECTIVITY | ZONE_FILL_OP );
+
+        // Pick up the zones left behind by a cancel next time round
+        for( ZONE* zone : m_filler->GetAbandonedZones() )
+            m_dirtyZoneIDs.insert( zone->m_Uuid );
+    }
     else
+    {
         commit.Revert();
+    }
 
     rebuildConnectivity();
     refresh();
@@ -349,6 +361,7 @@ int ZONE_FILLER_TOOL::ZoneFill( const TOOL_EVENT& aEvent )
 
     reporter = std::make_unique<WX_PROGRESS_REPORTER>( frame(), _( "Fill Zone" ), 5 );
     m_filler->SetProgressReporter( reporter.get() );
+    m_filler->SetKeepPartialFills( true );
 
     if( m_filler->Fill( toFill ) )
     {
@@ -266,6 +266,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList )
     auto connectivity = GetBoard()->GetConnectivity();
 
     GetBoard()->IncrementTimeStamp();   // clear caches
+    GetBoard()->ClearZoneKnockouts();
 
     // Enum to track the modification type of items. Used to enable bulk BOARD_LISTENER
     // callbacks at the end of the undo / redo operation
@@ -165,6 +165,8 @@ void ZONE::InitDataFromSrcInCopyCtor( const ZONE& aZone )
                 m_insulatedIslands[layer] = aZone.m_insulatedIslands.at( layer );
             } );
 
+    m_fillInputHash           = aZone.m_fillInputHash;
+
     m_borderStyle             = aZone.m_borderStyle;
     m_borderHatchPitch        = aZone.m_borderHatchPitch;
     m_borderHatchLines        = aZone.m_borderHatchLines;
@@ -219,6 +221,7 @@ bool ZONE::UnFill()
 
     m_isFilled = false;
     m_fillFlags.reset();
+    m_fillInputHash.clear();
 
     return change;
 }
@@ -416,6 +419,18 @@ HASH_128 ZONE::GetHashValue( PCB_LAYER_ID aLayer )
 }
 
 
+bool ZONE::GetFillInputHash( PCB_LAYER_ID aLayer, HASH_128& aHash ) const
+{
+    auto it = m_fillInputHash.find( aLayer );
+
+    if( it == m_fillInputHash.end() )
+        return false;
+
+    aHash = it->second;
+    return true;
+}
+
+
 void ZONE::BuildHashValue( PCB_LAYER_ID aLayer )
 {
     if( !m_FilledPolysList.count( aLayer ) )
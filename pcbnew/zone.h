@@ -637,6 +637,7 @@ public:
     void SetFilledPolysList( PCB_LAYER_ID aLayer, const SHAPE_POLY_SET& aPolysList )
     {
         m_FilledPolysList[aLayer] = std::make_shared<SHAPE_POLY_SET>( aPolysList );
+        m_fillInputHash.erase( aLayer );
     }
 
     /**
@@ -785,6 +786,21 @@ public:
      */
     HASH_128 GetHashValue( PCB_LAYER_ID aLayer );
 
+    /**
+     * A fingerprint of the inputs (outline, settings, nearby items and their clearances, etc.)
+     * which produced the current fill on a layer.  Set by the ZONE_FILLER so that it can skip
+     * zones whose inputs haven't changed, and dropped whenever the fill is changed by anything
+     * else.
+     *
+     * @return false if there is no fingerprint for the layer.
+     */
+    bool GetFillInputHash( PCB_LAYER_ID aLayer, HASH_128& aHash ) const;
+
+    void SetFillInputHash( PCB_LAYER_ID aLayer, const HASH_128& aHash )
+    {
+        m_fillInputHash[aLayer] = aHash;
+    }
+
     double Similarity( const BOARD_ITEM& aOther ) const override;
 
     bool operator==( const ZONE& aOther ) const;
@@ -907,6 +923,9 @@ protected:
     /// A hash value used in zone filling calculations to see if the filled areas are up to date
     std::map<PCB_LAYER_ID, HASH_128>       m_filledPolysHash;
 
+    /// Fingerprints of the inputs of the current fills (see GetFillInputHash())
+    std::map<PCB_LAYER_ID, HASH_128>       m_fillInputHash;
+
     ZONE_BORDER_DISPLAY_STYLE m_borderStyle;       // border display style, see enum above
     int                       m_borderHatchPitch;  // for DIAGONAL_EDGE, distance between 2 lines
     std::vector<SEG>          m_borderHatchLines;  // hatch lines
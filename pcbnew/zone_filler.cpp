@@ -23,7 +23,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cstring>
 #include <future>
+#include <numeric>
 #include <core/kicad_algo.h>
 #include <advanced_config.h>
 #include <board.h>
@@ -46,8 +48,12 @@
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
 #include <geometry/vertex_set.h>
+#include <mmh3_hash.h>
+#include <hash.h>
+#include <hash_eda.h>
 #include <kidialog.h>
 #include <core/thread_pool.h>
+#include <core/profile.h>
 #include <math/util.h>      // for KiROUND
 #include "zone_filler.h"
 
@@ -197,10 +203,13 @@ ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
         m_commit( aCommit ),
         m_progressReporter( nullptr ),
         m_maxError( ARC_HIGH_DEF ),
-        m_worstClearance( 0 )
+        m_worstClearance( 0 ),
+        m_keepPartialFills( false )
 {
     // To enable add "DebugZoneFiller=1" to kicad_advanced settings file.
     m_debugZoneFiller = ADVANCED_CFG::GetCfg().m_DebugZoneFiller;
+
+    m_useKnockoutCache = ADVANCED_CFG::GetCfg().m_ZoneFillKnockoutCache && !m_debugZoneFiller;
 }
 
 
@@ -233,6 +242,10 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
 
     std::vector<std::pair<ZONE*, PCB_LAYER_ID>>               toFill;
     std::map<std::pair<ZONE*, PCB_LAYER_ID>, HASH_128>        oldFillHashes;
+    std::map<std::pair<ZONE*, PCB_LAYER_ID>, HASH_128>        fillInputHashes;
+    std::set<ZONE*>                                           unchangedZones;
+    std::set<ZONE*>                                           abandonedZones;
+    std::map<ZONE*, std::unique_ptr<ZONE>>                    savedZones;
     std::map<ZONE*, std::map<PCB_LAYER_ID, ISOLATED_ISLANDS>> isolatedIslandsMap;
 
     std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board->GetConnectivity();
@@ -437,6 +450,123 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
         }
     }
 
+    if( ADVANCED_CFG::GetCfg().m_ZoneFillIncremental && !m_debugZoneFiller )
+    {
+        m_maxError = m_board->GetDesignSettings().m_MaxError;
+
+        thread_pool&                                tp = GetKiCadThreadPool();
+        std::vector<std::pair<ZONE*, PCB_LAYER_ID>> toHash;
+
+        for( ZONE* zone : aZones )
+        {
+            if( zone->GetIsRuleArea() || zone->GetNumCorners() <= 2 )
+                continue;
+
+            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+                toHash.emplace_back( zone, layer );
+        }
+
+        // Everything but the fills of other zones can be fingerprinted in parallel...
+        std::vector<HASH_128> localHashes( toHash.size() );
+
+        auto hash_results = tp.parallelize_loop( toHash.size(),
+                [&]( const size_t a, const size_t b )
+                {
+                    for( size_t ii = a; ii < b; ++ii )
+                        localHashes[ii] = hashFillInputs( toHash[ii].first, toHash[ii].second );
+                } );
+
+        hash_results.wait();
+
+        // ... but a zone's fill depends on the fills of higher-priority zones, so their
+        // fingerprints have to be known before its own can be finished.
+        std::vector<size_t> order( toHash.size() );
+        std::iota( order.begin(), order.end(), 0 );
+
+        std::sort( order.begin(), order.end(),
+                   [&]( size_t a, size_t b )
+                   {
+                       return toHash[a].first->HigherPriority( toHash[b].first );
+                   } );
+
+        for( size_t idx : order )
+        {
+            auto [ zone, layer ] = toHash[idx];
+            BOX2I     bbox = fillInfluenceBox( zone );
+            MMH3_HASH hash( 0x5A4F4E45 ); // Arbitrary seed
+
+            auto addHash =
+                    [&]( const HASH_128& aHash )
+                    {
+                        for( uint32_t word : aHash.Value32 )
+                            hash.add( static_cast<int32_t>( word ) );
+                    };
+
+            auto addZoneFill =
+                    [&]( ZONE* aOther )
+                    {
+                        if( aOther == zone || aOther->GetIsRuleArea() || aOther->SameNet( zone )
+                                || !aOther->GetLayerSet().test( layer )
+                                || !aOther->HigherPriority( zone )
+                                || !aOther->GetBoundingBox().Intersects( bbox ) )
+                        {
+                            return;
+                        }
+
+                        HASH_128 otherHash;
+                        auto     it = fillInputHashes.find( { aOther, layer } );
+
+                        if( it != fillInputHashes.end() )
+                            addHash( it->second );
+                        else if( aOther->GetFillInputHash( layer, otherHash ) )
+                            addHash( otherHash );
+                        else
+                            addHash( aOther->GetFilledPolysList( layer )->GetHash() );
+                    };
+
+            addHash( localHashes[idx] );
+
+            for( ZONE* otherZone : m_board->Zones() )
+                addZoneFill( otherZone );
+
+            for( FOOTPRINT* footprint : m_board->Footprints() )
+            {
+                for( ZONE* otherZone : footprint->Zones() )
+                    addZoneFill( otherZone );
+            }
+
+            fillInputHashes[ { zone, layer } ] = hash.digest();
+        }
+
+        for( ZONE* zone : aZones )
+        {
+            if( zone->GetIsRuleArea() || zone->GetNumCorners() <= 2 )
+                continue;
+
+            bool unchanged = zone->IsFilled() && !zone->NeedRefill();
+
+            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+            {
+                HASH_128 oldHash;
+
+                if( !zone->GetFillInputHash( layer, oldHash )
+                        || !( oldHash == fillInputHashes[ { zone, layer } ] ) )
+                {
+                    unchanged = false;
+                }
+            }
+
+            if( unchanged )
+            {
+                // Lower-priority zones mustn't wait for this one to be filled
+                for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+                    zone->SetFillFlag( layer, true );
+
+                unchangedZones.insert( zone );
+            }
+        }
+    }
+
     for( ZONE* zone : aZones )
     {
         // Rule areas are not filled
@@ -447,6 +577,10 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
         if( zone->GetNumCorners() <= 2 )
             continue;
 
+        // Nothing which went into the existing fill has changed
+        if( unchangedZones.count( zone ) )
+            continue;
+
         if( m_commit )
             m_commit->Modify( zone );
 
@@ -463,6 +597,10 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
             isolatedIslandsMap[ zone ][ layer ] = ISOLATED_ISLANDS();
         }
 
+        // Keep the existing fill in case it has to be put back after a cancel
+        if( m_keepPartialFills )
+            savedZones[ zone ].reset( static_cast<ZONE*>( zone->Clone() ) );
+
         // Remove existing fill first to prevent drawing invalid polygons on some platforms
         zone->UnFill();
     }
@@ -544,11 +682,27 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
                         return 0;
 
                     SHAPE_POLY_SET fillPolys;
+                    PROF_TIMER     timer;
 
                     if( !fillSingleZone( zone, layer, fillPolys ) )
                         return 0;
 
                     zone->SetFilledPolysList( layer, fillPolys );
+                    timer.Stop();
+
+                    if( m_progressReporter )
+                    {
+                        wxString name = zone->GetZoneName();
+
+                        if( name.IsEmpty() )
+                            name = zone->GetNetname();
+
+                        m_progressReporter->Report( wxString::Format( _( "Filled %s on %s in "
+                                                                         "%0.1f ms..." ),
+                                                                      name,
+                                                                      m_board->GetLayerName( layer ),
+                                                                      timer.msecs() ) );
+                    }
                 }
 
                 if( m_progressReporter )
@@ -588,6 +742,8 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
 
     thread_pool& tp = GetKiCadThreadPool();
 
+    buildChunkedTrackClearances( toFill );
+
     for( const std::pair<ZONE*, PCB_LAYER_ID>& fillItem : toFill )
         returns.emplace_back( std::make_pair( tp.submit( fill_lambda, fillItem ), 0 ) );
 
@@ -623,7 +779,6 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
 
         std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
 
-
         if( m_progressReporter )
         {
             m_progressReporter->KeepRefreshing();
@@ -651,12 +806,58 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
         }
     }
 
+    m_trackClearances.clear();
+    m_abandonedZones.clear();
+
+    // If asked to, a cancel keeps the zones which were completely filled.  The others get their
+    // previous fill back, and everything from here on ignores the cancel.
+    bool keepPartial = m_keepPartialFills && m_progressReporter
+                            && m_progressReporter->IsCancelled();
+
+    auto isCancelled =
+            [&]() -> bool
+            {
+                return !keepPartial && m_progressReporter && m_progressReporter->IsCancelled();
+            };
+
+    if( keepPartial )
+    {
+        for( size_t ii = 0; ii < returns.size(); ++ii )
+        {
+            auto& [ ret, step ] = returns[ii];
+
+            if( ret.valid() && ret.get() )
+                step++;
+
+            // Filled but not yet tesselated; that won't take long
+            if( step == 1 )
+            {
+                toFill[ii].first->CacheTriangulation( toFill[ii].second );
+                toFill[ii].first->SetFillFlag( toFill[ii].second, true );
+                step++;
+            }
+
+            if( step < 2 )
+                abandonedZones.insert( toFill[ii].first );
+        }
+
+        if( abandonedZones.size() == savedZones.size() )
+            return false;
+
+        for( ZONE* zone : abandonedZones )
+        {
+            *zone = *savedZones[ zone ];
+            isolatedIslandsMap.erase( zone );
+            m_abandonedZones.push_back( zone );
+        }
+    }
+
     // Now update the connectivity to check for isolated copper islands
     // (NB: FindIsolatedCopperIslands() is multi-threaded)
     //
     if( m_progressReporter )
     {
-        if( m_progressReporter->IsCancelled() )
+        if( isCancelled() )
             return false;
 
         m_progressReporter->AdvancePhase();
@@ -664,17 +865,17 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
         m_progressReporter->KeepRefreshing();
     }
 
-    connectivity->SetProgressReporter( m_progressReporter );
+    connectivity->SetProgressReporter( keepPartial ? nullptr : m_progressReporter );
     connectivity->FillIsolatedIslandsMap( isolatedIslandsMap );
     connectivity->SetProgressReporter( nullptr );
 
-    if( m_progressReporter && m_progressReporter->IsCancelled() )
+    if( isCancelled() )
         return false;
 
     for( ZONE* zone : aZones )
     {
         // Keepout zones are not filled
-        if( zone->GetIsRuleArea() )
+        if( zone->GetIsRuleArea() || abandonedZones.count( zone ) )
             continue;
 
         zone->SetIsFilled( true );
@@ -734,7 +935,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
             poly->UpdateTriangulationDataHash();
             zone->CalculateFilledArea();
 
-            if( m_progressReporter && m_progressReporter->IsCancelled() )
+            if( isCancelled() )
                 return false;
         }
     }
@@ -750,6 +951,9 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
 
     for( ZONE* zone : aZones )
     {
+        if( unchangedZones.count( zone ) || abandonedZones.count( zone ) )
+            continue;
+
         // Don't check for connections on layers that only exist in the zone but
         // were disabled in the board
         BOARD* board = zone->GetBoard();
@@ -824,7 +1028,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
                 {
                     m_progressReporter->KeepRefreshing();
 
-                    if( m_progressReporter->IsCancelled() )
+                    if( isCancelled() )
                         cancelled = true;
                 }
 
@@ -850,6 +1054,11 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
     for( ZONE* zone : aZones )
         zone->CalculateFilledArea();
 
+    for( const auto& [ fillItem, inputHash ] : fillInputHashes )
+    {
+        if( !unchangedZones.count( fillItem.first ) && !abandonedZones.count( fillItem.first ) )
+            fillItem.first->SetFillInputHash( fillItem.second, inputHash );
+    }
 
     if( aCheck )
     {
@@ -858,7 +1067,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
         for( ZONE* zone : aZones )
         {
             // Keepout zones are not filled
-            if( zone->GetIsRuleArea() )
+            if( zone->GetIsRuleArea() || unchangedZones.count( zone ) )
                 continue;
 
             for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
@@ -890,7 +1099,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
 
     if( m_progressReporter )
     {
-        if( m_progressReporter->IsCancelled() )
+        if( isCancelled() )
             return false;
 
         m_progressReporter->AdvancePhase();
@@ -907,38 +1116,149 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE*>& aZones, bool aCheck, wxWindow*
  */
 void ZONE_FILLER::addKnockout( PAD* aPad, PCB_LAYER_ID aLayer, int aGap, SHAPE_POLY_SET& aHoles )
 {
-    if( aPad->GetShape() == PAD_SHAPE::CUSTOM )
+    appendCachedKnockout( aPad, { aLayer, aGap, m_maxError, false }, aHoles,
+            [&]( SHAPE_POLY_SET& aBuffer )
+            {
+                if( aPad->GetShape() == PAD_SHAPE::CUSTOM )
+                {
+                    SHAPE_POLY_SET poly;
+                    aPad->TransformShapeToPolygon( poly, aLayer, aGap, m_maxError, ERROR_OUTSIDE );
+
+                    // the pad shape in zone can be its convex hull or the shape itself
+                    if( aPad->GetCustomShapeInZoneOpt()
+                            == PADSTACK::CUSTOM_SHAPE_ZONE_MODE::CONVEXHULL )
+                    {
+                        std::vector<VECTOR2I> convex_hull;
+                        BuildConvexHull( convex_hull, poly );
+
+                        aBuffer.NewOutline();
+
+                        for( const VECTOR2I& pt : convex_hull )
+                            aBuffer.Append( pt );
+                    }
+                    else
+                        aBuffer.Append( poly );
+                }
+                else
+                {
+                    aPad->TransformShapeToPolygon( aBuffer, aLayer, aGap, m_maxError,
+                                                   ERROR_OUTSIDE );
+                }
+            } );
+}
+
+
+/**
+ * Add a knockout for a pad's hole.
+ */
+void ZONE_FILLER::addHoleKnockout( PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles )
+{
+    appendCachedKnockout( aPad, { UNDEFINED_LAYER, aGap, m_maxError, true }, aHoles,
+            [&]( SHAPE_POLY_SET& aBuffer )
+            {
+                aPad->TransformHoleToPolygon( aBuffer, aGap, m_maxError, ERROR_OUTSIDE );
+            } );
+}
+
+
+/**
+ * Fingerprint the geometry of a pad, track or via which goes into its knockouts, so that
+ * cached knockouts aren't reused after an edit which didn't go through a BOARD_COMMIT.
+ */
+static size_t knockoutFingerprint( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
     {
-        SHAPE_POLY_SET poly;
-        aPad->TransformShapeToPolygon( poly, aLayer, aGap, m_maxError, ERROR_OUTSIDE );
+        const PAD* pad = static_cast<const PAD*>( aItem );
+        size_t     ret = hash_fp_item( pad, HASH_POS | HASH_ROT | HASH_LAYER );
 
-        // the pad shape in zone can be its convex hull or the shape itself
-        if( aPad->GetCustomShapeInZoneOpt() == PADSTACK::CUSTOM_SHAPE_ZONE_MODE::CONVEXHULL )
-        {
-            std::vector<VECTOR2I> convex_hull;
-            BuildConvexHull( convex_hull, poly );
+        hash_combine( ret, static_cast<int>( pad->GetCustomShapeInZoneOpt() ) );
+        return ret;
+    }
 
-            aHoles.NewOutline();
+    case PCB_VIA_T:
+    {
+        const PCB_VIA* via = static_cast<const PCB_VIA*>( aItem );
+        size_t         ret = hash_fp_item( via );
 
-            for( const VECTOR2I& pt : convex_hull )
-                aHoles.Append( pt );
-        }
-        else
-            aHoles.Append( poly );
+        hash_combine( ret, via->GetPosition().x, via->GetPosition().y );
+        return ret;
     }
-    else
+
+    case PCB_ARC_T:
+    {
+        const PCB_ARC* arc = static_cast<const PCB_ARC*>( aItem );
+
+        return hash_val( arc->GetStart().x, arc->GetStart().y, arc->GetMid().x, arc->GetMid().y,
+                         arc->GetEnd().x, arc->GetEnd().y, arc->GetWidth(),
+                         static_cast<int>( arc->GetLayer() ) );
+    }
+
+    default:
     {
-        aPad->TransformShapeToPolygon( aHoles, aLayer, aGap, m_maxError, ERROR_OUTSIDE );
+        const PCB_TRACK* track = static_cast<const PCB_TRACK*>( aItem );
+
+        return hash_val( track->GetStart().x, track->GetStart().y, track->GetEnd().x,
+                         track->GetEnd().y, track->GetWidth(),
+                         static_cast<int>( track->GetLayer() ) );
+    }
     }
 }
 
 
 /**
- * Add a knockout for a pad's hole.
+ * Append a knockout of \a aItem to \a aHoles, taking it from the board's knockout cache if
+ * it has been built before from the same geometry.  Otherwise it's built by \a aBuilder (and
+ * cached if the cache is in use).
  */
-void ZONE_FILLER::addHoleKnockout( PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles )
+void ZONE_FILLER::appendCachedKnockout( const BOARD_ITEM* aItem, const ZONE_KNOCKOUT_KEY& aKey,
+                                        SHAPE_POLY_SET& aHoles,
+                                        const std::function<void( SHAPE_POLY_SET& )>& aBuilder )
 {
-    aPad->TransformHoleToPolygon( aHoles, aGap, m_maxError, ERROR_OUTSIDE );
+    if( !m_useKnockoutCache )
+    {
+        aBuilder( aHoles );
+        return;
+    }
+
+    size_t                                fingerprint = knockoutFingerprint( aItem );
+    std::shared_ptr<const SHAPE_POLY_SET> knockout;
+
+    {
+        std::shared_lock<std::shared_mutex> readLock( m_board->m_CachesMutex );
+        auto                                it = m_board->m_ZoneKnockoutCache.find( aItem->m_Uuid );
+
+        if( it != m_board->m_ZoneKnockoutCache.end() && it->second.Fingerprint == fingerprint )
+        {
+            auto jt = it->second.Knockouts.find( aKey );
+
+            if( jt != it->second.Knockouts.end() )
+                knockout = jt->second;
+        }
+    }
+
+    if( !knockout )
+    {
+        std::shared_ptr<SHAPE_POLY_SET> built = std::make_shared<SHAPE_POLY_SET>();
+        aBuilder( *built );
+
+        std::unique_lock<std::shared_mutex> writeLock( m_board->m_CachesMutex );
+        ZONE_KNOCKOUTS&                     entry = m_board->m_ZoneKnockoutCache[ aItem->m_Uuid ];
+
+        // The item has changed since its knockouts were cached
+        if( entry.Fingerprint != fingerprint )
+        {
+            entry.Fingerprint = fingerprint;
+            entry.Knockouts.clear();
+        }
+
+        entry.Knockouts[ aKey ] = built;
+        knockout = std::move( built );
+    }
+
+    aHoles.Append( *knockout );
 }
 
 
@@ -1100,7 +1420,7 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE* aZone, PCB_LAYER_ID aLayer
                     else
                         holeClearance = padClearance;
 
-                    pad->TransformHoleToPolygon( holes, holeClearance, m_maxError, ERROR_OUTSIDE );
+                    addHoleKnockout( pad, holeClearance, holes );
                 }
 
                 break;
@@ -1200,83 +1520,19 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
         knockoutPadClearance( pad );
     }
 
-    // Add non-connected track clearances
+    // Add non-connected track clearances.  These may have been built ahead of time in parallel
+    // chunks (see Fill()).
     //
-    auto knockoutTrackClearance =
-            [&]( PCB_TRACK* aTrack )
-            {
-                if( aTrack->GetBoundingBox().Intersects( zone_boundingbox ) )
-                {
-                    bool sameNet = aTrack->GetNetCode() == aZone->GetNetCode();
-
-                    if( !aZone->IsTeardropArea() && aZone->GetNetCode() == 0 )
-                        sameNet = false;
-
-                    int  gap = evalRulesForItems( PHYSICAL_CLEARANCE_CONSTRAINT,
-                                                  aZone, aTrack, aLayer );
+    auto chunked = m_trackClearances.find( { aZone, aLayer } );
 
-                    if( aTrack->Type() == PCB_VIA_T )
-                    {
-                        PCB_VIA* via = static_cast<PCB_VIA*>( aTrack );
-
-                        if( via->GetZoneLayerOverride( aLayer ) == ZLO_FORCE_NO_ZONE_CONNECTION )
-                            sameNet = false;
-                    }
-
-                    if( !sameNet )
-                    {
-                        gap = std::max( gap, evalRulesForItems( CLEARANCE_CONSTRAINT,
-                                                                aZone, aTrack, aLayer ) );
-                    }
-
-                    if( aTrack->Type() == PCB_VIA_T )
-                    {
-                        PCB_VIA* via = static_cast<PCB_VIA*>( aTrack );
-
-                        if( via->FlashLayer( aLayer ) && gap > 0 )
-                        {
-                            via->TransformShapeToPolygon( aHoles, aLayer, gap + extra_margin,
-                                                          m_maxError, ERROR_OUTSIDE );
-                        }
-
-                        gap = std::max( gap, evalRulesForItems( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT,
-                                                                aZone, via, aLayer ) );
-
-                        if( !sameNet )
-                        {
-                            gap = std::max( gap, evalRulesForItems( HOLE_CLEARANCE_CONSTRAINT,
-                                                                    aZone, via, aLayer ) );
-                        }
-
-                        if( gap >= 0 )
-                        {
-                            int radius = via->GetDrillValue() / 2;
-
-                            TransformCircleToPolygon( aHoles, via->GetPosition(),
-                                                      radius + gap + extra_margin,
-                                                      m_maxError, ERROR_OUTSIDE );
-                        }
-                    }
-                    else
-                    {
-                        if( gap >= 0 )
-                        {
-                            aTrack->TransformShapeToPolygon( aHoles, aLayer, gap + extra_margin,
-                                                             m_maxError, ERROR_OUTSIDE );
-                        }
-                    }
-                }
-            };
-
-    for( PCB_TRACK* track : m_board->Tracks() )
+    if( chunked != m_trackClearances.end() )
     {
-        if( !track->IsOnLayer( aLayer ) )
-            continue;
-
-        if( checkForCancel( m_progressReporter ) )
-            return;
-
-        knockoutTrackClearance( track );
+        aHoles.Append( chunked->second );
+    }
+    else
+    {
+        std::vector<PCB_TRACK*> tracks = collectKnockoutTracks( aZone, aLayer );
+        buildTrackClearances( aZone, aLayer, tracks, 0, tracks.size(), aHoles );
     }
 
     // Add graphic item clearances.
@@ -1503,6 +1759,236 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
 }
 
 
+/**
+ * A single fill task builds all the knockouts of its zone, so a large pour can keep one core
+ * busy long after the others have finished.  For zones with many nearby tracks, build the
+ * track knockouts up front in chunks spread across the thread pool.  The chunks are appended
+ * in board order so that the result is identical to building them in one go.
+ */
+void ZONE_FILLER::buildChunkedTrackClearances(
+        const std::vector<std::pair<ZONE*, PCB_LAYER_ID>>& aFillItems )
+{
+    struct TRACK_CHUNK
+    {
+        const ZONE*                    m_zone;
+        PCB_LAYER_ID                   m_layer;
+        const std::vector<PCB_TRACK*>* m_tracks;
+        size_t                         m_first;
+        size_t                         m_last;
+        SHAPE_POLY_SET                 m_holes;
+    };
+
+    m_trackClearances.clear();
+
+    size_t chunkSize = std::max( 0, ADVANCED_CFG::GetCfg().m_ZoneFillTrackChunk );
+
+    if( chunkSize == 0 || m_debugZoneFiller )
+        return;
+
+    m_maxError = m_board->GetDesignSettings().m_MaxError;
+
+    std::map<std::pair<const ZONE*, PCB_LAYER_ID>, std::vector<PCB_TRACK*>> zoneTracks;
+    std::vector<TRACK_CHUNK>                                                chunks;
+
+    for( const auto& [ zone, layer ] : aFillItems )
+    {
+        if( !zone->IsOnCopperLayer() )
+            continue;
+
+        std::vector<PCB_TRACK*> tracks = collectKnockoutTracks( zone, layer );
+
+        if( tracks.size() < 2 * chunkSize )
+            continue;
+
+        std::vector<PCB_TRACK*>& zoneLayerTracks = zoneTracks[ { zone, layer } ];
+        zoneLayerTracks = std::move( tracks );
+
+        for( size_t first = 0; first < zoneLayerTracks.size(); first += chunkSize )
+        {
+            size_t last = std::min( first + chunkSize, zoneLayerTracks.size() );
+            chunks.push_back( { zone, layer, &zoneLayerTracks, first, last, SHAPE_POLY_SET() } );
+        }
+    }
+
+    if( chunks.empty() )
+        return;
+
+    thread_pool& tp = GetKiCadThreadPool();
+    bool         cancelled = false;
+
+    auto chunk_returns = tp.parallelize_loop( chunks.size(),
+            [&]( const size_t a, const size_t b )
+            {
+                for( size_t ii = a; ii < b; ++ii )
+                {
+                    TRACK_CHUNK& chunk = chunks[ii];
+
+                    buildTrackClearances( chunk.m_zone, chunk.m_layer, *chunk.m_tracks,
+                                          chunk.m_first, chunk.m_last, chunk.m_holes );
+                }
+            } );
+
+    for( size_t ii = 0; ii < chunk_returns.size(); ++ii )
+    {
+        std::future<void>& ret = chunk_returns[ii];
+
+        if( ret.valid() )
+        {
+            std::future_status status = ret.wait_for( std::chrono::seconds( 0 ) );
+
+            while( status != std::future_status::ready )
+            {
+                if( m_progressReporter )
+                {
+                    m_progressReporter->KeepRefreshing();
+
+                    if( m_progressReporter->IsCancelled() )
+                        cancelled = true;
+                }
+
+                status = ret.wait_for( std::chrono::milliseconds( 100 ) );
+            }
+        }
+    }
+
+    // A cancelled fill will be abandoned anyway; don't hand it incomplete knockouts
+    if( cancelled )
+        return;
+
+    for( const TRACK_CHUNK& chunk : chunks )
+        m_trackClearances[ { chunk.m_zone, chunk.m_layer } ].Append( chunk.m_holes );
+}
+
+
+/**
+ * Collect the tracks on \a aLayer which are close enough to \a aZone for their clearances to
+ * affect its fill, in board order.
+ */
+std::vector<PCB_TRACK*> ZONE_FILLER::collectKnockoutTracks( const ZONE* aZone,
+                                                            PCB_LAYER_ID aLayer )
+{
+    std::vector<PCB_TRACK*> tracks;
+    BOX2I                   zone_boundingbox = aZone->GetBoundingBox();
+    int extra_margin = pcbIUScale.mmToIU( ADVANCED_CFG::GetCfg().m_ExtraClearance );
+
+    zone_boundingbox.Inflate( m_worstClearance + extra_margin );
+
+    for( PCB_TRACK* track : m_board->Tracks() )
+    {
+        if( track->IsOnLayer( aLayer ) && track->GetBoundingBox().Intersects( zone_boundingbox ) )
+            tracks.push_back( track );
+    }
+
+    return tracks;
+}
+
+
+/**
+ * Add the clearance knockouts of \a aTracks [\a aFirst, \a aLast) to \a aHoles.
+ */
+void ZONE_FILLER::buildTrackClearances( const ZONE* aZone, PCB_LAYER_ID aLayer,
+                                        const std::vector<PCB_TRACK*>& aTracks, size_t aFirst,
+                                        size_t aLast, SHAPE_POLY_SET& aHoles )
+{
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    int extra_margin = pcbIUScale.mmToIU( ADVANCED_CFG::GetCfg().m_ExtraClearance );
+
+    auto evalRulesForItems =
+            [&bds]( DRC_CONSTRAINT_T aConstraint, const BOARD_ITEM* a, const BOARD_ITEM* b,
+                    PCB_LAYER_ID aEvalLayer ) -> int
+            {
+                DRC_CONSTRAINT c = bds.m_DRCEngine->EvalRules( aConstraint, a, b, aEvalLayer );
+
+                if( c.IsNull() )
+                    return -1;
+                else
+                    return c.GetValue().Min();
+            };
+
+    for( size_t ii = aFirst; ii < aLast; ++ii )
+    {
+        PCB_TRACK* track = aTracks[ii];
+
+        if( ( ii - aFirst ) % 50 == 0 && m_progressReporter && m_progressReporter->IsCancelled() )
+            return;
+
+        bool sameNet = track->GetNetCode() == aZone->GetNetCode();
+
+        if( !aZone->IsTeardropArea() && aZone->GetNetCode() == 0 )
+            sameNet = false;
+
+        int gap = evalRulesForItems( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, track, aLayer );
+
+        if( track->Type() == PCB_VIA_T )
+        {
+            PCB_VIA* via = static_cast<PCB_VIA*>( track );
+
+            if( via->GetZoneLayerOverride( aLayer ) == ZLO_FORCE_NO_ZONE_CONNECTION )
+                sameNet = false;
+        }
+
+        if( !sameNet )
+        {
+            gap = std::max( gap, evalRulesForItems( CLEARANCE_CONSTRAINT,
+                                                    aZone, track, aLayer ) );
+        }
+
+        if( track->Type() == PCB_VIA_T )
+        {
+            PCB_VIA* via = static_cast<PCB_VIA*>( track );
+
+            if( via->FlashLayer( aLayer ) && gap > 0 )
+            {
+                appendCachedKnockout( via, { aLayer, gap + extra_margin, m_maxError, false },
+                                      aHoles,
+                        [&]( SHAPE_POLY_SET& aBuffer )
+                        {
+                            via->TransformShapeToPolygon( aBuffer, aLayer, gap + extra_margin,
+                                                          m_maxError, ERROR_OUTSIDE );
+                        } );
+            }
+
+            gap = std::max( gap, evalRulesForItems( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT,
+                                                    aZone, via, aLayer ) );
+
+            if( !sameNet )
+            {
+                gap = std::max( gap, evalRulesForItems( HOLE_CLEARANCE_CONSTRAINT,
+                                                        aZone, via, aLayer ) );
+            }
+
+            if( gap >= 0 )
+            {
+                int radius = via->GetDrillValue() / 2;
+
+                appendCachedKnockout( via, { UNDEFINED_LAYER, gap + extra_margin, m_maxError,
+                                             true },
+                                      aHoles,
+                        [&]( SHAPE_POLY_SET& aBuffer )
+                        {
+                            TransformCircleToPolygon( aBuffer, via->GetPosition(),
+                                                      radius + gap + extra_margin,
+                                                      m_maxError, ERROR_OUTSIDE );
+                        } );
+            }
+        }
+        else
+        {
+            if( gap >= 0 )
+            {
+                appendCachedKnockout( track, { aLayer, gap + extra_margin, m_maxError, false },
+                                      aHoles,
+                        [&]( SHAPE_POLY_SET& aBuffer )
+                        {
+                            track->TransformShapeToPolygon( aBuffer, aLayer, gap + extra_margin,
+                                                            m_maxError, ERROR_OUTSIDE );
+                        } );
+            }
+        }
+    }
+}
+
+
 /**
  * Removes the outlines of higher-proirity zones with the same net.  These zones should be
  * in charge of the fill parameters within their own outlines.
@@ -1559,6 +2045,258 @@ void ZONE_FILLER::subtractHigherPriorityZones( const ZONE* aZone, PCB_LAYER_ID a
 }
 
 
+BOX2I ZONE_FILLER::fillInfluenceBox( const ZONE* aZone )
+{
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    int                    extra_margin = pcbIUScale.mmToIU( ADVANCED_CFG::GetCfg().m_ExtraClearance );
+    int                    clearance = std::max( m_worstClearance, bds.GetBiggestClearanceValue() );
+    BOX2I                  bbox = aZone->GetBoundingBox();
+
+    clearance = std::max( clearance, aZone->GetLocalClearance().value_or( 0 ) );
+    bbox.Inflate( clearance + extra_margin );
+
+    return bbox;
+}
+
+
+HASH_128 ZONE_FILLER::hashFillInputs( const ZONE* aZone, PCB_LAYER_ID aLayer )
+{
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    BOX2I                  bbox = fillInfluenceBox( aZone );
+    MMH3_HASH              hash( 0x5A4F4E45 ); // Arbitrary seed
+
+    auto addHash =
+            [&]( const HASH_128& aHash )
+            {
+                for( uint32_t word : aHash.Value32 )
+                    hash.add( static_cast<int32_t>( word ) );
+            };
+
+    auto addPoint =
+            [&]( const VECTOR2I& aPt )
+            {
+                hash.add( aPt.x );
+                hash.add( aPt.y );
+            };
+
+    auto addDouble =
+            [&]( double aValue )
+            {
+                int64_t bits;
+                memcpy( &bits, &aValue, sizeof( bits ) );
+                hash.add( static_cast<int32_t>( bits ) );
+                hash.add( static_cast<int32_t>( bits >> 32 ) );
+            };
+
+    auto addConstraint =
+            [&]( DRC_CONSTRAINT_T aType, const BOARD_ITEM* a, const BOARD_ITEM* b )
+            {
+                DRC_CONSTRAINT c = bds.m_DRCEngine->EvalRules( aType, a, b, aLayer );
+                hash.add( c.IsNull() ? -1 : c.GetValue().Min() );
+            };
+
+    auto addItemShape =
+            [&]( BOARD_ITEM* aItem )
+            {
+                SHAPE_POLY_SET shape;
+                addKnockout( aItem, aLayer, 0, false, shape );
+                addHash( shape.GetHash() );
+            };
+
+    // Board-wide settings
+    hash.add( m_worstClearance );
+    hash.add( bds.m_MaxError );
+    hash.add( bds.m_ZoneKeepExternalFillets );
+    hash.add( m_brdOutlinesValid );
+    addHash( m_boardOutline.GetHash() );
+    addDouble( ADVANCED_CFG::GetCfg().m_ExtraClearance );
+    hash.add( ADVANCED_CFG::GetCfg().m_ZoneConnectionFiller );
+
+    // The zone itself
+    hash.add( aLayer );
+    addHash( aZone->Outline()->GetHash() );
+    hash.add( aZone->GetNetCode() );
+    hash.add( aZone->GetAssignedPriority() );
+    hash.add( static_cast<int>( aZone->GetTeardropAreaType() ) );
+    hash.add( aZone->GetLocalClearance().value_or( -1 ) );
+    hash.add( aZone->GetMinThickness() );
+    hash.add( static_cast<int>( aZone->GetPadConnection() ) );
+    hash.add( aZone->GetThermalReliefGap() );
+    hash.add( aZone->GetThermalReliefSpokeWidth() );
+    hash.add( static_cast<int>( aZone->GetFillMode() ) );
+    hash.add( aZone->GetHatchThickness() );
+    hash.add( aZone->GetHatchGap() );
+    addDouble( aZone->GetHatchOrientation().AsDegrees() );
+    hash.add( aZone->GetHatchSmoothingLevel() );
+    addDouble( aZone->GetHatchSmoothingValue() );
+    addDouble( aZone->GetHatchHoleMinArea() );
+    hash.add( aZone->GetHatchBorderAlgorithm() );
+    hash.add( aZone->GetCornerSmoothingType() );
+    hash.add( aZone->GetCornerRadius() );
+    hash.add( static_cast<int>( aZone->GetIslandRemovalMode() ) );
+    addDouble( static_cast<double>( aZone->GetMinIslandArea() ) );
+
+    // Pads are knocked out (or hole-knocked-out) on every layer
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        if( !footprint->GetBoundingBox().Intersects( bbox ) )
+            continue;
+
+        hash.add( footprint->IsNetTie() );
+        addHash( footprint->GetCourtyard( aLayer ).GetHash() );
+        addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, footprint );
+
+        for( PAD* pad : footprint->Pads() )
+        {
+            if( !pad->GetBoundingBox().Intersects( bbox ) )
+                continue;
+
+            hash.add( pad->GetNetCode() );
+            addPoint( pad->GetPosition() );
+            addHash( pad->GetEffectivePolygon( ERROR_OUTSIDE )->GetHash() );
+            addDouble( pad->GetOrientation().AsDegrees() );
+            addDouble( pad->GetThermalSpokeAngle().AsDegrees() );
+            addPoint( pad->GetDrillSize() );
+            hash.add( static_cast<int>( pad->GetDrillShape() ) );
+            hash.add( static_cast<int>( pad->GetAttribute() ) );
+            hash.add( static_cast<int>( pad->GetCustomShapeInZoneOpt() ) );
+            hash.add( pad->FlashLayer( aLayer ) );
+            hash.add( pad->CanFlashLayer( aLayer ) );
+            hash.add( pad->GetZoneLayerOverride( aLayer ) );
+
+            if( pad->GetNetCode() == aZone->GetNetCode() )
+            {
+                DRC_CONSTRAINT c = bds.m_DRCEngine->EvalZoneConnection( pad, aZone, aLayer );
+                hash.add( static_cast<int>( c.m_ZoneConnection ) );
+
+                addConstraint( THERMAL_RELIEF_GAP_CONSTRAINT, pad, aZone );
+                addConstraint( THERMAL_SPOKE_WIDTH_CONSTRAINT, pad, aZone );
+                addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, pad, aZone );
+                addConstraint( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT, pad, aZone );
+            }
+
+            addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, pad );
+            addConstraint( CLEARANCE_CONSTRAINT, aZone, pad );
+            addConstraint( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT, aZone, pad );
+            addConstraint( HOLE_CLEARANCE_CONSTRAINT, aZone, pad );
+        }
+
+        for( PCB_FIELD* field : footprint->GetFields() )
+        {
+            if( field->GetBoundingBox().Intersects( bbox ) )
+            {
+                hash.add( field->IsOnLayer( aLayer ) );
+                addItemShape( field );
+                addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, field );
+                addConstraint( CLEARANCE_CONSTRAINT, aZone, field );
+            }
+        }
+
+        for( BOARD_ITEM* item : footprint->GraphicalItems() )
+        {
+            if( !item->IsOnLayer( aLayer ) && !item->IsOnLayer( Edge_Cuts )
+                    && !item->IsOnLayer( Margin ) )
+            {
+                continue;
+            }
+
+            if( item->GetBoundingBox().Intersects( bbox ) )
+            {
+                hash.add( item->GetLayer() );
+                addItemShape( item );
+                addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, item );
+                addConstraint( CLEARANCE_CONSTRAINT, aZone, item );
+                addConstraint( EDGE_CLEARANCE_CONSTRAINT, aZone, item );
+            }
+        }
+    }
+
+    for( PCB_TRACK* track : m_board->Tracks() )
+    {
+        if( !track->IsOnLayer( aLayer ) || !track->GetBoundingBox().Intersects( bbox ) )
+            continue;
+
+        hash.add( track->Type() );
+        hash.add( track->GetNetCode() );
+        addPoint( track->GetStart() );
+        addPoint( track->GetEnd() );
+        hash.add( track->GetWidth() );
+
+        if( track->Type() == PCB_ARC_T )
+        {
+            addPoint( static_cast<PCB_ARC*>( track )->GetMid() );
+        }
+        else if( track->Type() == PCB_VIA_T )
+        {
+            PCB_VIA* via = static_cast<PCB_VIA*>( track );
+
+            hash.add( via->GetDrillValue() );
+            hash.add( via->FlashLayer( aLayer ) );
+            hash.add( via->GetZoneLayerOverride( aLayer ) );
+            addConstraint( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT, aZone, via );
+            addConstraint( HOLE_CLEARANCE_CONSTRAINT, aZone, via );
+        }
+
+        addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, track );
+        addConstraint( CLEARANCE_CONSTRAINT, aZone, track );
+    }
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayer ) && !item->IsOnLayer( Edge_Cuts )
+                && !item->IsOnLayer( Margin ) )
+        {
+            continue;
+        }
+
+        if( item->GetBoundingBox().Intersects( bbox ) )
+        {
+            hash.add( item->GetLayer() );
+
+            if( item->Type() == PCB_SHAPE_T )
+                hash.add( static_cast<PCB_SHAPE*>( item )->GetNetCode() );
+
+            addItemShape( item );
+            addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, item );
+            addConstraint( CLEARANCE_CONSTRAINT, aZone, item );
+            addConstraint( EDGE_CLEARANCE_CONSTRAINT, aZone, item );
+        }
+    }
+
+    // Other zones contribute their outlines; the fills of higher-priority zones are added later
+    auto addZone =
+            [&]( ZONE* aOther )
+            {
+                if( aOther == aZone || !aOther->GetLayerSet().test( aLayer ) )
+                    return;
+
+                if( !aOther->GetBoundingBox().Intersects( bbox ) )
+                    return;
+
+                addHash( aOther->Outline()->GetHash() );
+                hash.add( aOther->GetNetCode() );
+                hash.add( aOther->HigherPriority( aZone ) );
+                hash.add( aOther->GetAssignedPriority() );
+                hash.add( aOther->GetIsRuleArea() );
+                hash.add( aOther->GetDoNotAllowCopperPour() );
+                hash.add( static_cast<int>( aOther->GetTeardropAreaType() ) );
+                addConstraint( PHYSICAL_CLEARANCE_CONSTRAINT, aZone, aOther );
+                addConstraint( CLEARANCE_CONSTRAINT, aZone, aOther );
+            };
+
+    for( ZONE* otherZone : m_board->Zones() )
+        addZone( otherZone );
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        for( ZONE* otherZone : footprint->Zones() )
+            addZone( otherZone );
+    }
+
+    return hash.digest();
+}
+
+
 void ZONE_FILLER::connect_nearby_polys( SHAPE_POLY_SET& aPolys, double aDistance )
 {
     if( aPolys.OutlineCount() < 1 )
@@ -26,6 +26,8 @@
 #ifndef ZONE_FILLER_H
 #define ZONE_FILLER_H
 
+#include <functional>
+#include <map>
 #include <vector>
 #include <zone.h>
 
@@ -34,6 +36,8 @@ class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
+class PCB_TRACK;
+struct ZONE_KNOCKOUT_KEY;
 
 
 class ZONE_FILLER
@@ -59,6 +63,18 @@ public:
 
     bool IsDebug() const { return m_debugZoneFiller; }
 
+    /**
+     * When set, cancelling a fill keeps the zones which had been completely filled (Fill()
+     * then returns true so that they can be committed).  The other zones are left as they
+     * were before the fill and are reported by GetAbandonedZones().
+     */
+    void SetKeepPartialFills( bool aKeep ) { m_keepPartialFills = aKeep; }
+
+    /**
+     * @return the zones whose refill was abandoned by a cancel in the last call to Fill().
+     */
+    const std::vector<ZONE*>& GetAbandonedZones() const { return m_abandonedZones; }
+
 private:
 
     void addKnockout( PAD* aPad, PCB_LAYER_ID aLayer, int aGap, SHAPE_POLY_SET& aHoles );
@@ -68,6 +84,10 @@ private:
 
     void addHoleKnockout( PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles );
 
+    void appendCachedKnockout( const BOARD_ITEM* aItem, const ZONE_KNOCKOUT_KEY& aKey,
+                               SHAPE_POLY_SET& aHoles,
+                               const std::function<void( SHAPE_POLY_SET& )>& aBuilder );
+
     void knockoutThermalReliefs( const ZONE* aZone, PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aFill,
                                  std::vector<PAD*>& aThermalConnectionPads,
                                  std::vector<PAD*>& aNoConnectionPads );
@@ -76,9 +96,35 @@ private:
                                     const std::vector<PAD*>& aNoConnectionPads,
                                     SHAPE_POLY_SET& aHoles );
 
+    /**
+     * Build the track knockouts of large zones ahead of the fill in parallel chunks, storing
+     * them in m_trackClearances for buildCopperItemClearances() to pick up.
+     */
+    void buildChunkedTrackClearances(
+            const std::vector<std::pair<ZONE*, PCB_LAYER_ID>>& aFillItems );
+
+    std::vector<PCB_TRACK*> collectKnockoutTracks( const ZONE* aZone, PCB_LAYER_ID aLayer );
+
+    void buildTrackClearances( const ZONE* aZone, PCB_LAYER_ID aLayer,
+                               const std::vector<PCB_TRACK*>& aTracks, size_t aFirst,
+                               size_t aLast, SHAPE_POLY_SET& aHoles );
+
     void subtractHigherPriorityZones( const ZONE* aZone, PCB_LAYER_ID aLayer,
                                       SHAPE_POLY_SET& aRawFill );
 
+    /**
+     * @return the area around a zone within which items can affect its fill.
+     */
+    BOX2I fillInfluenceBox( const ZONE* aZone );
+
+    /**
+     * Build a fingerprint of everything the fill of \a aZone on \a aLayer depends on, except
+     * for the fills of higher-priority zones (which are folded in by Fill()).
+     *
+     * Must be called after the zone layer overrides of pads and vias have been determined.
+     */
+    HASH_128 hashFillInputs( const ZONE* aZone, PCB_LAYER_ID aLayer );
+
     /**
      * Function fillCopperZone
      * Add non copper areas polygons (pads and tracks with clearance)
@@ -144,7 +190,13 @@ private:
     int                   m_maxError;
     int                   m_worstClearance;
 
+    /// Track knockouts built ahead of the fill for large zones, by zone and layer
+    std::map<std::pair<const ZONE*, PCB_LAYER_ID>, SHAPE_POLY_SET> m_trackClearances;
+
     bool                  m_debugZoneFiller;
+    bool                  m_useKnockoutCache;
+    bool                  m_keepPartialFills;
+    std::vector<ZONE*>    m_abandonedZones;
 };
 
 #endif
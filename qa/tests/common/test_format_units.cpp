@@ -28,7 +28,11 @@
 #include <locale_io.h>
 
 #include <algorithm>
+#include <charconv>
 #include <iostream>
+#include <limits>
+#include <tuple>
+#include <vector>
 
 struct UnitFixture
 {
@@ -84,4 +88,114 @@ BOOST_AUTO_TEST_CASE( VECTOR2IUnitFormat )
 }
 
 
+/**
+ * Check formatting to a buffer and parsing back again
+ */
+BOOST_AUTO_TEST_CASE( InternalUnitsRoundTrip )
+{
+#ifdef EESCHEMA
+    const EDA_IU_SCALE& iuScale = schIUScale;
+#elif GERBVIEW
+    const EDA_IU_SCALE& iuScale = gerbIUScale;
+#elif PCBNEW
+    const EDA_IU_SCALE& iuScale = pcbIUScale;
+#endif
+
+    const int values[] = { 0, 1, -1, 10, 100, -350000, 123456, 52525252, -52525252,
+                           std::numeric_limits<int>::min(), std::numeric_limits<int>::max() };
+
+    for( int value : values )
+    {
+        BOOST_TEST_CONTEXT( value )
+        {
+            char                 buf[32];
+            std::to_chars_result written = EDA_UNIT_UTILS::FormatInternalUnits( buf, buf + 32,
+                                                                                 iuScale, value );
+
+            BOOST_REQUIRE( written.ec == std::errc() );
+            BOOST_CHECK_EQUAL( std::string( buf, written.ptr ),
+                               EDA_UNIT_UTILS::FormatInternalUnits( iuScale, value ) );
+
+            int                    parsed = 0;
+            std::from_chars_result read = EDA_UNIT_UTILS::ParseInternalUnits( buf, written.ptr,
+                                                                              iuScale, parsed );
+
+            BOOST_CHECK( read.ec == std::errc() );
+            BOOST_CHECK( read.ptr == written.ptr );
+            BOOST_CHECK_EQUAL( parsed, value );
+
+            // Too small a buffer is reported rather than overrun
+            written = EDA_UNIT_UTILS::FormatInternalUnits( buf, buf + 1, iuScale, value );
+            BOOST_CHECK( value == 0 || written.ec == std::errc::value_too_large );
+        }
+    }
+}
+
+
+/**
+ * Check parsing text which was not written by KiCad
+ */
+BOOST_AUTO_TEST_CASE( InternalUnitsParse )
+{
+    const std::vector<std::tuple<std::string, int, size_t>> cases = {
+        { "1.5", 1500000, 3 },
+        { "-0.35", -350000, 5 },
+        { ".5", 500000, 2 },
+        { "1e3", 1000000000, 3 },
+        { "-2.5E-1", -250000, 7 },
+        { "1e", 1000000, 1 },                   // the exponent has no digits
+        { "0.0000005", 1, 9 },                  // rounds half away from zero
+        { "-0.0000005", -1, 10 },
+        { "0.0000004999", 0, 12 },
+        { "12.000000000000000000000001", 12000000, 27 },
+        { "99999999", std::numeric_limits<int>::max(), 8 },
+        { "-99999999", std::numeric_limits<int>::min(), 9 },
+        { "3.5)", 3500000, 3 },
+    };
+
+    for( const auto& [text, expected, length] : cases )
+    {
+        BOOST_TEST_CONTEXT( text )
+        {
+            int                    value = 0;
+            std::from_chars_result result = EDA_UNIT_UTILS::ParseInternalUnits(
+                    text.data(), text.data() + text.size(), pcbIUScale, value );
+
+            BOOST_CHECK( result.ec == std::errc() );
+            BOOST_CHECK_EQUAL( size_t( result.ptr - text.data() ), length );
+            BOOST_CHECK_EQUAL( value, expected );
+        }
+    }
+
+    for( const std::string& text : { "", "-", ".", "-.", "abc", "+1", "nan" } )
+    {
+        BOOST_TEST_CONTEXT( text )
+        {
+            int value = 0;
+
+            BOOST_CHECK( EDA_UNIT_UTILS::ParseInternalUnits( text.data(),
+                                                             text.data() + text.size(),
+                                                             pcbIUScale, value ).ec
+                         == std::errc::invalid_argument );
+        }
+    }
+
+    // The string overloads only accept text which is entirely the number or vector
+    int      value = 0;
+    VECTOR2I vec;
+
+    BOOST_CHECK( EDA_UNIT_UTILS::ParseInternalUnits( std::string( "1.5" ), pcbIUScale, value ) );
+    BOOST_CHECK_EQUAL( value, 1500000 );
+    BOOST_CHECK( !EDA_UNIT_UTILS::ParseInternalUnits( std::string( "1.5abc" ), pcbIUScale,
+                                                      value ) );
+    BOOST_CHECK( !EDA_UNIT_UTILS::ParseInternalUnits( std::string( "1.5 " ), pcbIUScale,
+                                                      value ) );
+
+    BOOST_CHECK( EDA_UNIT_UTILS::ParseInternalUnits( std::string( "1 -2" ), pcbIUScale, vec ) );
+    BOOST_CHECK_EQUAL( vec, VECTOR2I( 1000000, -2000000 ) );
+    BOOST_CHECK( !EDA_UNIT_UTILS::ParseInternalUnits( std::string( "1 2 3" ), pcbIUScale, vec ) );
+    BOOST_CHECK( !EDA_UNIT_UTILS::ParseInternalUnits( std::string( "1x 2" ), pcbIUScale, vec ) );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
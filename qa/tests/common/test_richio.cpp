@@ -28,7 +28,11 @@
 
 #include <qa_utils/wx_utils/unit_test_utils.h>
 
+#include <filesystem>
+#include <fstream>
+
 // Code under test
+#include <dsnlexer.h>
 #include <richio.h>
 
 /**
@@ -80,4 +84,67 @@ BOOST_AUTO_TEST_CASE( VPrint )
     output.clear();
 }
 
+
+/**
+ * A mapped file must give the same lines, tokens and line numbers as reading it from a string,
+ * whether or not it ends with a newline.
+ */
+BOOST_AUTO_TEST_CASE( MappedFileLineReader )
+{
+    const std::string text = "(kicad_pcb (version 20240108)\n"
+                             "\n"
+                             "  (net 1 \"GND\")\r\n"
+                             "# a comment\n"
+                             "  (segment (start 1.5 -2) (end 3 4) (net 1))\n"
+                             "  (gr_text \"a \\\"quoted\\\" string\" (at 0 0)))";
+
+    for( const std::string& contents : { text, text + "\n", std::string() } )
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path()
+                                     / "richio_mapped_tst.kicad_pcb";
+
+        {
+            std::ofstream out( path, std::ios::binary );
+            out << contents;
+        }
+
+        {
+            STRING_LINE_READER      stringReader( contents, wxT( "string" ) );
+            MAPPED_FILE_LINE_READER mappedReader( path.string() );
+
+            while( char* line = stringReader.ReadLine() )
+            {
+                BOOST_REQUIRE( mappedReader.ReadLine() );
+                BOOST_CHECK_EQUAL( std::string( mappedReader.Line() ), std::string( line ) );
+                BOOST_CHECK_EQUAL( mappedReader.LineNumber(), stringReader.LineNumber() );
+            }
+
+            BOOST_CHECK( !mappedReader.ReadLine() );
+        }
+
+        {
+            STRING_LINE_READER      stringReader( contents, wxT( "string" ) );
+            MAPPED_FILE_LINE_READER mappedReader( path.string() );
+            DSNLEXER                stringLexer( nullptr, 0, nullptr, &stringReader );
+            DSNLEXER                mappedLexer( nullptr, 0, nullptr, &mappedReader );
+            int                     tok;
+
+            do
+            {
+                tok = stringLexer.NextTok();
+
+                BOOST_REQUIRE_EQUAL( mappedLexer.NextTok(), tok );
+                BOOST_CHECK_EQUAL( mappedLexer.CurStr(), stringLexer.CurStr() );
+                BOOST_CHECK_EQUAL( mappedLexer.CurLineNumber(), stringLexer.CurLineNumber() );
+                BOOST_CHECK_EQUAL( mappedLexer.CurOffset(), stringLexer.CurOffset() );
+                BOOST_CHECK_EQUAL( std::string( mappedLexer.CurLine() ),
+                                   std::string( stringLexer.CurLine() ) );
+            } while( tok != DSN_EOF );
+        }
+
+        std::filesystem::remove( path );
+    }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,176 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <advanced_config.h>
+#include <sch_io/sch_io_mgr.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <schematic.h>
+#include <settings/settings_manager.h>
+
+
+/**
+ * A copy of the shared hierarchy test schematic, with a sheet which includes its own parent
+ * and a sheet whose file fails to parse.
+ */
+struct CONCURRENT_SCHEMATIC_LOAD_FIXTURE
+{
+    CONCURRENT_SCHEMATIC_LOAD_FIXTURE() :
+            m_manager( true /* headless */ )
+    {
+        std::filesystem::path source = std::filesystem::path( KI_TEST::GetEeschemaTestDataDir() )
+                                       / "netlists" / "complex_hierarchy_shared";
+
+        m_dir = std::filesystem::temp_directory_path() / "concurrent_sch_load_tst";
+
+        std::filesystem::remove_all( m_dir );
+        std::filesystem::copy( source, m_dir, std::filesystem::copy_options::recursive );
+
+        addSheet( m_dir / "ampli_ht" / "filter.kicad_sch", "recursive", "ampli_ht.kicad_sch",
+                  "8d1c0a52-3f0e-4c43-9a57-54c1b1e1d7a1" );
+        addSheet( m_dir / "complex_hierarchy.kicad_sch", "broken", "broken.kicad_sch",
+                  "1f6b7d0e-2b0c-4e5a-8f43-0c9d4a6e2b35" );
+
+        std::ofstream( m_dir / "broken.kicad_sch" )
+                << "(kicad_sch (version 20210621) (generator eeschema)\n"
+                   "  (not_a_token 1)\n"
+                   ")\n";
+
+        m_manager.LoadProject( ( m_dir / "complex_hierarchy.kicad_pro" ).string() );
+        m_manager.Prj().SetElem( PROJECT::ELEM_SCH_SYMBOL_LIBS, nullptr );
+    }
+
+    ~CONCURRENT_SCHEMATIC_LOAD_FIXTURE()
+    {
+        m_manager.UnloadProject( &m_manager.Prj(), false );
+        std::filesystem::remove_all( m_dir );
+    }
+
+    /// Add a sheet using @a aSheetFile to the end of the schematic @a aFile
+    static void addSheet( const std::filesystem::path& aFile, const std::string& aName,
+                          const std::string& aSheetFile, const std::string& aUuid )
+    {
+        std::ifstream      in( aFile );
+        std::ostringstream text;
+
+        text << in.rdbuf();
+        in.close();
+
+        std::string schematic = text.str();
+        size_t      end = schematic.rfind( ')' );
+
+        BOOST_REQUIRE( end != std::string::npos );
+
+        schematic.insert( end, "  (sheet (at 10.16 10.16) (size 12.7 12.7)\n"
+                               "    (uuid " + aUuid + ")\n"
+                               "    (property \"Sheet name\" \"" + aName + "\" (id 0)"
+                               " (at 10.16 9.4484 0))\n"
+                               "    (property \"Sheet file\" \"" + aSheetFile + "\" (id 1)"
+                               " (at 10.16 23.4446 0))\n"
+                               "  )\n" );
+
+        std::ofstream( aFile ) << schematic;
+    }
+
+    /**
+     * Load the schematic with the concurrent load on or off.
+     *
+     * @return one line per sheet path in hierarchy order, naming the path, its file and the
+     *         first path sharing its screen, followed by the error text.
+     */
+    std::vector<std::string> load( bool aConcurrent )
+    {
+        ADVANCED_CFG& cfg = const_cast<ADVANCED_CFG&>( ADVANCED_CFG::GetCfg() );
+        bool          wasConcurrent = cfg.m_ConcurrentSchematicLoad;
+
+        cfg.m_ConcurrentSchematicLoad = aConcurrent;
+
+        IO_RELEASER<SCH_IO> pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_KICAD ) );
+        SCHEMATIC           schematic( nullptr );
+        wxString            rootFile = ( m_dir / "complex_hierarchy.kicad_sch" ).string();
+
+        schematic.SetProject( &m_manager.Prj() );
+        schematic.SetRoot( pi->LoadSchematicFile( rootFile, &schematic ) );
+
+        cfg.m_ConcurrentSchematicLoad = wasConcurrent;
+
+        std::vector<std::string>        result;
+        std::map<SCH_SCREEN*, wxString> firstUse;
+        SCH_SHEET_LIST                  sheets( &schematic.Root() );
+
+        for( const SCH_SHEET_PATH& path : sheets )
+        {
+            SCH_SCREEN* screen = path.LastScreen();
+            wxString    name = path.PathHumanReadable( false );
+
+            firstUse.emplace( screen, name );
+
+            result.push_back( ( name + wxT( " " ) + screen->GetFileName() + wxT( " shares " )
+                                + firstUse[screen] ).ToStdString() );
+        }
+
+        result.push_back( pi->GetError().ToStdString() );
+        schematic.Reset();
+
+        return result;
+    }
+
+    SETTINGS_MANAGER      m_manager;
+    std::filesystem::path m_dir;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConcurrentSchematicLoad, CONCURRENT_SCHEMATIC_LOAD_FIXTURE )
+
+
+/**
+ * Preloading the sub-sheet files on the thread pool must give the same hierarchy, the same
+ * shared screens and the same errors as loading them one by one.
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentMatchesSequential )
+{
+    std::vector<std::string> sequential = load( false );
+    std::vector<std::string> concurrent = load( true );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( concurrent.begin(), concurrent.end(),
+                                   sequential.begin(), sequential.end() );
+
+    // The root, the two amplifiers, their filters, the recursive sheets in the shared filter
+    // screen, the broken sheet, and the error text
+    BOOST_REQUIRE_EQUAL( sequential.size(), 9u );
+
+    const std::string& error = sequential.back();
+
+    BOOST_CHECK( error.find( "already appears as a direct ancestor" ) != std::string::npos );
+    BOOST_CHECK( error.find( "broken.kicad_sch" ) != std::string::npos );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
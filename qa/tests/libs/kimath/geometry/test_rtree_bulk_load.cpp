@@ -0,0 +1,154 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <climits>
+#include <random>
+#include <set>
+
+#include <geometry/rtree.h>
+
+
+using TEST_RTREE = RTree<int*, int, 2, double>;
+using ENTRY = std::pair<TEST_RTREE::Rect, int*>;
+
+
+static std::vector<ENTRY> makeEntries( std::vector<int>& aStorage, std::mt19937& aRng )
+{
+    std::vector<ENTRY> entries;
+
+    for( int& id : aStorage )
+    {
+        int x = aRng() % 100000;
+        int y = aRng() % 100000;
+        int w = aRng() % 500;
+        int h = aRng() % 500;
+
+        entries.emplace_back( TEST_RTREE::Rect{ { x, y }, { x + w, y + h } }, &id );
+    }
+
+    return entries;
+}
+
+
+static std::multiset<int*> search( const TEST_RTREE& aTree, int aX, int aY, int aSize )
+{
+    std::multiset<int*> found;
+    const int           min[2] = { aX, aY };
+    const int           max[2] = { aX + aSize, aY + aSize };
+
+    auto visitor =
+            [&]( int* aId ) -> bool
+            {
+                found.insert( aId );
+                return true;
+            };
+
+    aTree.Search( min, max, visitor );
+    return found;
+}
+
+
+BOOST_AUTO_TEST_SUITE( RTreeBulkLoad )
+
+
+/**
+ * A bulk-loaded tree must answer queries exactly as one built an entry at a time, including
+ * for the small sizes where the last nodes have to share their entries.
+ */
+BOOST_AUTO_TEST_CASE( MatchesIncrementalTree )
+{
+    std::mt19937 rng( 42 );
+
+    for( int count : { 0, 1, 7, 8, 9, 11, 12, 13, 64, 65, 67, 1000, 10001 } )
+    {
+        BOOST_TEST_CONTEXT( "Entry count: " << count )
+        {
+            std::vector<int>   storage( count );
+            std::vector<ENTRY> entries = makeEntries( storage, rng );
+            TEST_RTREE         incremental;
+            TEST_RTREE         packed;
+
+            for( const ENTRY& entry : entries )
+                incremental.Insert( entry.first.m_min, entry.first.m_max, entry.second );
+
+            packed.BulkLoad( entries );
+
+            BOOST_CHECK_EQUAL( packed.Count(), count );
+
+            for( int query = 0; query < 200; ++query )
+            {
+                int x = rng() % 100000;
+                int y = rng() % 100000;
+
+                std::multiset<int*> expected = search( incremental, x, y, 2000 );
+                std::multiset<int*> actual = search( packed, x, y, 2000 );
+
+                BOOST_CHECK( expected == actual );
+            }
+
+            int iterated = 0;
+
+            for( int* id : packed )
+            {
+                ( void ) id;
+                iterated++;
+            }
+
+            BOOST_CHECK_EQUAL( iterated, count );
+        }
+    }
+}
+
+
+/**
+ * A bulk-loaded tree must stay fully dynamic.
+ */
+BOOST_AUTO_TEST_CASE( InsertAndRemoveAfterLoad )
+{
+    std::mt19937       rng( 7 );
+    std::vector<int>   storage( 5000 );
+    std::vector<ENTRY> entries = makeEntries( storage, rng );
+    std::vector<ENTRY> toLoad( entries.begin(), entries.begin() + 4000 );
+    TEST_RTREE         tree;
+
+    tree.BulkLoad( toLoad );
+
+    for( auto it = entries.begin() + 4000; it != entries.end(); ++it )
+        tree.Insert( it->first.m_min, it->first.m_max, it->second );
+
+    BOOST_CHECK_EQUAL( tree.Count(), 5000 );
+
+    for( size_t ii = 0; ii < entries.size(); ii += 2 )
+    {
+        const ENTRY& entry = entries[ii];
+        BOOST_CHECK( !tree.Remove( entry.first.m_min, entry.first.m_max, entry.second ) );
+    }
+
+    BOOST_CHECK_EQUAL( tree.Count(), 2500 );
+
+    std::multiset<int*> all = search( tree, INT_MIN / 2, INT_MIN / 2, INT_MAX );
+
+    for( size_t ii = 0; ii < entries.size(); ++ii )
+        BOOST_CHECK_EQUAL( all.count( entries[ii].second ), ii % 2 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,204 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <climits>
+#include <random>
+
+#include <geometry/seg_batch.h>
+#include <geometry/shape_arc.h>
+#include <geometry/shape_line_chain.h>
+
+
+static SEG randomSeg( std::mt19937& aRng )
+{
+    VECTOR2I a( aRng() % 100000, aRng() % 100000 );
+
+    // Mix long segments with short ones, which are the common case on a board
+    if( aRng() % 2 )
+    {
+        int dx = (int) ( aRng() % 4000 ) - 2000;
+        int dy = (int) ( aRng() % 4000 ) - 2000;
+
+        return SEG( a, a + VECTOR2I( dx, dy ) );
+    }
+
+    return SEG( a, VECTOR2I( aRng() % 100000, aRng() % 100000 ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE( SegBatch )
+
+
+/**
+ * The batch must find the same closest distance as testing each candidate on its own, for
+ * every batch size around the block size of the vectorized filter.
+ */
+BOOST_AUTO_TEST_CASE( MatchesPairwiseSegments )
+{
+    std::mt19937 rng( 42 );
+
+    for( int count : { 0, 1, 7, 8, 9, 15, 16, 17, 100 } )
+    {
+        BOOST_TEST_CONTEXT( "Candidate count: " << count )
+        {
+            for( int query = 0; query < 200; ++query )
+            {
+                SEG_BATCH        batch;
+                std::vector<SEG> segs;
+                std::vector<int> widths;
+
+                for( int ii = 0; ii < count; ++ii )
+                {
+                    segs.push_back( randomSeg( rng ) );
+                    widths.push_back( rng() % 3 ? 0 : rng() % 2000 );
+                    batch.Add( segs.back(), widths.back(), ii );
+                }
+
+                SEG q = randomSeg( rng );
+                int clearance = rng() % 5000;
+                int expected = INT_MAX;
+
+                for( int ii = 0; ii < count; ++ii )
+                {
+                    int halfWidth = widths[ii] / 2;
+                    int actual = 0;
+
+                    if( segs[ii].Collide( q, clearance + halfWidth, &actual ) )
+                        expected = std::min( expected, std::max( 0, actual - halfWidth ) );
+                }
+
+                int actual = -1;
+                int tag = -1;
+
+                BOOST_CHECK_EQUAL( batch.Collide( q, clearance ), expected != INT_MAX );
+                BOOST_CHECK_EQUAL( batch.Collide( q, clearance, &actual, &tag ),
+                                   expected != INT_MAX );
+
+                if( expected != INT_MAX )
+                {
+                    BOOST_CHECK_EQUAL( actual, expected );
+                    BOOST_REQUIRE( tag >= 0 && tag < count );
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * Arcs are tested with their own exact collision routine.
+ */
+BOOST_AUTO_TEST_CASE( MatchesPairwiseArcs )
+{
+    std::mt19937           rng( 7 );
+    std::vector<SHAPE_ARC> arcs;
+
+    for( int ii = 0; ii < 50; ++ii )
+    {
+        VECTOR2I center( rng() % 100000, rng() % 100000 );
+        VECTOR2I start = center + VECTOR2I( 1000 + rng() % 5000, 0 );
+
+        arcs.emplace_back( center, start, EDA_ANGLE( 10 + rng() % 300, DEGREES_T ) );
+    }
+
+    SEG_BATCH batch;
+
+    for( size_t ii = 0; ii < arcs.size(); ++ii )
+        batch.Add( &arcs[ii], (int) ii );
+
+    for( int query = 0; query < 500; ++query )
+    {
+        SEG q = randomSeg( rng );
+        int clearance = rng() % 5000;
+        int expected = INT_MAX;
+
+        for( const SHAPE_ARC& arc : arcs )
+        {
+            int actual = 0;
+
+            if( arc.Collide( q, clearance, &actual ) )
+                expected = std::min( expected, actual );
+        }
+
+        int actual = -1;
+
+        BOOST_CHECK_EQUAL( batch.Collide( q, clearance, &actual ), expected != INT_MAX );
+
+        if( expected != INT_MAX )
+            BOOST_CHECK_EQUAL( actual, expected );
+    }
+}
+
+
+/**
+ * Chain against chain collisions go through the batch; the result must match testing each pair
+ * of segments, and asking only for the location must give the location of the closest pair.
+ */
+BOOST_AUTO_TEST_CASE( LineChainCollide )
+{
+    std::mt19937     rng( 3 );
+    SHAPE_LINE_CHAIN chain;
+    VECTOR2I         pt( 50000, 50000 );
+
+    for( int ii = 0; ii < 200; ++ii )
+    {
+        chain.Append( pt );
+        pt += VECTOR2I( (int) ( rng() % 2000 ) - 1000, (int) ( rng() % 2000 ) - 1000 );
+    }
+
+    for( int query = 0; query < 500; ++query )
+    {
+        SEG              q = randomSeg( rng );
+        SHAPE_LINE_CHAIN other( std::vector<VECTOR2I>{ q.A, q.B } );
+        int              clearance = rng() % 3000;
+        int              expected = INT_MAX;
+
+        for( int ii = 0; ii < chain.SegmentCount(); ++ii )
+        {
+            int actual = 0;
+
+            if( chain.CSegment( ii ).Collide( q, clearance, &actual ) )
+                expected = std::min( expected, actual );
+        }
+
+        int      actual = -1;
+        VECTOR2I location;
+        VECTOR2I locationOnly;
+
+        BOOST_CHECK_EQUAL( chain.Collide( &other, clearance, &actual, &location ),
+                           expected != INT_MAX );
+        BOOST_CHECK_EQUAL( chain.Collide( &other, clearance, nullptr, &locationOnly ),
+                           expected != INT_MAX );
+
+        if( expected != INT_MAX )
+        {
+            BOOST_CHECK_EQUAL( actual, expected );
+            BOOST_CHECK_EQUAL( locationOnly, location );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,204 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <board.h>
+#include <board_design_settings.h>
+#include <footprint.h>
+#include <pcb_shape.h>
+#include <pcb_track.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
+#include <core/kicad_algo.h>
+#include <settings/settings_manager.h>
+
+
+struct DRC_INCREMENTAL_TEST_FIXTURE
+{
+    DRC_INCREMENTAL_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+/// The violations of a DRC run, along with the providers which found them
+typedef std::vector<std::pair<DRC_TEST_PROVIDER*, std::string>> VIOLATIONS;
+
+
+static VIOLATIONS runDRC( DRC_ENGINE* aEngine )
+{
+    VIOLATIONS violations;
+
+    aEngine->SetViolationHandler(
+            [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+            {
+                wxString marker = wxString::Format( wxT( "%d (%d, %d) %d %s %s" ),
+                                                    aItem->GetErrorCode(), aPos.x, aPos.y, aLayer,
+                                                    aItem->GetMainItemID().AsString(),
+                                                    aItem->GetAuxItemID().AsString() );
+
+                violations.emplace_back( aItem->GetViolatingTest(), marker.ToStdString() );
+            } );
+
+    aEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+    aEngine->ClearViolationHandler();
+
+    return violations;
+}
+
+
+static std::vector<std::string> markers( const VIOLATIONS& aViolations )
+{
+    std::vector<std::string> markers;
+
+    for( const auto& [ provider, marker ] : aViolations )
+        markers.push_back( marker );
+
+    std::sort( markers.begin(), markers.end() );
+    return markers;
+}
+
+
+/**
+ * Make an edit the way BOARD_COMMIT would, then check that merging the markers of an incremental
+ * run into those of the previous run (as DRC_TOOL does) gives the markers of a full run.
+ */
+static void checkEdit( BOARD* aBoard, const std::function<void()>& aEdit, bool aExpectSkipped )
+{
+    DRC_ENGINE* engine = aBoard->GetDesignSettings().m_DRCEngine.get();
+
+    engine->SetIncrementalMode( true );
+
+    VIOLATIONS previous = runDRC( engine );
+
+    aEdit();
+    aBoard->BuildConnectivity();
+
+    VIOLATIONS                             merged = runDRC( engine );
+    const std::vector<DRC_TEST_PROVIDER*>& rerun = engine->GetLastRunProviders();
+
+    if( aExpectSkipped )
+        BOOST_CHECK_LT( rerun.size(), engine->GetTestProviders().size() );
+
+    for( const auto& [ provider, marker ] : previous )
+    {
+        if( !alg::contains( rerun, provider ) )
+            merged.emplace_back( provider, marker );
+    }
+
+    engine->SetIncrementalMode( false );
+
+    std::vector<std::string> incremental = markers( merged );
+    std::vector<std::string> full = markers( runDRC( engine ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( incremental.begin(), incremental.end(),
+                                   full.begin(), full.end() );
+}
+
+
+BOOST_FIXTURE_TEST_CASE( DRCIncrementalMatchesFull, DRC_INCREMENTAL_TEST_FIXTURE )
+{
+    KI_TEST::LoadBoard( m_settingsManager, "issue6945", m_board );
+
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+
+    // These need a footprint library associated to the board
+    bds.m_DRCSeverities[ DRCE_LIB_FOOTPRINT_ISSUES ] = SEVERITY::RPT_SEVERITY_IGNORE;
+    bds.m_DRCSeverities[ DRCE_LIB_FOOTPRINT_MISMATCH ] = SEVERITY::RPT_SEVERITY_IGNORE;
+
+    PCB_TRACK* track = nullptr;
+
+    for( PCB_TRACK* candidate : m_board->Tracks() )
+    {
+        if( candidate->Type() == PCB_TRACE_T )
+        {
+            track = candidate;
+            break;
+        }
+    }
+
+    BOOST_REQUIRE( track );
+    BOOST_REQUIRE( !m_board->Footprints().empty() );
+
+    FOOTPRINT*                  footprint = m_board->Footprints().front();
+    VECTOR2I                    offset( pcbIUScale.mmToIU( 0.5 ), pcbIUScale.mmToIU( 0.5 ) );
+    std::unique_ptr<BOARD_ITEM> before;
+    std::unique_ptr<PCB_TRACK>  removed;
+
+    BOOST_TEST_CONTEXT( "Move a track" )
+    {
+        checkEdit( m_board.get(),
+                   [&]()
+                   {
+                       before.reset( static_cast<BOARD_ITEM*>( track->Clone() ) );
+                       track->Move( offset );
+                       m_board->MarkDRCDirty( track, before.get(), false );
+                   },
+                   false );
+    }
+
+    BOOST_TEST_CONTEXT( "Add a non-copper graphic" )
+    {
+        checkEdit( m_board.get(),
+                   [&]()
+                   {
+                       PCB_SHAPE* shape = new PCB_SHAPE( m_board.get(), SHAPE_T::SEGMENT );
+
+                       shape->SetLayer( Cmts_User );
+                       shape->SetStart( track->GetStart() );
+                       shape->SetEnd( track->GetEnd() );
+                       shape->SetWidth( pcbIUScale.mmToIU( 0.1 ) );
+
+                       m_board->Add( shape );
+                       m_board->MarkDRCDirty( shape, nullptr, false );
+                   },
+                   true );
+    }
+
+    BOOST_TEST_CONTEXT( "Move a footprint" )
+    {
+        checkEdit( m_board.get(),
+                   [&]()
+                   {
+                       before.reset( static_cast<BOARD_ITEM*>( footprint->Clone() ) );
+                       footprint->Move( offset );
+                       m_board->MarkDRCDirty( footprint, before.get(), false );
+                   },
+                   false );
+    }
+
+    BOOST_TEST_CONTEXT( "Remove a track" )
+    {
+        checkEdit( m_board.get(),
+                   [&]()
+                   {
+                       m_board->MarkDRCDirty( track, nullptr, true );
+                       m_board->Remove( track );
+                       removed.reset( track );
+                   },
+                   false );
+    }
+}
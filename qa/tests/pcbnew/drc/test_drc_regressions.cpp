@@ -29,7 +29,9 @@
 #include <pcb_track.h>
 #include <pcb_marker.h>
 #include <footprint.h>
+#include <drc/drc_engine.h>
 #include <drc/drc_item.h>
+#include <reporter.h>
 #include <settings/settings_manager.h>
 
 
@@ -201,3 +203,116 @@ BOOST_FIXTURE_TEST_CASE( DRCFalseNegativeRegressions, DRC_REGRESSION_TEST_FIXTUR
         }
     }
 }
+
+
+BOOST_FIXTURE_TEST_CASE( DRCScheduledModeRegressions, DRC_REGRESSION_TEST_FIXTURE )
+{
+    // Running the providers concurrently must find exactly what running them serially does
+
+    std::vector<wxString> tests =
+    {
+        "issue2512",
+        "issue5854",
+        "issue6879",
+        "issue12109",
+        "issue16566",
+        "intersectingzones"
+    };
+
+    for( const wxString& testName : tests )
+    {
+        BOOST_TEST_CONTEXT( testName )
+        {
+            KI_TEST::LoadBoard( m_settingsManager, testName, m_board );
+
+            std::map<int, int>     serialCounts;
+            std::map<int, int>     scheduledCounts;
+            std::map<int, int>*    counts = nullptr;
+            BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+
+            bds.m_DRCSeverities[DRCE_LIB_FOOTPRINT_ISSUES] = SEVERITY::RPT_SEVERITY_IGNORE;
+            bds.m_DRCSeverities[DRCE_LIB_FOOTPRINT_MISMATCH] = SEVERITY::RPT_SEVERITY_IGNORE;
+
+            bds.m_DRCEngine->SetViolationHandler(
+                    [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+                    {
+                        ( *counts )[ aItem->GetErrorCode() ]++;
+                    } );
+
+            counts = &serialCounts;
+            bds.m_DRCEngine->SetScheduledMode( false );
+            bds.m_DRCEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+            counts = &scheduledCounts;
+            bds.m_DRCEngine->SetScheduledMode( true );
+            bds.m_DRCEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+            BOOST_CHECK( serialCounts == scheduledCounts );
+        }
+    }
+}
+
+
+BOOST_FIXTURE_TEST_CASE( DRCConstraintCacheRegressions, DRC_REGRESSION_TEST_FIXTURE )
+{
+    // Constraints served from the resolution cache must match those resolved from scratch
+    // (resolving with a reporter always bypasses the cache)
+
+    std::vector<wxString> tests =
+    {
+        "issue7975",
+        "issue12109",
+        "multinetclasses_drc"
+    };
+
+    for( const wxString& testName : tests )
+    {
+        BOOST_TEST_CONTEXT( testName )
+        {
+            KI_TEST::LoadBoard( m_settingsManager, testName, m_board );
+
+            std::shared_ptr<DRC_ENGINE> drcEngine = m_board->GetDesignSettings().m_DRCEngine;
+            std::vector<BOARD_ITEM*>    items;
+            NULL_REPORTER               reporter;
+
+            for( PCB_TRACK* track : m_board->Tracks() )
+                items.push_back( track );
+
+            for( FOOTPRINT* fp : m_board->Footprints() )
+            {
+                for( PAD* pad : fp->Pads() )
+                    items.push_back( pad );
+            }
+
+            if( items.size() > 40 )
+                items.resize( 40 );
+
+            for( int pass = 0; pass < 2; ++pass )
+            {
+                for( BOARD_ITEM* a : items )
+                {
+                    for( BOARD_ITEM* b : items )
+                    {
+                        for( DRC_CONSTRAINT_T type : { CLEARANCE_CONSTRAINT,
+                                                       HOLE_CLEARANCE_CONSTRAINT,
+                                                       TRACK_WIDTH_CONSTRAINT } )
+                        {
+                            PCB_LAYER_ID   layer = a->GetLayerSet().Seq().front();
+                            DRC_CONSTRAINT cached = drcEngine->EvalRules( type, a, b, layer );
+                            DRC_CONSTRAINT fresh = drcEngine->EvalRules( type, a, b, layer,
+                                                                         &reporter );
+
+                            BOOST_CHECK_EQUAL( cached.m_Value.HasMin(), fresh.m_Value.HasMin() );
+                            BOOST_CHECK_EQUAL( cached.m_Value.Min(), fresh.m_Value.Min() );
+                            BOOST_CHECK_EQUAL( cached.m_Value.Opt(), fresh.m_Value.Opt() );
+                            BOOST_CHECK_EQUAL( cached.m_Value.Max(), fresh.m_Value.Max() );
+                            BOOST_CHECK( cached.GetParentRule() == fresh.GetParentRule() );
+                        }
+                    }
+                }
+            }
+
+            BOOST_CHECK( drcEngine->GetConstraintCacheHits() > 0 );
+        }
+    }
+}
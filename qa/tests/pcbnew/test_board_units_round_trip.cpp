@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+
+#include <fmt/format.h>
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <base_units.h>
+#include <dsnlexer.h>
+#include <eda_units.h>
+#include <locale_io.h>
+#include <math/util.h>
+#include <richio.h>
+
+
+BOOST_AUTO_TEST_SUITE( BoardUnitsRoundTrip )
+
+
+/**
+ * The way FormatInternalUnits() wrote internal units before it used integer arithmetic.
+ */
+static std::string formatAsDouble( int aValue )
+{
+    double      engUnits = aValue / pcbIUScale.IU_PER_MM;
+    std::string buf;
+
+    if( engUnits != 0.0 && std::abs( engUnits ) <= 0.0001 )
+    {
+        buf = fmt::format( "{:.10f}", engUnits );
+
+        while( !buf.empty() && buf.back() == '0' )
+            buf.pop_back();
+
+        if( buf.back() == '.' )
+            buf.pop_back();
+    }
+    else
+    {
+        buf = fmt::format( "{:.10g}", engUnits );
+    }
+
+    return buf;
+}
+
+
+/**
+ * Every number in the test boards must convert to the same internal units as through a
+ * double, and must be written back as the same text as through a double, which converts to
+ * the same internal units again.
+ */
+BOOST_AUTO_TEST_CASE( TestBoards )
+{
+    LOCALE_IO toggle;
+    int       boards = 0;
+
+    for( const std::filesystem::directory_entry& entry :
+         std::filesystem::directory_iterator( KI_TEST::GetPcbnewTestDataDir() ) )
+    {
+        if( entry.path().extension() != ".kicad_pcb" )
+            continue;
+
+        BOOST_TEST_CONTEXT( entry.path().filename().string() )
+        {
+            FILE_LINE_READER reader( entry.path().string() );
+            DSNLEXER         lexer( nullptr, 0, nullptr, &reader );
+            int              numbers = 0;
+
+            for( int token = lexer.NextTok(); token != DSN_EOF; token = lexer.NextTok() )
+            {
+                if( token != DSN_NUMBER )
+                    continue;
+
+                const std::string& text = lexer.CurStr();
+                const char*        end = text.data() + text.size();
+                int                value = 0;
+
+                // Only check the numbers which are entirely a number, like those the board
+                // parser converts
+                std::from_chars_result read = EDA_UNIT_UTILS::ParseInternalUnits( text.data(), end,
+                                                                                  pcbIUScale,
+                                                                                  value );
+
+                if( read.ec != std::errc() || read.ptr != end )
+                    continue;
+
+                ++numbers;
+
+                int expected = KiROUND( std::strtod( text.c_str(), nullptr )
+                                        * pcbIUScale.IU_PER_MM, true );
+
+                if( value != expected )
+                {
+                    BOOST_ERROR( "'" << text << "' reads as " << value << " instead of "
+                                     << expected << " on line " << lexer.CurLineNumber() );
+                    continue;
+                }
+
+                char                 buf[32];
+                std::to_chars_result written = EDA_UNIT_UTILS::FormatInternalUnits(
+                        buf, buf + sizeof( buf ), pcbIUScale, value );
+                int                  reread = 0;
+
+                BOOST_REQUIRE( written.ec == std::errc() );
+
+                std::string formatted( buf, written.ptr );
+
+                if( formatted != formatAsDouble( value ) )
+                {
+                    BOOST_ERROR( value << " is written as '" << formatted << "' instead of '"
+                                       << formatAsDouble( value ) << "'" );
+                }
+
+                read = EDA_UNIT_UTILS::ParseInternalUnits( buf, written.ptr, pcbIUScale, reread );
+
+                if( read.ec != std::errc() || read.ptr != written.ptr || reread != value )
+                {
+                    BOOST_ERROR( "'" << text << "' is written as '" << formatted << "'" );
+                }
+            }
+
+            BOOST_CHECK_GT( numbers, 0 );
+            ++boards;
+        }
+    }
+
+    BOOST_CHECK_GT( boards, 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,161 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <advanced_config.h>
+#include <board.h>
+#include <ki_exception.h>
+#include <locale_io.h>
+#include <richio.h>
+#include <pcb_io/kicad_sexpr/pcb_io_kicad_sexpr_parser.h>
+
+
+BOOST_AUTO_TEST_SUITE( ConcurrentBoardLoad )
+
+
+static std::string readTestBoard( const std::string& aName )
+{
+    std::ifstream      file( KI_TEST::GetPcbnewTestDataDir() + aName + ".kicad_pcb" );
+    std::ostringstream text;
+
+    text << file.rdbuf();
+    return text.str();
+}
+
+
+/**
+ * Insert @a aText after the first @a aAfter which follows the @a aIndex'th top-level
+ * @a aItem of the board.
+ */
+static void insertInItem( std::string& aBoard, const std::string& aItem, int aIndex,
+                          const std::string& aAfter, const std::string& aText )
+{
+    size_t pos = 0;
+
+    for( int ii = 0; ii <= aIndex; ++ii )
+    {
+        pos = aBoard.find( "\n  (" + aItem + " ", pos + 1 );
+        BOOST_REQUIRE( pos != std::string::npos );
+    }
+
+    pos = aBoard.find( aAfter, pos );
+    BOOST_REQUIRE( pos != std::string::npos );
+
+    aBoard.insert( pos + aAfter.size(), aText );
+}
+
+
+/**
+ * Parse @a aBoard with the concurrent load on or off, with thresholds low enough for a small
+ * board to be split into chunks.
+ *
+ * @return the board as saved again, or the text of the error which stopped the parser.
+ */
+static std::string parseAndSave( const std::string& aBoard, bool aConcurrent )
+{
+    ADVANCED_CFG& cfg = const_cast<ADVANCED_CFG&>( ADVANCED_CFG::GetCfg() );
+    bool          wasConcurrent = cfg.m_ConcurrentBoardLoad;
+
+    cfg.m_ConcurrentBoardLoad = aConcurrent;
+
+    LOCALE_IO                 toggle;
+    SPAN_LINE_READER          reader( aBoard.data(), aBoard.data() + aBoard.size(),
+                                      wxT( "test board" ) );
+    PCB_IO_KICAD_SEXPR_PARSER parser( &reader, nullptr, nullptr );
+    std::unique_ptr<BOARD>    board;
+    std::string               result;
+
+    parser.SetConcurrentLoadThresholds( 0, 1 );
+
+    try
+    {
+        board.reset( dynamic_cast<BOARD*>( parser.Parse() ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        result = "error: " + ioe.What().ToStdString();
+    }
+
+    cfg.m_ConcurrentBoardLoad = wasConcurrent;
+
+    if( board )
+    {
+        auto savePath = std::filesystem::temp_directory_path() / "concurrent_load_tst.kicad_pcb";
+
+        KI_TEST::DumpBoardToFile( *board, savePath.string() );
+
+        std::ifstream      file( savePath );
+        std::ostringstream saved;
+
+        saved << file.rdbuf();
+        result = saved.str();
+    }
+
+    return result;
+}
+
+
+/**
+ * A board parsed in chunks on the thread pool must save to exactly the same text as one parsed
+ * sequentially, and a parse error must be reported the same way.
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentMatchesSequential )
+{
+    const std::string original = readTestBoard( "issue5990" );
+
+    std::string unknownNets = original;
+    insertInItem( unknownNets, "zone", 2, "(net_name \"", "Unknown_net_A-" );
+    insertInItem( unknownNets, "zone", 7, "(net_name \"", "Unknown_net_B-" );
+
+    std::string parseError = original;
+    insertInItem( parseError, "segment", 80, "(segment ", "(not_a_token 1) " );
+
+    const std::vector<std::pair<std::string, const std::string*>> boards = {
+        { "unchanged", &original },
+        { "zones on unknown nets", &unknownNets },
+        { "parse error in a segment", &parseError }
+    };
+
+    for( const auto& [ name, text ] : boards )
+    {
+        BOOST_TEST_CONTEXT( name )
+        {
+            std::string sequential = parseAndSave( *text, false );
+            std::string concurrent = parseAndSave( *text, true );
+
+            BOOST_CHECK( !sequential.empty() );
+            BOOST_CHECK( concurrent == sequential );
+        }
+    }
+
+    BOOST_CHECK( parseAndSave( unknownNets, true ).find( "Unknown_net_B-" ) != std::string::npos );
+    BOOST_CHECK( parseAndSave( parseError, true ).rfind( "error: ", 0 ) == 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,360 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_file_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <board.h>
+#include <footprint.h>
+#include <netinfo.h>
+#include <pad.h>
+#include <pcb_track.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+#include <ratsnest/ratsnest_data.h>
+#include <settings/settings_manager.h>
+
+
+struct CONNECTIVITY_TEST_FIXTURE
+{
+    CONNECTIVITY_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+/// The number of edges and the total weight of the spanning tree of each net
+typedef std::map<int, std::pair<size_t, uint64_t>> RATSNEST_WEIGHTS;
+
+
+static RATSNEST_WEIGHTS ratsnestWeights( BOARD* aBoard, CONNECTIVITY_DATA* aConnectivity )
+{
+    RATSNEST_WEIGHTS weights;
+
+    for( NETINFO_ITEM* net : aBoard->GetNetInfo() )
+    {
+        RN_NET* rnNet = aConnectivity->GetRatsnestForNet( net->GetNetCode() );
+
+        if( net->GetNetCode() <= 0 || !rnNet )
+            continue;
+
+        auto& [ count, weight ] = weights[ net->GetNetCode() ];
+
+        count = rnNet->GetEdges().size();
+        weight = 0;
+
+        for( const CN_EDGE& edge : rnNet->GetEdges() )
+            weight += edge.GetWeight();
+    }
+
+    return weights;
+}
+
+
+/**
+ * Move some footprints the way BOARD_COMMIT would, then check that the updated ratsnest spans
+ * each net with a tree of the same weight as a ratsnest built from scratch.  The spanning tree
+ * itself may differ where edges have the same weight.
+ */
+static void checkMove( BOARD* aBoard, const std::vector<FOOTPRINT*>& aFootprints,
+                       const VECTOR2I& aOffset )
+{
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = aBoard->GetConnectivity();
+
+    for( FOOTPRINT* footprint : aFootprints )
+    {
+        footprint->Move( aOffset );
+        connectivity->Update( footprint );
+    }
+
+    connectivity->RecalculateRatsnest();
+
+    // A new CONNECTIVITY_DATA has no triangulations to reuse
+    std::shared_ptr<CONNECTIVITY_DATA> full = std::make_shared<CONNECTIVITY_DATA>();
+    full->Build( aBoard );
+
+    RATSNEST_WEIGHTS incremental = ratsnestWeights( aBoard, connectivity.get() );
+    RATSNEST_WEIGHTS expected = ratsnestWeights( aBoard, full.get() );
+
+    BOOST_REQUIRE_EQUAL( incremental.size(), expected.size() );
+
+    for( const auto& [ netCode, countAndWeight ] : expected )
+    {
+        BOOST_CHECK_MESSAGE( incremental[ netCode ] == countAndWeight,
+                             "Net " << aBoard->FindNet( netCode )->GetNetname() << ": "
+                                    << incremental[ netCode ].first << " edges of total weight "
+                                    << incremental[ netCode ].second << ", expected "
+                                    << countAndWeight.first << " edges of total weight "
+                                    << countAndWeight.second );
+    }
+}
+
+
+BOOST_FIXTURE_TEST_CASE( IncrementalRatsnestMatchesFull, CONNECTIVITY_TEST_FIXTURE )
+{
+    KI_TEST::LoadBoard( m_settingsManager, "issue14559", m_board );
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board->GetConnectivity();
+    int                                largestNet = 0;
+    unsigned int                       largestNodeCount = 0;
+
+    for( NETINFO_ITEM* net : m_board->GetNetInfo() )
+    {
+        RN_NET* rnNet = connectivity->GetRatsnestForNet( net->GetNetCode() );
+
+        if( net->GetNetCode() > 0 && rnNet && rnNet->GetNodeCount() > largestNodeCount )
+        {
+            largestNet = net->GetNetCode();
+            largestNodeCount = rnNet->GetNodeCount();
+        }
+    }
+
+    // Moving a single footprint must only change a few of the positions of the net, so that
+    // its previous triangulation gets patched rather than rebuilt
+    BOOST_REQUIRE_GT( largestNodeCount, 40u );
+
+    FOOTPRINT* onLargestNet = nullptr;
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+        {
+            if( pad->GetNetCode() == largestNet )
+                onLargestNet = footprint;
+        }
+
+        if( onLargestNet )
+            break;
+    }
+
+    BOOST_REQUIRE( onLargestNet );
+
+    // Every tenth footprint dirties enough nets, of all sizes, to need several update batches
+    std::vector<FOOTPRINT*> everyTenth;
+
+    for( size_t ii = 0; ii < m_board->Footprints().size(); ii += 10 )
+        everyTenth.push_back( m_board->Footprints()[ii] );
+
+    VECTOR2I offset( pcbIUScale.mmToIU( 1.27 ), pcbIUScale.mmToIU( -0.635 ) );
+
+    BOOST_TEST_CONTEXT( "Move a footprint on the largest net" )
+    {
+        checkMove( m_board.get(), { onLargestNet }, offset );
+    }
+
+    BOOST_TEST_CONTEXT( "Move the same footprint again" )
+    {
+        checkMove( m_board.get(), { onLargestNet }, offset );
+    }
+
+    BOOST_TEST_CONTEXT( "Move it back" )
+    {
+        checkMove( m_board.get(), { onLargestNet }, -2 * offset );
+    }
+
+    BOOST_TEST_CONTEXT( "Move every tenth footprint" )
+    {
+        checkMove( m_board.get(), everyTenth, offset );
+    }
+}
+
+
+/// The items of each ratsnest cluster, by UUID
+typedef std::set<std::set<KIID>> CLUSTER_SET;
+
+
+static CLUSTER_SET ratsnestClusters( BOARD* aBoard )
+{
+    std::map<CN_CLUSTER*, std::set<KIID>> clusters;
+
+    for( CN_ITEM* item : aBoard->GetConnectivity()->GetConnectivityAlgo()->ItemList() )
+    {
+        BOARD_CONNECTED_ITEM* parent = item->Parent();
+
+        // Zone islands left out of the ratsnest keep whatever cluster they last had
+        if( !item->Valid() || item->Anchors().empty() || parent->Type() == PCB_ZONE_T
+                || parent->GetNetCode() <= 0 )
+        {
+            continue;
+        }
+
+        clusters[ item->Anchors().front()->GetCluster().get() ].insert( parent->m_Uuid );
+    }
+
+    CLUSTER_SET clusterSet;
+
+    for( const auto& [ cluster, items ] : clusters )
+        clusterSet.insert( items );
+
+    return clusterSet;
+}
+
+
+static std::map<KIID, int> netCodes( BOARD* aBoard )
+{
+    std::map<KIID, int> netCodes;
+
+    for( PCB_TRACK* track : aBoard->Tracks() )
+        netCodes[ track->m_Uuid ] = track->GetNetCode();
+
+    for( FOOTPRINT* footprint : aBoard->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+            netCodes[ pad->m_Uuid ] = pad->GetNetCode();
+    }
+
+    return netCodes;
+}
+
+
+static std::unique_ptr<BOARD> loadBoard( const std::string& aName )
+{
+    std::unique_ptr<BOARD> board =
+            KI_TEST::ReadBoardFromFileOrStream( KI_TEST::GetPcbnewTestDataDir() + aName
+                                                + ".kicad_pcb" );
+
+    BOOST_REQUIRE( board );
+
+    board->BuildListOfNets();
+    board->BuildConnectivity();
+
+    return board;
+}
+
+
+/**
+ * Make the same edits to two copies of a board.  The connectivity of the first is updated after
+ * each edit, the way BOARD_COMMIT does, and that of the second is built from scratch.  Both must
+ * give the same nets to the same items, and split them into the same ratsnest clusters.
+ */
+BOOST_AUTO_TEST_CASE( IncrementalConnectivityMatchesFull )
+{
+    std::unique_ptr<BOARD> board = loadBoard( "issue14559" );
+    std::unique_ptr<BOARD> fullBoard = loadBoard( "issue14559" );
+
+    std::vector<std::unique_ptr<BOARD_ITEM>> removed;
+
+    auto addTrack =
+            [&]( BOARD* aBoard, const PCB_TRACK& aTemplate )
+            {
+                // The clone keeps the UUID of the template, so it is the same in both boards
+                PCB_TRACK* track = static_cast<PCB_TRACK*>( aTemplate.Clone() );
+
+                track->SetParent( aBoard );
+                track->SetNetCode( aTemplate.GetNetCode() );
+                aBoard->Add( track );
+            };
+
+    auto removeItem =
+            [&]( BOARD* aBoard, const KIID& aId )
+            {
+                BOARD_ITEM* item = aBoard->GetItem( aId );
+
+                BOOST_REQUIRE( item );
+
+                aBoard->Remove( item );
+                removed.emplace_back( item );
+            };
+
+    auto checkEdit =
+            [&]( const std::function<void( BOARD* )>& aEdit )
+            {
+                aEdit( board.get() );
+                board->GetConnectivity()->RecalculateRatsnest();
+
+                aEdit( fullBoard.get() );
+                fullBoard->BuildConnectivity();
+
+                BOOST_CHECK( netCodes( board.get() ) == netCodes( fullBoard.get() ) );
+                BOOST_CHECK( ratsnestClusters( board.get() )
+                             == ratsnestClusters( fullBoard.get() ) );
+            };
+
+    auto joinsTracks =
+            [&]( PCB_TRACK* aTrack, const VECTOR2I& aPoint )
+            {
+                for( PCB_TRACK* other : board->Tracks() )
+                {
+                    if( other != aTrack && other->Type() == PCB_TRACE_T
+                            && ( other->GetStart() == aPoint || other->GetEnd() == aPoint ) )
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+    // A track in the middle of a run of tracks, so that removing it splits its cluster
+    PCB_TRACK* middle = nullptr;
+
+    for( PCB_TRACK* track : board->Tracks() )
+    {
+        if( track->Type() == PCB_TRACE_T && track->GetNetCode() > 0
+                && joinsTracks( track, track->GetStart() )
+                && joinsTracks( track, track->GetEnd() ) )
+        {
+            middle = track;
+            break;
+        }
+    }
+
+    BOOST_REQUIRE( middle );
+
+    KIID middleId = middle->m_Uuid;
+
+    // Tracks without a net, to be given one by net propagation
+    PCB_TRACK stub( board.get() );
+    stub.SetStart( middle->GetEnd() );
+    stub.SetEnd( middle->GetEnd() + VECTOR2I( pcbIUScale.mmToIU( 2 ), 0 ) );
+    stub.SetWidth( middle->GetWidth() );
+    stub.SetLayer( middle->GetLayer() );
+
+    PCB_TRACK bridge( board.get() );
+    bridge.SetStart( middle->GetStart() );
+    bridge.SetEnd( middle->GetEnd() );
+    bridge.SetWidth( middle->GetWidth() );
+    bridge.SetLayer( middle->GetLayer() );
+
+    BOOST_TEST_CONTEXT( "Add a track" )
+    {
+        checkEdit( [&]( BOARD* aBoard ) { addTrack( aBoard, stub ); } );
+    }
+
+    BOOST_TEST_CONTEXT( "Split a cluster" )
+    {
+        checkEdit( [&]( BOARD* aBoard ) { removeItem( aBoard, middleId ); } );
+    }
+
+    BOOST_TEST_CONTEXT( "Merge two clusters" )
+    {
+        checkEdit( [&]( BOARD* aBoard ) { addTrack( aBoard, bridge ); } );
+    }
+
+    BOOST_TEST_CONTEXT( "Remove a track" )
+    {
+        checkEdit( [&]( BOARD* aBoard ) { removeItem( aBoard, stub.m_Uuid ); } );
+    }
+}
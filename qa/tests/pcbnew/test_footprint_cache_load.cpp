@@ -0,0 +1,150 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <filesystem>
+#include <fstream>
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <advanced_config.h>
+#include <ki_exception.h>
+#include <pcb_io/kicad_sexpr/pcb_io_kicad_sexpr.h>
+#include <wildcards_and_files_ext.h>
+
+#include <wx/dir.h>
+
+
+struct FOOTPRINT_CACHE_LOAD_FIXTURE
+{
+    FOOTPRINT_CACHE_LOAD_FIXTURE()
+    {
+        m_libPath = std::filesystem::temp_directory_path() / "fp_cache_load_tst.pretty";
+
+        std::filesystem::remove_all( m_libPath );
+        std::filesystem::create_directories( m_libPath );
+    }
+
+    ~FOOTPRINT_CACHE_LOAD_FIXTURE()
+    {
+        std::filesystem::remove_all( m_libPath );
+    }
+
+    void writeFile( const std::string& aName, const std::string& aContents )
+    {
+        std::ofstream file( m_libPath / ( aName + ".kicad_mod" ) );
+        file << aContents;
+    }
+
+    /// Enumerate the library with a fresh cache, returning the footprint names and the error text
+    std::pair<wxArrayString, wxString> load( bool aConcurrent )
+    {
+        ADVANCED_CFG& cfg = const_cast<ADVANCED_CFG&>( ADVANCED_CFG::GetCfg() );
+        bool          wasConcurrent = cfg.m_FootprintCacheConcurrentLoad;
+
+        cfg.m_FootprintCacheConcurrentLoad = aConcurrent;
+
+        PCB_IO_KICAD_SEXPR io;
+        wxArrayString      names;
+        wxString           error;
+
+        try
+        {
+            io.FootprintEnumerate( names, m_libPath.string(), false );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            error = ioe.What();
+        }
+
+        cfg.m_FootprintCacheConcurrentLoad = wasConcurrent;
+
+        return { names, error };
+    }
+
+    std::filesystem::path m_libPath;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FootprintCacheLoad, FOOTPRINT_CACHE_LOAD_FIXTURE )
+
+
+/**
+ * A library big enough to be parsed on the thread pool must give the same footprints, and the
+ * same errors in directory order, as one parsed on the calling thread.
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentMatchesSerial )
+{
+    const int footprintCount = 40;
+
+    for( int ii = 0; ii < footprintCount; ++ii )
+    {
+        std::string name = "FP_" + std::to_string( ii );
+
+        writeFile( name, "(footprint \"" + name + "\" (version 20231007) (generator pcbnew)\n"
+                         "  (layer \"F.Cu\")\n"
+                         "  (attr smd)\n"
+                         ")\n" );
+    }
+
+    writeFile( "BAD_UNTERMINATED", "(footprint \"BAD_UNTERMINATED\" (layer \"F.Cu\")\n" );
+    writeFile( "BAD_TOKEN", "(footprint \"BAD_TOKEN\" (layer \"F.Cu\") (not_a_token 1))\n" );
+
+    // The errors are reported in the order the directory lists the files
+    std::vector<wxString> badPaths;
+    wxDir                 dir( m_libPath.string() );
+    wxString              fileName;
+    wxString              fileSpec = wxT( "*." ) + wxString( FILEEXT::KiCadFootprintFileExtension );
+
+    for( bool ok = dir.GetFirst( &fileName, fileSpec ); ok; ok = dir.GetNext( &fileName ) )
+    {
+        if( fileName.StartsWith( wxT( "BAD_" ) ) )
+            badPaths.push_back( wxString( m_libPath.string() ) + wxT( '/' ) + fileName );
+    }
+
+    BOOST_REQUIRE_EQUAL( badPaths.size(), 2u );
+
+    auto [ serialNames, serialError ] = load( false );
+    auto [ concurrentNames, concurrentError ] = load( true );
+
+    BOOST_CHECK_EQUAL( (int) serialNames.size(), footprintCount );
+    BOOST_CHECK( concurrentNames == serialNames );
+
+    for( int ii = 0; ii < footprintCount; ++ii )
+    {
+        wxString name = wxString::Format( wxT( "FP_%d" ), ii );
+
+        BOOST_CHECK_MESSAGE( concurrentNames.Index( name ) != wxNOT_FOUND, name + " not loaded" );
+    }
+
+    BOOST_CHECK_EQUAL( concurrentError, serialError );
+
+    int first = concurrentError.Find( wxString::Format( wxT( "Unable to read file '%s'" ),
+                                                        badPaths[0] ) );
+    int second = concurrentError.Find( wxString::Format( wxT( "Unable to read file '%s'" ),
+                                                         badPaths[1] ) );
+
+    BOOST_CHECK_NE( first, wxNOT_FOUND );
+    BOOST_CHECK_GT( second, first );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -82,7 +82,16 @@ const static std::vector<EXPR_TO_TEST> introspectionExpressions = {
     { "A.Netclass + 1.0", false, VAL( 1.0 ) },
     { "A.type == 'Track' && B.type == 'Track' && A.layer == 'F.Cu'", false, VAL( 1.0 ) },
     { "(A.type == 'Track') && (B.type == 'Track') && (A.layer == 'F.Cu')", false, VAL( 1.0 ) },
-    { "A.type == 'Via' && A.isMicroVia()", false, VAL(0.0) }
+    { "A.type == 'Via' && A.isMicroVia()", false, VAL(0.0) },
+    // Short-circuited logical operators
+    { "A.Netclass == 'HV' || A.Width > 1000mm", false, VAL( 1.0 ) },
+    { "A.Netclass == 'otherClass' && A.Width < 1000mm", false, VAL( 0.0 ) },
+    { "A.Netclass != 'HV' || (B.Netclass == 'other*' && A.Width < B.Width)", false, VAL( 1.0 ) },
+    { "(A.Netclass == 'X' || B.Netclass == 'Y') && A.Width > 0mm", false, VAL( 0.0 ) },
+    { "(A.Width > 1000mm && A.Width > 0mm) || B.Netclass == 'otherClass'", false, VAL( 1.0 ) },
+    // Constant sub-expressions
+    { "!(A.Netclass == 'HV') || 1mm + 2mm == 3mm", false, VAL( 1.0 ) },
+    { "A.Width == 10mil + 5mil - 5mil && !(1mm > 2mm)", false, VAL( 1.0 ) }
 };
 
 
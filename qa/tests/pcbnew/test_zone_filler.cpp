@@ -24,13 +24,18 @@
 #include <qa_utils/wx_utils/unit_test_utils.h>
 #include <pcbnew_utils/board_test_utils.h>
 #include <board.h>
+#include <board_commit.h>
 #include <board_design_settings.h>
 #include <pad.h>
 #include <pcb_track.h>
 #include <footprint.h>
 #include <zone.h>
+#include <zone_filler.h>
+#include <core/kicad_algo.h>
 #include <drc/drc_item.h>
 #include <settings/settings_manager.h>
+#include <tool/tool_manager.h>
+#include <widgets/progress_reporter_base.h>
 
 
 struct ZONE_FILL_TEST_FIXTURE
@@ -299,3 +304,269 @@ BOOST_FIXTURE_TEST_CASE( RegressionTeardropFill, ZONE_FILL_TEST_FIXTURE )
     }
 }
 
+
+static std::map<std::pair<KIID, PCB_LAYER_ID>, HASH_128> fillHashes( BOARD* aBoard )
+{
+    std::map<std::pair<KIID, PCB_LAYER_ID>, HASH_128> hashes;
+
+    for( ZONE* zone : aBoard->Zones() )
+    {
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+            hashes[ { zone->m_Uuid, layer } ] = zone->GetFilledPolysList( layer )->GetHash();
+    }
+
+    return hashes;
+}
+
+
+/**
+ * Refilling with unchanged inputs must leave every fill as it was, and a refill after an edit
+ * must match filling the edited board from scratch.
+ */
+BOOST_FIXTURE_TEST_CASE( IncrementalZoneFill, ZONE_FILL_TEST_FIXTURE )
+{
+    // A skipped refill leaves the existing fills in place rather than replacing them
+    auto fillPolys =
+            [&]()
+            {
+                std::map<std::pair<KIID, PCB_LAYER_ID>, const SHAPE_POLY_SET*> polys;
+
+                for( ZONE* zone : m_board->Zones() )
+                {
+                    for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+                        polys[ { zone->m_Uuid, layer } ] = zone->GetFilledPolysList( layer ).get();
+                }
+
+                return polys;
+            };
+
+    auto editBoard =
+            [&]()
+            {
+                m_board->Tracks().front()->Move( VECTOR2I( delta * 20, delta * 20 ) );
+            };
+
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+    KI_TEST::FillZones( m_board.get() );
+
+    auto firstFill = fillHashes( m_board.get() );
+    auto firstPolys = fillPolys();
+
+    KI_TEST::FillZones( m_board.get() );
+    BOOST_CHECK( fillHashes( m_board.get() ) == firstFill );
+    BOOST_CHECK( fillPolys() == firstPolys );
+
+    editBoard();
+    KI_TEST::FillZones( m_board.get() );
+    BOOST_CHECK( fillPolys() != firstPolys );
+
+    auto incrementalFill = fillHashes( m_board.get() );
+
+    // A freshly loaded board carries no fill fingerprints, so everything gets refilled
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+    editBoard();
+    KI_TEST::FillZones( m_board.get() );
+
+    BOOST_CHECK( fillHashes( m_board.get() ) == incrementalFill );
+
+    // Switching a custom pad between its outline and its convex hull in zones changes the
+    // knockout without changing the pad's shape
+    auto makeCustomPad =
+            [&]( PADSTACK::CUSTOM_SHAPE_ZONE_MODE aMode ) -> PAD*
+            {
+                for( FOOTPRINT* footprint : m_board->Footprints() )
+                {
+                    for( PAD* pad : footprint->Pads() )
+                    {
+                        for( ZONE* zone : m_board->Zones() )
+                        {
+                            if( zone->GetIsRuleArea() || zone->GetNetCode() == pad->GetNetCode()
+                                    || !( zone->GetLayerSet() & pad->GetLayerSet() ).any()
+                                    || !zone->Outline()->Contains( pad->GetPosition() ) )
+                            {
+                                continue;
+                            }
+
+                            // An L whose notch is wide enough for the zone to fill
+                            int                   arm = pcbIUScale.mmToIU( 3 );
+                            int                   width = pcbIUScale.mmToIU( 0.6 );
+                            std::vector<VECTOR2I> shape = { { 0, 0 }, { arm, 0 }, { arm, width },
+                                                            { width, width }, { width, arm },
+                                                            { 0, arm } };
+
+                            pad->SetShape( PAD_SHAPE::CUSTOM );
+                            pad->SetAnchorPadShape( PAD_SHAPE::CIRCLE );
+                            pad->SetSize( VECTOR2I( width, width ) );
+                            pad->DeletePrimitivesList();
+                            pad->AddPrimitivePoly( shape, 0, true );
+                            pad->SetCustomShapeInZoneOpt( aMode );
+                            return pad;
+                        }
+                    }
+                }
+
+                return nullptr;
+            };
+
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+
+    PAD* customPad = makeCustomPad( PADSTACK::CUSTOM_SHAPE_ZONE_MODE::OUTLINE );
+
+    BOOST_REQUIRE( customPad );
+
+    KI_TEST::FillZones( m_board.get() );
+
+    auto outlineFill = fillHashes( m_board.get() );
+
+    customPad->SetCustomShapeInZoneOpt( PADSTACK::CUSTOM_SHAPE_ZONE_MODE::CONVEXHULL );
+    KI_TEST::FillZones( m_board.get() );
+
+    auto hullFill = fillHashes( m_board.get() );
+
+    BOOST_CHECK( hullFill != outlineFill );
+
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+    BOOST_REQUIRE( makeCustomPad( PADSTACK::CUSTOM_SHAPE_ZONE_MODE::CONVEXHULL ) );
+    KI_TEST::FillZones( m_board.get() );
+
+    BOOST_CHECK( fillHashes( m_board.get() ) == hullFill );
+}
+
+
+/**
+ * Knockouts cached by one fill mustn't be reused after the item they were built from has
+ * been edited, even if the edit didn't go through a commit.
+ */
+BOOST_FIXTURE_TEST_CASE( ZoneKnockoutCacheUncommittedEdit, ZONE_FILL_TEST_FIXTURE )
+{
+    // A pad knocked out of a zone of another net
+    auto findPad =
+            [&]() -> PAD*
+            {
+                for( FOOTPRINT* footprint : m_board->Footprints() )
+                {
+                    for( PAD* pad : footprint->Pads() )
+                    {
+                        for( ZONE* zone : m_board->Zones() )
+                        {
+                            if( !zone->GetIsRuleArea() && zone->GetNetCode() != pad->GetNetCode()
+                                    && ( zone->GetLayerSet() & pad->GetLayerSet() ).any()
+                                    && zone->GetBoundingBox().Contains( pad->GetPosition() ) )
+                            {
+                                return pad;
+                            }
+                        }
+                    }
+                }
+
+                return nullptr;
+            };
+
+    VECTOR2I offset( delta * 20, delta * 20 );
+
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+    KI_TEST::FillZones( m_board.get() );
+
+    auto firstFill = fillHashes( m_board.get() );
+    PAD* pad = findPad();
+
+    BOOST_REQUIRE( pad );
+
+    KIID padId = pad->m_Uuid;
+
+    pad->SetPosition( pad->GetPosition() + offset );
+    KI_TEST::FillZones( m_board.get() );
+
+    auto editedFill = fillHashes( m_board.get() );
+
+    BOOST_CHECK( editedFill != firstFill );
+
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+    pad = static_cast<PAD*>( m_board->GetItem( padId ) );
+    pad->SetPosition( pad->GetPosition() + offset );
+    KI_TEST::FillZones( m_board.get() );
+
+    BOOST_CHECK( fillHashes( m_board.get() ) == editedFill );
+}
+
+
+/**
+ * Cancel a fill as soon as the first zone layer has been filled.
+ */
+class CANCELLING_PROGRESS_REPORTER : public PROGRESS_REPORTER_BASE
+{
+public:
+    CANCELLING_PROGRESS_REPORTER() :
+            PROGRESS_REPORTER_BASE( 1 )
+    { }
+
+    void Report( const wxString& aMessage ) override
+    {
+        PROGRESS_REPORTER_BASE::Report( aMessage );
+
+        if( aMessage.StartsWith( wxT( "Filled " ) ) )
+            m_cancelled = true;
+    }
+
+private:
+    bool updateUI() override { return true; }
+};
+
+
+/**
+ * A cancelled fill which keeps partial fills must keep the zones it finished and give the
+ * zones it abandoned their previous fill back.
+ */
+BOOST_FIXTURE_TEST_CASE( CancelledZoneFillKeepsPartialFills, ZONE_FILL_TEST_FIXTURE )
+{
+    KI_TEST::LoadBoard( m_settingsManager, "issue11814", m_board );
+    KI_TEST::FillZones( m_board.get() );
+
+    auto fullFill = fillHashes( m_board.get() );
+
+    TOOL_MANAGER toolMgr;
+    toolMgr.SetEnvironment( m_board.get(), nullptr, nullptr, nullptr, nullptr );
+
+    KI_TEST::DUMMY_TOOL* dummyTool = new KI_TEST::DUMMY_TOOL();
+    toolMgr.RegisterTool( dummyTool );
+
+    BOARD_COMMIT                 commit( dummyTool );
+    ZONE_FILLER                  filler( m_board.get(), &commit );
+    CANCELLING_PROGRESS_REPORTER reporter;
+    std::vector<ZONE*>           toFill;
+    size_t                       fillable = 0;
+
+    for( ZONE* zone : m_board->Zones() )
+    {
+        // Nothing has changed, so force a refill
+        zone->SetNeedRefill( true );
+        toFill.push_back( zone );
+
+        if( !zone->GetIsRuleArea() && zone->GetNumCorners() > 2 )
+            fillable++;
+    }
+
+    filler.SetProgressReporter( &reporter );
+    filler.SetKeepPartialFills( true );
+
+    BOOST_REQUIRE( filler.Fill( toFill, false, nullptr ) );
+    BOOST_CHECK( reporter.IsCancelled() );
+
+    const std::vector<ZONE*>& abandoned = filler.GetAbandonedZones();
+
+    BOOST_REQUIRE( !abandoned.empty() );
+    BOOST_CHECK_LT( abandoned.size(), fillable );
+
+    for( ZONE* zone : abandoned )
+        BOOST_CHECK( alg::contains( m_board->Zones(), zone ) );
+
+    // The inputs haven't changed, so both the finished zones and the restored ones must match
+    // the previous fill.  An abandoned zone which wasn't restored would have been left unfilled.
+    for( ZONE* zone : m_board->Zones() )
+    {
+        if( !zone->GetIsRuleArea() && zone->GetNumCorners() > 2 )
+            BOOST_CHECK_MESSAGE( zone->IsFilled(), "Zone " << zone->m_Uuid.AsString() );
+    }
+
+    BOOST_CHECK( fillHashes( m_board.get() ) == fullFill );
+}
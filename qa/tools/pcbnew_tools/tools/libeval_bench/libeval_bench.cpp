@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Microbenchmark for rule condition evaluation.
+ *
+ * Compiles conditions of increasing size in the style of custom DRC rules (a chain of netclass
+ * and property tests) and times evaluating them against pairs of tracks, the same way
+ * DRC_RULE_CONDITION::EvaluateFor() does.
+ *
+ * Usage: qa_pcbnew_tools libeval_bench [iterations]
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <drc/drc_rule.h>
+#include <netinfo.h>
+#include <netclass.h>
+#include <pcb_track.h>
+#include <pcbexpr_evaluator.h>
+#include <properties/property_mgr.h>
+
+#include <core/profile.h>
+
+#include <wx/wx.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+
+static const int NETCLASS_COUNT = 16;
+
+
+static wxString makeCondition( int aConditions )
+{
+    wxString expr;
+
+    for( int ii = 0; ii < aConditions; ++ii )
+    {
+        if( !expr.IsEmpty() )
+            expr << wxT( " || " );
+
+        switch( ii % 4 )
+        {
+        case 0:
+            expr << wxString::Format( wxT( "(A.NetClass == 'NC%d' && B.NetClass == 'NC%d')" ),
+                                      ii % NETCLASS_COUNT, ( ii + 1 ) % NETCLASS_COUNT );
+            break;
+
+        case 1:
+            expr << wxString::Format( wxT( "(A.NetName == '/bus%d/*' && A.Width > %dmil)" ),
+                                      ii, 5 + ii % 20 );
+            break;
+
+        case 2:
+            expr << wxString::Format( wxT( "(A.Type == 'Via' && A.Layer == 'In%d.Cu')" ),
+                                      1 + ii % 4 );
+            break;
+
+        case 3:
+            expr << wxString::Format( wxT( "(B.Width < 0.1mm + 0.2mm + %dmil)" ), ii % 10 );
+            break;
+        }
+    }
+
+    return expr;
+}
+
+
+int libeval_bench_main( int argc, char* argv[] )
+{
+    int iterations = argc > 1 ? atoi( argv[1] ) : 20000;
+
+    PROPERTY_MANAGER::Instance().Rebuild();
+
+    BOARD brd;
+
+    std::vector<std::shared_ptr<NETCLASS>>  netclasses;
+    std::vector<std::unique_ptr<PCB_TRACK>> tracks;
+
+    for( int ii = 0; ii < NETCLASS_COUNT; ++ii )
+    {
+        netclasses.emplace_back( std::make_shared<NETCLASS>( wxString::Format( "NC%d", ii ) ) );
+
+        NETINFO_ITEM* net = new NETINFO_ITEM( &brd, wxString::Format( "/bus%d/sig", ii ), ii + 1 );
+        net->SetNetClass( netclasses.back() );
+        brd.Add( net );
+
+        tracks.emplace_back( std::make_unique<PCB_TRACK>( &brd ) );
+        tracks.back()->SetNet( net );
+        tracks.back()->SetLayer( ii % 2 ? F_Cu : B_Cu );
+        tracks.back()->SetWidth( pcbIUScale.MilsToIU( 4 + ii ) );
+    }
+
+    for( int conditions : { 1, 10, 50, 200, 400 } )
+    {
+        PCBEXPR_COMPILER compiler( new PCBEXPR_UNIT_RESOLVER() );
+        PCBEXPR_UCODE    ucode;
+        PCBEXPR_CONTEXT  preflightContext( NULL_CONSTRAINT, F_Cu );
+
+        PROF_TIMER compileTimer;
+
+        if( !compiler.Compile( makeCondition( conditions ), &ucode, &preflightContext ) )
+        {
+            printf( "%d conditions: compile failed\n", conditions );
+            continue;
+        }
+
+        compileTimer.Stop();
+
+        int        hits = 0;
+        PROF_TIMER runTimer;
+
+        for( int ii = 0; ii < iterations; ++ii )
+        {
+            PCB_TRACK* a = tracks[ ii % tracks.size() ].get();
+            PCB_TRACK* b = tracks[ ( ii / tracks.size() ) % tracks.size() ].get();
+
+            PCBEXPR_CONTEXT ctx( NULL_CONSTRAINT, F_Cu );
+            ctx.SetItems( a, b );
+
+            if( ucode.Run( &ctx )->AsDouble() != 0.0 )
+                hits++;
+        }
+
+        runTimer.Stop();
+
+        printf( "%4d conditions: %8d ops, compile %8.3f ms, %10.1f ns/eval (%d hits)\n",
+                conditions,
+                (int) ucode.Dump().Freq( '\n' ),
+                compileTimer.msecs(),
+                runTimer.msecs() * 1e6 / iterations,
+                hits );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "libeval_bench",
+        "Time compiling and evaluating rule conditions of increasing size",
+        libeval_bench_main,
+} );
@@ -0,0 +1,188 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Times complete zone fills of a board with the Clipper1 and Clipper2 polygon backends, and
+ * checks that both produce the same amount of copper (to within FILLED_AREA_TOLERANCE).  Exits
+ * with AREA_MISMATCH when they don't.
+ *
+ * Usage: qa_pcbnew_tools zone_fill_bench <board.kicad_pcb> [iterations]
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <advanced_config.h>
+#include <board.h>
+#include <board_design_settings.h>
+#include <drc/drc_engine.h>
+#include <zone.h>
+#include <zone_filler.h>
+#include <core/profile.h>
+
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+enum ZONE_FILL_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    FILL_FAILED,
+    AREA_MISMATCH,
+};
+
+
+/// The backends round arcs and offsets slightly differently, so allow for a small relative
+/// difference in the total filled area.
+static constexpr double FILLED_AREA_TOLERANCE = 1e-4;
+
+
+struct BACKEND_RESULT
+{
+    std::vector<double> m_times;        // ms per complete fill
+    double              m_filledArea;   // total filled area of the last fill
+};
+
+
+static bool fillBoard( BOARD* aBoard, double& aFilledArea )
+{
+    std::vector<ZONE*> toFill;
+
+    // Knockouts cached by the previous fill would spare this one building them, and were
+    // built by the other backend
+    aBoard->ClearZoneKnockouts();
+
+    for( ZONE* zone : aBoard->Zones() )
+    {
+        zone->UnFill();
+        toFill.push_back( zone );
+    }
+
+    ZONE_FILLER filler( aBoard, nullptr );
+
+    if( !filler.Fill( toFill ) )
+        return false;
+
+    aFilledArea = 0.0;
+
+    for( ZONE* zone : aBoard->Zones() )
+        aFilledArea += zone->CalculateFilledArea();
+
+    return true;
+}
+
+
+int zone_fill_bench_main( int argc, char* argv[] )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s <board.kicad_pcb> [iterations]\n", argv[0] );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::string filename = argv[1];
+    int         iterations = argc > 2 ? std::max( 1, atoi( argv[2] ) ) : 5;
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return LOAD_FAILED;
+
+    wxFileName rulesFile( filename );
+    rulesFile.SetExt( wxT( "kicad_dru" ) );
+
+    auto drcEngine = std::make_shared<DRC_ENGINE>( board.get(), &board->GetDesignSettings() );
+    drcEngine->InitEngine( rulesFile.FileExists() ? rulesFile : wxFileName() );
+
+    board->GetDesignSettings().m_DRCEngine = drcEngine;
+    board->BuildListOfNets();
+    board->BuildConnectivity();
+
+    // The backend is normally fixed for the session; a benchmark is the one place where
+    // flipping it is wanted.
+    ADVANCED_CFG& cfg = const_cast<ADVANCED_CFG&>( ADVANCED_CFG::GetCfg() );
+    bool          useClipper2 = cfg.m_UseClipper2;
+
+    BACKEND_RESULT results[2];
+
+    // Alternate the backends so that neither gets an advantage from warm caches
+    for( int ii = 0; ii < iterations; ++ii )
+    {
+        for( int backend = 0; backend < 2; ++backend )
+        {
+            cfg.m_UseClipper2 = backend == 1;
+
+            PROF_TIMER timer;
+
+            if( !fillBoard( board.get(), results[backend].m_filledArea ) )
+            {
+                cfg.m_UseClipper2 = useClipper2;
+                return FILL_FAILED;
+            }
+
+            results[backend].m_times.push_back( timer.msecs() );
+        }
+    }
+
+    cfg.m_UseClipper2 = useClipper2;
+
+    printf( "%zu zones, %d iterations\n", board->Zones().size(), iterations );
+
+    for( int backend = 0; backend < 2; ++backend )
+    {
+        std::vector<double>& times = results[backend].m_times;
+        std::sort( times.begin(), times.end() );
+
+        printf( "%s: min %10.1f ms, median %10.1f ms, max %10.1f ms, area %.6g mm^2\n",
+                backend == 1 ? "Clipper2" : "Clipper1",
+                times.front(),
+                times[times.size() / 2],
+                times.back(),
+                results[backend].m_filledArea / pcbIUScale.IU_PER_MM / pcbIUScale.IU_PER_MM );
+    }
+
+    double area1 = results[0].m_filledArea;
+    double area2 = results[1].m_filledArea;
+
+    if( std::abs( area1 - area2 ) > FILLED_AREA_TOLERANCE * std::max( area1, area2 ) )
+    {
+        printf( "Filled areas differ by %.3g%%\n",
+                100.0 * std::abs( area1 - area2 ) / std::max( area1, area2 ) );
+        return AREA_MISMATCH;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "zone_fill_bench",
+        "Time zone fills with the Clipper1 and Clipper2 backends",
+        zone_fill_bench_main,
+} );
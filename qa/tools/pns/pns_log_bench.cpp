@@ -0,0 +1,358 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Headless router latency benchmark.
+ *
+ * Replays every router log of a corpus (a directory with a tests.lst file listing one case
+ * per line, each case holding its log in <case>/pns, like the regression test data) and
+ * reports the percentiles of the time the router took to process each event, grouped by the
+ * kind of routing: shove, walkaround, highlight, drag and meander.
+ *
+ * With a baseline file, fails when a percentile got slower than the baseline by more than the
+ * tolerance.  The baseline is a text file with one "category p50 p90 p99" line per category,
+ * in microseconds, as written by --update-baseline.  Lines starting with '#' are comments.  An
+ * unreadable baseline is an error.
+ *
+ * Usage: pns_log_bench [-r repeats] [-b baseline] [-u] [-t tolerance_percent] [corpus_dir]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <wx/cmdline.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/init.h>
+#include <wx/textfile.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <reporter.h>
+
+#include "pns_log_file.h"
+#include "pns_log_player.h"
+
+
+/// Latencies below this many microseconds are too noisy to be reported as regressions.
+static const double c_minRegressionUs = 20.0;
+
+
+struct LATENCY_STATS
+{
+    size_t m_count = 0;
+    double m_p50 = 0.0;
+    double m_p90 = 0.0;
+    double m_p99 = 0.0;
+    double m_max = 0.0;
+};
+
+
+static double percentile( const std::vector<double>& aSorted, double aFraction )
+{
+    if( aSorted.empty() )
+        return 0.0;
+
+    size_t idx = (size_t) std::ceil( aFraction * aSorted.size() );
+
+    return aSorted[ std::min( aSorted.size(), std::max<size_t>( idx, 1 ) ) - 1 ];
+}
+
+
+static LATENCY_STATS computeStats( std::vector<double>& aSamples )
+{
+    LATENCY_STATS stats;
+
+    std::sort( aSamples.begin(), aSamples.end() );
+
+    stats.m_count = aSamples.size();
+    stats.m_p50 = percentile( aSamples, 0.50 );
+    stats.m_p90 = percentile( aSamples, 0.90 );
+    stats.m_p99 = percentile( aSamples, 0.99 );
+    stats.m_max = aSamples.empty() ? 0.0 : aSamples.back();
+
+    return stats;
+}
+
+
+static std::vector<wxString> readCorpus( const wxString& aCorpusDir )
+{
+    std::vector<wxString> logs;
+    wxFileName            listName( aCorpusDir, wxT( "tests.lst" ) );
+    wxTextFile            fp( listName.GetFullPath() );
+
+    if( !fp.Open() )
+    {
+        fprintf( stderr, "Failed to load test list from '%s'.\n",
+                 listName.GetFullPath().c_str().AsChar() );
+        return logs;
+    }
+
+    for( size_t ii = 0; ii < fp.GetLineCount(); ++ii )
+    {
+        wxString line = fp.GetLine( ii );
+        line.Trim().Trim( false );
+
+        if( !line.IsEmpty() )
+            logs.push_back( aCorpusDir + wxT( "/" ) + line + wxT( "/pns" ) );
+    }
+
+    fp.Close();
+    return logs;
+}
+
+
+/**
+ * Read a baseline written by writeBaseline().  Empty lines and lines starting with '#' are
+ * ignored.
+ *
+ * @return false if the file can't be read, has a malformed line or holds no latencies.
+ */
+static bool readBaseline( const wxString& aFileName,
+                          std::map<std::string, LATENCY_STATS>& aBaseline )
+{
+    wxTextFile fp( aFileName );
+
+    if( !fp.Open() )
+    {
+        fprintf( stderr, "Failed to read baseline '%s'.\n", aFileName.c_str().AsChar() );
+        return false;
+    }
+
+    for( size_t ii = 0; ii < fp.GetLineCount(); ++ii )
+    {
+        wxString line = fp.GetLine( ii );
+        line.Trim().Trim( false );
+
+        if( line.IsEmpty() || line.StartsWith( wxT( "#" ) ) )
+            continue;
+
+        char          category[64];
+        LATENCY_STATS stats;
+
+        if( sscanf( line.c_str().AsChar(), "%63s %lf %lf %lf", category, &stats.m_p50,
+                    &stats.m_p90, &stats.m_p99 ) != 4 )
+        {
+            fprintf( stderr, "Malformed line %zu in baseline '%s'.\n", ii + 1,
+                     aFileName.c_str().AsChar() );
+            return false;
+        }
+
+        aBaseline[category] = stats;
+    }
+
+    fp.Close();
+
+    if( aBaseline.empty() )
+    {
+        fprintf( stderr, "No latencies in baseline '%s'.\n", aFileName.c_str().AsChar() );
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Write @a aStats to a baseline file.  The comment lines heading an existing file are kept.
+ */
+static bool writeBaseline( const wxString& aFileName,
+                           const std::map<std::string, LATENCY_STATS>& aStats )
+{
+    std::vector<wxString> header;
+    wxTextFile            old( aFileName );
+
+    if( wxFileExists( aFileName ) && old.Open() )
+    {
+        for( size_t ii = 0; ii < old.GetLineCount(); ++ii )
+        {
+            wxString line = old.GetLine( ii );
+
+            if( !line.IsEmpty() && !line.StartsWith( wxT( "#" ) ) )
+                break;
+
+            header.push_back( line );
+        }
+
+        old.Close();
+    }
+
+    FILE* fp = wxFopen( aFileName, wxT( "w" ) );
+
+    if( !fp )
+        return false;
+
+    for( const wxString& line : header )
+        fprintf( fp, "%s\n", line.c_str().AsChar() );
+
+    for( const auto& [category, stats] : aStats )
+        fprintf( fp, "%s %.1f %.1f %.1f\n", category.c_str(), stats.m_p50, stats.m_p90,
+                 stats.m_p99 );
+
+    fclose( fp );
+    return true;
+}
+
+
+static bool isRegression( double aValue, double aBaseline, double aTolerance )
+{
+    return aValue > aBaseline * ( 1.0 + aTolerance ) && aValue - aBaseline > c_minRegressionUs;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters",
+      wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "r", "repeat", "number of times each log is replayed (default 3)",
+      wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "b", "baseline", "baseline file to compare the latencies against",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_SWITCH, "u", "update-baseline", "write the measured latencies to the baseline",
+      wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "t", "tolerance", "allowed slowdown in percent (default 20)",
+      wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_PARAM, "corpus", "corpus", "directory holding tests.lst and the logs",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+int main( int argc, char* argv[] )
+{
+    wxInitializer initializer( argc, argv );
+
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+
+    if( cl_parser.Parse() != 0 )
+        return 2;
+
+    long     repeat = 3;
+    long     tolerance = 20;
+    wxString baselineFile;
+    wxString corpus = KI_TEST::GetPcbnewTestDataDir() + std::string( "/pns_regressions" );
+
+    cl_parser.Found( "repeat", &repeat );
+    cl_parser.Found( "tolerance", &tolerance );
+    cl_parser.Found( "baseline", &baselineFile );
+
+    if( cl_parser.GetParamCount() > 0 )
+        corpus = cl_parser.GetParam( 0 );
+
+    std::vector<wxString> logs = readCorpus( corpus );
+
+    if( logs.empty() )
+        return 2;
+
+    std::map<std::string, std::vector<double>> samples;
+
+    for( const wxString& logName : logs )
+    {
+        PNS_LOG_FILE logFile;
+
+        if( !logFile.Load( wxFileName( logName ), &NULL_REPORTER::GetInstance() ) )
+        {
+            fprintf( stderr, "Failed to load log '%s'.\n", logName.c_str().AsChar() );
+            return 2;
+        }
+
+        for( long ii = 0; ii < repeat; ++ii )
+        {
+            PNS_LOG_PLAYER player;
+
+            player.SetDebugEnabled( false );
+            player.ReplayLog( &logFile, 0 );
+
+            // The first replay warms up the caches of the board and is not measured.
+            if( ii == 0 && repeat > 1 )
+                continue;
+
+            for( const PNS_LOG_PLAYER::EVENT_TIMING& timing : player.GetEventTimings() )
+                samples[timing.m_category].push_back( timing.m_usecs );
+        }
+    }
+
+    std::map<std::string, LATENCY_STATS> results;
+
+    printf( "%-12s %8s %10s %10s %10s %10s  (us)\n", "category", "events", "p50", "p90", "p99",
+            "max" );
+
+    for( auto& [category, values] : samples )
+    {
+        LATENCY_STATS stats = computeStats( values );
+        results[category] = stats;
+
+        printf( "%-12s %8zu %10.1f %10.1f %10.1f %10.1f\n", category.c_str(), stats.m_count,
+                stats.m_p50, stats.m_p90, stats.m_p99, stats.m_max );
+    }
+
+    if( baselineFile.IsEmpty() )
+        return 0;
+
+    if( cl_parser.Found( "update-baseline" ) )
+    {
+        if( !writeBaseline( baselineFile, results ) )
+        {
+            fprintf( stderr, "Failed to write baseline '%s'.\n", baselineFile.c_str().AsChar() );
+            return 2;
+        }
+
+        return 0;
+    }
+
+    std::map<std::string, LATENCY_STATS> baseline;
+    int                                  regressions = 0;
+
+    if( !readBaseline( baselineFile, baseline ) )
+        return 2;
+
+    for( const auto& [category, stats] : results )
+    {
+        auto it = baseline.find( category );
+
+        if( it == baseline.end() )
+            continue;
+
+        const LATENCY_STATS& ref = it->second;
+
+        auto check =
+                [&]( const char* aName, double aValue, double aBaseline )
+                {
+                    if( isRegression( aValue, aBaseline, tolerance / 100.0 ) )
+                    {
+                        printf( "REGRESSION: %s %s %.1f us (baseline %.1f us)\n",
+                                category.c_str(), aName, aValue, aBaseline );
+                        regressions++;
+                    }
+                };
+
+        check( "p50", stats.m_p50, ref.m_p50 );
+        check( "p90", stats.m_p90, ref.m_p90 );
+        check( "p99", stats.m_p99, ref.m_p99 );
+    }
+
+    return regressions ? 1 : 0;
+}
@@ -26,12 +26,16 @@
 #include "pns_log_player.h"
 
 #include <pcbnew_utils/board_test_utils.h>
+#include <core/profile.h>
 
 #define PNSLOGINFO PNS::DEBUG_DECORATOR::SRC_LOCATION_INFO( __FILE__, __FUNCTION__, __LINE__ )
 
 using namespace PNS;
 
-PNS_LOG_PLAYER::PNS_LOG_PLAYER()
+PNS_LOG_PLAYER::PNS_LOG_PLAYER() :
+        m_debugDecorator( nullptr ),
+        m_timeLimitUs( 0 ),
+        m_debugEnabled( true )
 {
     SetReporter( &NULL_REPORTER::GetInstance() );
 }
@@ -58,10 +62,39 @@ void PNS_LOG_PLAYER::createRouter()
 
     m_debugDecorator = new PNS_TEST_DEBUG_DECORATOR( m_reporter );
     m_debugDecorator->Clear();
+    m_debugDecorator->SetDebugEnabled( m_debugEnabled );
     m_iface->SetDebugDecorator( m_debugDecorator );
 }
 
 
+std::string PNS_LOG_PLAYER::routingCategory() const
+{
+    switch( m_router->Mode() )
+    {
+    case PNS_MODE_TUNE_SINGLE:
+    case PNS_MODE_TUNE_DIFF_PAIR:
+    case PNS_MODE_TUNE_DIFF_PAIR_SKEW:
+        return "meander";
+
+    default:
+        break;
+    }
+
+    if( m_router->GetState() == ROUTER::DRAG_SEGMENT
+            || m_router->GetState() == ROUTER::DRAG_COMPONENT )
+    {
+        return "drag";
+    }
+
+    switch( m_router->Settings().Mode() )
+    {
+    case RM_Shove:      return "shove";
+    case RM_Walkaround: return "walkaround";
+    default:            return "highlight";
+    }
+}
+
+
 const PNS_LOG_FILE::COMMIT_STATE PNS_LOG_PLAYER::GetRouterUpdatedItems()
 {
     PNS_LOG_FILE::COMMIT_STATE state;
@@ -102,6 +135,8 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
     int eventIdx = 0;
     int totalEvents = aLog->Events().size();
 
+    m_eventTimings.clear();
+
     for( auto evt : aLog->Events() )
     {
         if( eventIdx < aFrom || ( aTo >= 0 && eventIdx > aTo ) )
@@ -113,6 +148,13 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
 
         eventIdx++;
 
+        // Fixing can end the routing, so the kind of routing is taken before the event; a
+        // drag is only known to be one after it has started.
+        std::string category = routingCategory();
+        PROF_TIMER  timer;
+        bool        timed = true;
+        timer.Stop();
+
         switch( evt.type )
         {
         case LOGGER::EVT_START_ROUTE:
@@ -131,7 +173,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             m_router->StartRouting( evt.p, ritem, routingLayer );
+            timer.Stop();
             break;
         }
 
@@ -151,7 +195,10 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             bool rv = m_router->StartDragging( evt.p, ritem, 0 );
+            timer.Stop();
+            category = routingCategory();
             break;
         }
 
@@ -160,7 +207,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->NewStage( "fix", 0, PNSLOGINFO );
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
             m_debugDecorator->Message( wxString::Format( "fix (%d, %d)", evt.p.x, evt.p.y ) );
+            timer.Start();
             bool rv = m_router->FixRoute( evt.p, ritem, false, false );
+            timer.Stop();
             printf( "  fix -> (%d, %d) ret %d\n", evt.p.x, evt.p.y, rv ? 1 : 0 );
             break;
         }
@@ -171,7 +220,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
             m_debugDecorator->Message( wxString::Format( "unfix (%d, %d)", evt.p.x, evt.p.y ) );
             printf( "  unfix\n" );
+            timer.Start();
             m_router->UndoLastSegment();
+            timer.Stop();
             break;
         }
 
@@ -185,7 +236,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             bool ret = m_router->Move( evt.p, ritem );
+            timer.Stop();
             m_debugDecorator->SetCurrentStageStatus( ret );
             break;
         }
@@ -200,13 +253,21 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_reporter->Report( msg );
 
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
+            timer.Start();
             m_router->ToggleViaPlacement();
+            timer.Stop();
             break;
         }
 
-        default: break;
+        default:
+            // Aborts and unknown events don't call into the router
+            timed = false;
+            break;
         }
 
+        if( timed )
+            m_eventTimings.push_back( { evt.type, category, timer.msecs() * 1000.0 } );
+
         PNS::NODE* node = nullptr;
 
 #if 0
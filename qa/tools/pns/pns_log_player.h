@@ -24,11 +24,14 @@
 #define __PNS_LOG_PLAYER_H
 
 #include <map>
+#include <string>
+#include <vector>
 #include <pcbnew/board.h>
 
 #include <router/pns_routing_settings.h>
 #include <router/pns_kicad_iface.h>
 #include <router/pns_router.h>
+#include <router/pns_logger.h>
 
 
 class PNS_TEST_DEBUG_DECORATOR;
@@ -93,6 +96,17 @@ private:
 class PNS_LOG_PLAYER
 {
 public:
+    /**
+     * Time taken by the router to process one event of the log, excluding the bookkeeping of
+     * the player itself.
+     */
+    struct EVENT_TIMING
+    {
+        PNS::LOGGER::EVENT_TYPE m_type;
+        std::string             m_category;   ///< shove, walkaround, highlight, drag or meander
+        double                  m_usecs;
+    };
+
     PNS_LOG_PLAYER();
     ~PNS_LOG_PLAYER();
 
@@ -106,12 +120,23 @@ public:
 
     void SetTimeLimit( uint64_t microseconds ) { m_timeLimitUs = microseconds; }
 
+    /**
+     * Enable or disable the collection of the router's debug output while replaying.  Disabled
+     * for benchmarking, as collecting it takes longer than the routing itself.
+     */
+    void SetDebugEnabled( bool aEnabled ) { m_debugEnabled = aEnabled; }
+
+    const std::vector<EVENT_TIMING>& GetEventTimings() const { return m_eventTimings; }
+
     bool CompareResults( PNS_LOG_FILE* aLog );
     const PNS_LOG_FILE::COMMIT_STATE GetRouterUpdatedItems();
 
 private:
     void createRouter();
 
+    ///< Return the kind of routing the router is doing, as reported in the event timings.
+    std::string routingCategory() const;
+
     std::shared_ptr<PNS_LOG_VIEW_TRACKER>       m_viewTracker;
     std::unique_ptr<PNS_LOG_PLAYER_KICAD_IFACE> m_iface; // needs to be deleted after m_router
     PNS_TEST_DEBUG_DECORATOR*                   m_debugDecorator;
@@ -120,6 +145,8 @@ private:
     std::unique_ptr<PNS::ROUTING_SETTINGS>      m_routingSettings;
     uint64_t m_timeLimitUs;
     REPORTER* m_reporter;
+    bool                                        m_debugEnabled;
+    std::vector<EVENT_TIMING>                   m_eventTimings;
 };
 
 #endif
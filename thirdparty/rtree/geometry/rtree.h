@@ -17,6 +17,7 @@
 //    * 2020 KiCad Developers - Add std::iterator support for searching
 //    * 2020 KiCad Developers - Add container nearest neighbor based on Hjaltason & Samet
 //    * 2022 KiCad Developers - Slight optimizations in RectSphericalVolume
+//    * 2024 KiCad Developers - Add Sort-Tile-Recursive bulk loading
 //
 
 /*
@@ -149,6 +150,13 @@ public:
                  const ELEMTYPE     a_max[NUMDIMS],
                  const DATATYPE&    a_dataId );
 
+    /// Replace the contents of the tree with a packed tree built from a known set of entries
+    /// using Sort-Tile-Recursive bulk loading.  This is much faster than inserting the entries
+    /// one at a time, and gives full nodes with little overlap between siblings.  The result is
+    /// an ordinary tree; entries can still be inserted into or removed from it afterwards.
+    /// \param a_entries Bounding rects and data Ids of the entries.  Reordered on return.
+    void BulkLoad( std::vector<std::pair<Rect, DATATYPE>>& a_entries );
+
     /// Remove entry
     /// \param a_min Min of bounding rect
     /// \param a_max Max of bounding rect
@@ -535,6 +543,8 @@ protected:
                                    Node**           a_newNode,
                                    int              a_level ) const;
     bool            InsertRect( const Rect* a_rect, const DATATYPE& a_id, Node** a_root, int a_level ) const;
+    void            SortTiles( typename std::vector<Branch>::iterator a_first,
+                               typename std::vector<Branch>::iterator a_last, int a_axis ) const;
     Rect            NodeCover( Node* a_node ) const;
     bool            AddBranch( const Branch* a_branch, Node* a_node, Node** a_newNode ) const;
     void            DisconnectBranch( Node* a_node, int a_index ) const;
@@ -756,6 +766,114 @@ void RTREE_QUAL::Insert( const ELEMTYPE     a_min[NUMDIMS],
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( std::vector<std::pair<Rect, DATATYPE>>& a_entries )
+{
+    Reset();
+
+    std::vector<Branch> level( a_entries.size() );
+
+    for( size_t ii = 0; ii < a_entries.size(); ++ii )
+    {
+        level[ii].m_rect = a_entries[ii].first;
+        level[ii].m_data = a_entries[ii].second;
+    }
+
+    int nodeLevel = 0;
+
+    // Pack each level into full nodes, bottom up, until only the root remains
+    while( level.size() > MAXNODES || nodeLevel == 0 )
+    {
+        SortTiles( level.begin(), level.end(), 0 );
+
+        const size_t count = level.size();
+        size_t       nodeCount = std::max<size_t>( 1, ( count + MAXNODES - 1 ) / MAXNODES );
+        size_t       remainder = count % MAXNODES;
+
+        std::vector<Branch> parents;
+        parents.reserve( nodeCount );
+
+        size_t first = 0;
+
+        for( size_t node = 0; node < nodeCount; ++node )
+        {
+            size_t size = std::min<size_t>( MAXNODES, count - first );
+
+            // Share the tail between the last two nodes so that neither is under-full
+            if( nodeCount > 1 && remainder && remainder < MINNODES && node >= nodeCount - 2 )
+                size = ( node == nodeCount - 2 ) ? ( MAXNODES + remainder ) / 2 : count - first;
+
+            Node* newNode = AllocNode();
+            newNode->m_level = nodeLevel;
+
+            for( size_t ii = first; ii < first + size; ++ii )
+                newNode->m_branch[newNode->m_count++] = level[ii];
+
+            Branch branch;
+            branch.m_rect = NodeCover( newNode );
+            branch.m_child = newNode;
+            parents.push_back( branch );
+
+            first += size;
+        }
+
+        level.swap( parents );
+        ++nodeLevel;
+    }
+
+    if( level.size() == 1 )
+    {
+        m_root = level[0].m_child;
+    }
+    else
+    {
+        m_root = AllocNode();
+        m_root->m_level = nodeLevel;
+
+        for( const Branch& branch : level )
+            m_root->m_branch[m_root->m_count++] = branch;
+    }
+}
+
+
+// Sort branches into tiles: slice along the first axis into slabs which will each fill a whole
+// number of nodes, then recursively tile each slab along the remaining axes.
+RTREE_TEMPLATE
+void RTREE_QUAL::SortTiles( typename std::vector<Branch>::iterator a_first,
+                            typename std::vector<Branch>::iterator a_last, int a_axis ) const
+{
+    auto centerLess =
+            [a_axis]( const Branch& a, const Branch& b )
+            {
+                return (ELEMTYPEREAL) a.m_rect.m_min[a_axis] + a.m_rect.m_max[a_axis]
+                        < (ELEMTYPEREAL) b.m_rect.m_min[a_axis] + b.m_rect.m_max[a_axis];
+            };
+
+    std::sort( a_first, a_last, centerLess );
+
+    if( a_axis == NUMDIMS - 1 )
+        return;
+
+    const size_t count = std::distance( a_first, a_last );
+    const size_t nodeCount = ( count + MAXNODES - 1 ) / MAXNODES;
+    const size_t slabCount = (size_t) std::ceil( std::pow( (double) nodeCount,
+                                                            1.0 / ( NUMDIMS - a_axis ) ) );
+
+    if( slabCount <= 1 )
+    {
+        SortTiles( a_first, a_last, a_axis + 1 );
+        return;
+    }
+
+    const size_t slabSize = MAXNODES * ( ( nodeCount + slabCount - 1 ) / slabCount );
+
+    for( size_t start = 0; start < count; start += slabSize )
+    {
+        SortTiles( a_first + start, a_first + std::min( count, start + slabSize ), a_axis + 1 );
+    }
+}
+
+
 RTREE_TEMPLATE
 bool RTREE_QUAL::Remove( const ELEMTYPE     a_min[NUMDIMS],
                          const ELEMTYPE     a_max[NUMDIMS],